@@ -0,0 +1,90 @@
+// Ghost scatter latency (C++)
+// ===========================
+//
+// This demo illustrates how to:
+//
+// * Create a :cpp:class:`IndexMap` with ghost entries
+// * Update ghost values with blocking forward and reverse scatters
+// * Time frequent small scatters
+//
+// Time-stepping codes update the ghost values of many small vectors
+// per step, so the fixed cost of a scatter matters as much as the
+// cost per ghost. The demo measures the average time of a forward and
+// a reverse scatter for an increasing number of ghosts per process.
+//
+// Each process owns a contiguous range of indices, and ghosts the
+// first indices of the next process, i.e. the processes form a chain.
+// On a single process there are no ghosts and only the fixed cost of
+// a scatter is measured.
+//
+// .. code-block:: cpp
+
+#include <array>
+#include <dolfinx.h>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+using namespace dolfinx;
+
+int main(int argc, char* argv[])
+{
+  common::SubSystemsManager::init_logging(argc, argv);
+  common::SubSystemsManager::init_mpi(argc, argv);
+
+  {
+    MPI_Comm comm = MPI_COMM_WORLD;
+    const int rank = dolfinx::MPI::rank(comm);
+    const int size = dolfinx::MPI::size(comm);
+    const std::int32_t local_size = 100000;
+    const int num_repeats = 1000;
+
+    for (std::int32_t num_ghosts : {0, 10, 100, 1000, 10000})
+    {
+      // Ghost the first indices of the next process, which is the only
+      // process that ghosts indices owned by the previous one
+      std::vector<std::int64_t> ghosts;
+      std::vector<int> src_ranks, dest_ranks;
+      if (rank < size - 1)
+      {
+        ghosts.resize(num_ghosts);
+        std::iota(ghosts.begin(), ghosts.end(),
+                  (std::int64_t)(rank + 1) * local_size);
+        src_ranks.assign(num_ghosts, rank + 1);
+      }
+      if (rank > 0 and num_ghosts > 0)
+        dest_ranks.push_back(rank - 1);
+      const common::IndexMap map(comm, local_size, dest_ranks, ghosts,
+                                 src_ranks, 1);
+
+      std::vector<double> owned(local_size, rank), ghost_values(num_ghosts);
+      if (rank == size - 1)
+        ghost_values.clear();
+
+      // Time forward scatters (owner to ghost)
+      common::Timer t_fwd;
+      for (int i = 0; i < num_repeats; ++i)
+        map.scatter_fwd(owned, ghost_values, 1);
+      const double time_fwd = t_fwd.stop() / num_repeats;
+
+      // Time reverse scatters (ghost to owner)
+      common::Timer t_rev;
+      for (int i = 0; i < num_repeats; ++i)
+        map.scatter_rev(owned, ghost_values, 1, common::IndexMap::Mode::add);
+      const double time_rev = t_rev.stop() / num_repeats;
+
+      // Report the slowest process
+      std::array<double, 2> times = {time_fwd, time_rev};
+      MPI_Allreduce(MPI_IN_PLACE, times.data(), 2, MPI_DOUBLE, MPI_MAX, comm);
+      if (rank == 0)
+      {
+        std::cout << "Ghosts per process: " << num_ghosts
+                  << ", forward scatter: " << 1.0e6 * times[0]
+                  << " us, reverse scatter: " << 1.0e6 * times[1] << " us"
+                  << std::endl;
+      }
+    }
+  }
+
+  return 0;
+}
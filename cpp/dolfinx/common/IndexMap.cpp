@@ -380,6 +380,12 @@ IndexMap::IndexMap(MPI_Comm comm, std::int32_t local_size, int block_size)
   _comm_owner_to_ghost = dolfinx::MPI::Comm(comm0, false);
   _comm_ghost_to_owner = dolfinx::MPI::Comm(comm1, false);
   _comm_symmetric = dolfinx::MPI::Comm(comm2, false);
+
+  // No neighbors. Reserve space to avoid passing null pointers to MPI.
+  _shared_disp.assign(1, 0);
+  _shared_sizes.reserve(1);
+  _ghost_sizes.reserve(1);
+  _ghost_disp.assign(1, 0);
 }
 //-----------------------------------------------------------------------------
 IndexMap::IndexMap(MPI_Comm comm, std::int32_t local_size,
@@ -464,6 +470,27 @@ IndexMap::IndexMap(
       _comm_ghost_to_owner.comm(), _ghosts, _ghost_owners);
   _shared_disp = std::move(shared_disp);
 
+  // Compute the number of indices exchanged with each neighbor, and
+  // the position of each ghost in buffers ordered by owner. These are
+  // stored for use in scatters. Space is reserved to avoid passing
+  // null pointers to MPI for empty neighborhoods.
+  _shared_sizes.reserve(std::max<std::size_t>(1, _shared_disp.size() - 1));
+  for (std::size_t i = 0; i + 1 < _shared_disp.size(); ++i)
+    _shared_sizes.push_back(_shared_disp[i + 1] - _shared_disp[i]);
+  _ghost_sizes.assign(halo_src_ranks.size(), 0);
+  _ghost_sizes.reserve(1);
+  for (int i = 0; i < _ghost_owners.size(); ++i)
+    ++_ghost_sizes[_ghost_owners[i]];
+  _ghost_disp.assign(_ghost_sizes.size() + 1, 0);
+  std::partial_sum(_ghost_sizes.begin(), _ghost_sizes.end(),
+                   _ghost_disp.begin() + 1);
+  _ghost_buffer_pos.resize(_ghost_owners.size());
+  {
+    std::vector<std::int32_t> pos(_ghost_disp);
+    for (int i = 0; i < _ghost_owners.size(); ++i)
+      _ghost_buffer_pos[i] = pos[_ghost_owners[i]]++;
+  }
+
   // Wait for MPI_Iexscan to complete (get offset)
   MPI_Wait(&request_scan, MPI_STATUS_IGNORE);
   _local_range = {offset, offset + local_size};
@@ -806,66 +833,42 @@ void IndexMap::scatter_rev(std::vector<std::int32_t>& local_data,
   scatter_rev_impl(local_data, remote_data, n, op);
 }
 //-----------------------------------------------------------------------------
+void IndexMap::scatter_fwd(const std::vector<double>& local_data,
+                           std::vector<double>& remote_data, int n) const
+{
+  scatter_fwd_impl(local_data, remote_data, n);
+}
+//-----------------------------------------------------------------------------
+void IndexMap::scatter_fwd(
+    const std::vector<std::complex<double>>& local_data,
+    std::vector<std::complex<double>>& remote_data, int n) const
+{
+  scatter_fwd_impl(local_data, remote_data, n);
+}
+//-----------------------------------------------------------------------------
+void IndexMap::scatter_rev(std::vector<double>& local_data,
+                           const std::vector<double>& remote_data, int n,
+                           IndexMap::Mode op) const
+{
+  scatter_rev_impl(local_data, remote_data, n, op);
+}
+//-----------------------------------------------------------------------------
+void IndexMap::scatter_rev(
+    std::vector<std::complex<double>>& local_data,
+    const std::vector<std::complex<double>>& remote_data, int n,
+    IndexMap::Mode op) const
+{
+  scatter_rev_impl(local_data, remote_data, n, op);
+}
+//-----------------------------------------------------------------------------
 template <typename T>
 void IndexMap::scatter_fwd_impl(const std::vector<T>& local_data,
                                 std::vector<T>& remote_data, int n) const
 {
-
-  // Get number of neighbors
-  int indegree(-1), outdegree(-2), weighted(-1);
-  MPI_Dist_graph_neighbors_count(_comm_owner_to_ghost.comm(), &indegree,
-                                 &outdegree, &weighted);
-
-  // Get neighbor processes
-  std::vector<int> neighbors_in(indegree), neighbors_out(outdegree);
-  MPI_Dist_graph_neighbors(_comm_owner_to_ghost.comm(), indegree,
-                           neighbors_in.data(), MPI_UNWEIGHTED, outdegree,
-                           neighbors_out.data(), MPI_UNWEIGHTED);
-
-  const std::int32_t _size_local = size_local();
-  assert((int)local_data.size() == n * _size_local);
-  remote_data.resize(n * _ghosts.size());
-
-  // Create displacement vectors
-  std::vector<std::int32_t> sizes_recv(indegree, 0);
-  for (std::int32_t i = 0; i < _ghosts.size(); ++i)
-    sizes_recv[_ghost_owners[i]] += n;
-
-  std::vector displs_send = _shared_disp;
-  std::transform(displs_send.begin(), displs_send.end(), displs_send.begin(),
-                 std::bind(std::multiplies<T>(), std::placeholders::_1, n));
-  std::vector<std::int32_t> sizes_send(outdegree, 0);
-  std::adjacent_difference(displs_send.begin() + 1, displs_send.end(),
-                           sizes_send.begin());
-  std::vector<std::int32_t> displs_recv(indegree + 1, 0);
-  std::partial_sum(sizes_recv.begin(), sizes_recv.end(),
-                   displs_recv.begin() + 1);
-
-  // Copy into sending buffer
-  std::vector<T> data_to_send(displs_send.back());
-  for (std::size_t i = 0; i < _shared_indices.size(); ++i)
-  {
-    const int index = _shared_indices[i];
-    for (int j = 0; j < n; ++j)
-      data_to_send[i * n + j] = local_data[index * n + j];
-  }
-
-  // Send/receive data
-  std::vector<T> data_to_recv(displs_recv.back());
-  MPI_Neighbor_alltoallv(
-      data_to_send.data(), sizes_send.data(), displs_send.data(),
-      MPI::mpi_type<T>(), data_to_recv.data(), sizes_recv.data(),
-      displs_recv.data(), MPI::mpi_type<T>(), _comm_owner_to_ghost.comm());
-
-  // Copy into ghost area ("remote_data")
-  std::vector<std::int32_t> displs(displs_recv);
-  for (int i = 0; i < _ghosts.size(); ++i)
-  {
-    const int np = _ghost_owners[i];
-    for (int j = 0; j < n; ++j)
-      remote_data[i * n + j] = data_to_recv[displs[np] + j];
-    displs[np] += n;
-  }
+  std::vector<T> send_buffer, recv_buffer;
+  MPI_Request request;
+  scatter_fwd_begin(local_data, n, send_buffer, recv_buffer, request);
+  scatter_fwd_end(remote_data, n, recv_buffer, request);
 }
 //-----------------------------------------------------------------------------
 template <typename T>
@@ -873,74 +876,9 @@ void IndexMap::scatter_rev_impl(std::vector<T>& local_data,
                                 const std::vector<T>& remote_data, int n,
                                 IndexMap::Mode op) const
 {
-  assert((std::int32_t)remote_data.size() == n * num_ghosts());
-  local_data.resize(n * size_local(), 0);
-
-  // Get number of neighbors
-  int indegree(-1), outdegree(-2), weighted(-1);
-  MPI_Dist_graph_neighbors_count(_comm_ghost_to_owner.comm(), &indegree,
-                                 &outdegree, &weighted);
-
-  // Get neighbor processes
-  std::vector<int> neighbors_in(indegree), neighbors_out(outdegree);
-  MPI_Dist_graph_neighbors(_comm_ghost_to_owner.comm(), indegree,
-                           neighbors_in.data(), MPI_UNWEIGHTED, outdegree,
-                           neighbors_out.data(), MPI_UNWEIGHTED);
-
-  // Compute number of items to send to each process
-  std::vector<std::int32_t> send_sizes(outdegree, 0);
-  std::vector<std::int32_t> recv_sizes(indegree, 0);
-  for (int i = 0; i < _ghosts.size(); ++i)
-    send_sizes[_ghost_owners[i]] += n;
-
-  // Create displacement vectors
-  std::vector<std::int32_t> displs_send(outdegree + 1, 0);
-  std::vector<std::int32_t> displs_recv(indegree + 1, 0);
-  for (int i = 0; i < indegree; ++i)
-  {
-    recv_sizes[i] = (_shared_disp[i + 1] - _shared_disp[i]) * n;
-    displs_recv[i + 1] = displs_recv[i] + recv_sizes[i];
-  }
-
-  for (int i = 0; i < outdegree; ++i)
-    displs_send[i + 1] = displs_send[i] + send_sizes[i];
-
-  // Fill sending data
-  std::vector<T> send_data(displs_send.back());
-  std::vector<std::int32_t> displs(displs_send);
-  for (std::int32_t i = 0; i < _ghosts.size(); ++i)
-  {
-    const int np = _ghost_owners[i];
-    for (std::int32_t j = 0; j < n; ++j)
-      send_data[displs[np] + j] = remote_data[i * n + j];
-    displs[np] += n;
-  }
-
-  // Send and receive data
-  std::vector<T> recv_data(displs_recv.back());
-  MPI_Neighbor_alltoallv(
-      send_data.data(), send_sizes.data(), displs_send.data(),
-      MPI::mpi_type<T>(), recv_data.data(), recv_sizes.data(),
-      displs_recv.data(), MPI::mpi_type<T>(), _comm_ghost_to_owner.comm());
-
-  // Copy or accumulate into "local_data"
-  if (op == Mode::insert)
-  {
-    for (std::size_t i = 0; i < _shared_indices.size(); ++i)
-    {
-      const int index = _shared_indices[i];
-      for (int j = 0; j < n; ++j)
-        local_data[index * n + j] = recv_data[i * n + j];
-    }
-  }
-  else if (op == Mode::add)
-  {
-    for (std::size_t i = 0; i < _shared_indices.size(); ++i)
-    {
-      const int index = _shared_indices[i];
-      for (int j = 0; j < n; ++j)
-        local_data[index * n + j] += recv_data[i * n + j];
-    }
-  }
+  std::vector<T> send_buffer, recv_buffer;
+  MPI_Request request;
+  scatter_rev_begin(remote_data, n, send_buffer, recv_buffer, request);
+  scatter_rev_end(local_data, n, recv_buffer, op, request);
 }
 //-----------------------------------------------------------------------------
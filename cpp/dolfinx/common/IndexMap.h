@@ -7,7 +7,10 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <algorithm>
 #include <array>
+#include <cassert>
+#include <complex>
 #include <cstdint>
 #include <dolfinx/common/MPI.h>
 #include <map>
@@ -291,6 +294,96 @@ public:
                    const std::vector<std::int32_t>& remote_data, int n,
                    IndexMap::Mode op) const;
 
+  /// Send n values for each index that is owned to processes that have
+  /// the index as a ghost. See the std::int64_t version for a
+  /// description of the arguments.
+  void scatter_fwd(const std::vector<double>& local_data,
+                   std::vector<double>& remote_data, int n) const;
+
+  /// Send n values for each index that is owned to processes that have
+  /// the index as a ghost. See the std::int64_t version for a
+  /// description of the arguments.
+  void scatter_fwd(const std::vector<std::complex<double>>& local_data,
+                   std::vector<std::complex<double>>& remote_data,
+                   int n) const;
+
+  /// Send n values for each ghost index to owning to the process. See
+  /// the std::int64_t version for a description of the arguments.
+  void scatter_rev(std::vector<double>& local_data,
+                   const std::vector<double>& remote_data, int n,
+                   IndexMap::Mode op) const;
+
+  /// Send n values for each ghost index to owning to the process. See
+  /// the std::int64_t version for a description of the arguments.
+  void scatter_rev(std::vector<std::complex<double>>& local_data,
+                   const std::vector<std::complex<double>>& remote_data,
+                   int n, IndexMap::Mode op) const;
+
+  /// Start a non-blocking send of n values for each owned index to the
+  /// processes that have the index as a ghost. The data is packed into
+  /// @p send_buffer and received into @p recv_buffer. The buffers must
+  /// not be modified or destroyed before scatter_fwd_end has been
+  /// called. Buffers that are kept by the caller between scatters are
+  /// only resized when the data size changes.
+  ///
+  /// Work that does not depend on ghost values can be carried out
+  /// between scatter_fwd_begin and scatter_fwd_end.
+  ///
+  /// @param[in] local_data Data for each owned index. Size must be n *
+  ///   size_local().
+  /// @param[in] n Number of data items per index
+  /// @param[in,out] send_buffer Buffer for the data to send
+  /// @param[in,out] recv_buffer Buffer for the data to receive
+  /// @param[out] request The MPI request for the communication
+  template <typename T>
+  void scatter_fwd_begin(const std::vector<T>& local_data, int n,
+                         std::vector<T>& send_buffer,
+                         std::vector<T>& recv_buffer,
+                         MPI_Request& request) const;
+
+  /// Complete a non-blocking scatter started by scatter_fwd_begin, and
+  /// unpack the received data
+  /// @param[in,out] remote_data Data for each ghost index. Size will be
+  ///   n * num_ghosts().
+  /// @param[in] n Number of data items per index
+  /// @param[in] recv_buffer The receive buffer passed to
+  ///   scatter_fwd_begin
+  /// @param[in,out] request The MPI request returned by
+  ///   scatter_fwd_begin
+  template <typename T>
+  void scatter_fwd_end(std::vector<T>& remote_data, int n,
+                       const std::vector<T>& recv_buffer,
+                       MPI_Request& request) const;
+
+  /// Start a non-blocking send of n values for each ghost index to the
+  /// owning process. See scatter_fwd_begin for the use of the buffers.
+  /// @param[in] remote_data Data for each ghost index. Size must be n *
+  ///   num_ghosts().
+  /// @param[in] n Number of data items per index
+  /// @param[in,out] send_buffer Buffer for the data to send
+  /// @param[in,out] recv_buffer Buffer for the data to receive
+  /// @param[out] request The MPI request for the communication
+  template <typename T>
+  void scatter_rev_begin(const std::vector<T>& remote_data, int n,
+                         std::vector<T>& send_buffer,
+                         std::vector<T>& recv_buffer,
+                         MPI_Request& request) const;
+
+  /// Complete a non-blocking scatter started by scatter_rev_begin, and
+  /// insert or add the received data into the owned data
+  /// @param[in,out] local_data Data for each owned index. Size will be
+  ///   n * size_local().
+  /// @param[in] n Number of data items per index
+  /// @param[in] recv_buffer The receive buffer passed to
+  ///   scatter_rev_begin
+  /// @param[in] op Sum or set received values in local_data
+  /// @param[in,out] request The MPI request returned by
+  ///   scatter_rev_begin
+  template <typename T>
+  void scatter_rev_end(std::vector<T>& local_data, int n,
+                       const std::vector<T>& recv_buffer, Mode op,
+                       MPI_Request& request) const;
+
 private:
   int _block_size;
 
@@ -344,6 +437,32 @@ private:
   // rank i, where i is the ith outgoing edge on _comm_owner_to_ghost.
   std::vector<std::int32_t> _shared_disp;
 
+  // Number of indices in _shared_indices for each outgoing edge on
+  // _comm_owner_to_ghost
+  std::vector<std::int32_t> _shared_sizes;
+
+  // Number of ghosts owned by each incoming edge on
+  // _comm_owner_to_ghost, and displacement vector. Ghost data in
+  // communication buffers is ordered by owner.
+  std::vector<std::int32_t> _ghost_sizes, _ghost_disp;
+
+  // Position of each ghost index in buffers of ghost data ordered by
+  // owner
+  std::vector<std::int32_t> _ghost_buffer_pos;
+
+  // Create an MPI datatype for n contiguous items of type T. The caller
+  // must free the type if n > 1.
+  template <typename T>
+  static MPI_Datatype block_type(int n)
+  {
+    if (n == 1)
+      return MPI::mpi_type<T>();
+    MPI_Datatype type;
+    MPI_Type_contiguous(n, MPI::mpi_type<T>(), &type);
+    MPI_Type_commit(&type);
+    return type;
+  }
+
   template <typename T>
   void scatter_fwd_impl(const std::vector<T>& local_data,
                         std::vector<T>& remote_data, int n) const;
@@ -353,4 +472,105 @@ private:
                         Mode op) const;
 };
 
+//-----------------------------------------------------------------------------
+template <typename T>
+void IndexMap::scatter_fwd_begin(const std::vector<T>& local_data, int n,
+                                 std::vector<T>& send_buffer,
+                                 std::vector<T>& recv_buffer,
+                                 MPI_Request& request) const
+{
+  assert((std::int32_t)local_data.size() == n * size_local());
+
+  // Pack owned data that is ghosted by neighbors
+  send_buffer.resize(n * _shared_indices.size());
+  for (std::size_t i = 0; i < _shared_indices.size(); ++i)
+  {
+    std::copy_n(local_data.data() + n * _shared_indices[i], n,
+                send_buffer.data() + n * i);
+  }
+  recv_buffer.resize(n * _ghosts.size());
+
+  // Sizes and displacements are in units of n items, so the cached
+  // values can be used for any n. The datatype can be freed once the
+  // communication has started.
+  MPI_Datatype type = block_type<T>(n);
+  MPI_Ineighbor_alltoallv(send_buffer.data(), _shared_sizes.data(),
+                          _shared_disp.data(), type, recv_buffer.data(),
+                          _ghost_sizes.data(), _ghost_disp.data(), type,
+                          _comm_owner_to_ghost.comm(), &request);
+  if (n > 1)
+    MPI_Type_free(&type);
+}
+//-----------------------------------------------------------------------------
+template <typename T>
+void IndexMap::scatter_fwd_end(std::vector<T>& remote_data, int n,
+                               const std::vector<T>& recv_buffer,
+                               MPI_Request& request) const
+{
+  MPI_Wait(&request, MPI_STATUS_IGNORE);
+
+  // Copy from buffer (ordered by owner) into ghost data
+  remote_data.resize(n * _ghosts.size());
+  for (std::size_t i = 0; i < _ghost_buffer_pos.size(); ++i)
+  {
+    std::copy_n(recv_buffer.data() + n * _ghost_buffer_pos[i], n,
+                remote_data.data() + n * i);
+  }
+}
+//-----------------------------------------------------------------------------
+template <typename T>
+void IndexMap::scatter_rev_begin(const std::vector<T>& remote_data, int n,
+                                 std::vector<T>& send_buffer,
+                                 std::vector<T>& recv_buffer,
+                                 MPI_Request& request) const
+{
+  assert((std::int32_t)remote_data.size() == n * num_ghosts());
+
+  // Pack ghost data, ordered by owner
+  send_buffer.resize(n * _ghosts.size());
+  for (std::size_t i = 0; i < _ghost_buffer_pos.size(); ++i)
+  {
+    std::copy_n(remote_data.data() + n * i, n,
+                send_buffer.data() + n * _ghost_buffer_pos[i]);
+  }
+  recv_buffer.resize(n * _shared_indices.size());
+
+  MPI_Datatype type = block_type<T>(n);
+  MPI_Ineighbor_alltoallv(send_buffer.data(), _ghost_sizes.data(),
+                          _ghost_disp.data(), type, recv_buffer.data(),
+                          _shared_sizes.data(), _shared_disp.data(), type,
+                          _comm_ghost_to_owner.comm(), &request);
+  if (n > 1)
+    MPI_Type_free(&type);
+}
+//-----------------------------------------------------------------------------
+template <typename T>
+void IndexMap::scatter_rev_end(std::vector<T>& local_data, int n,
+                               const std::vector<T>& recv_buffer, Mode op,
+                               MPI_Request& request) const
+{
+  MPI_Wait(&request, MPI_STATUS_IGNORE);
+
+  // Insert or add received data into owned data
+  local_data.resize(n * size_local(), 0);
+  if (op == Mode::insert)
+  {
+    for (std::size_t i = 0; i < _shared_indices.size(); ++i)
+    {
+      std::copy_n(recv_buffer.data() + n * i, n,
+                  local_data.data() + n * _shared_indices[i]);
+    }
+  }
+  else if (op == Mode::add)
+  {
+    for (std::size_t i = 0; i < _shared_indices.size(); ++i)
+    {
+      const std::int32_t index = _shared_indices[i];
+      for (int j = 0; j < n; ++j)
+        local_data[index * n + j] += recv_buffer[i * n + j];
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+
 } // namespace dolfinx::common
@@ -64,3 +64,12 @@ bool dolfinx::has_kahip()
 #endif
 }
 //-------------------------------------------------------------------------
+bool dolfinx::has_zlib()
+{
+#ifdef HAS_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+//-------------------------------------------------------------------------
@@ -41,4 +41,7 @@ bool has_parmetis();
 /// Return true if DOLFINX is compiled with KaHIP
 bool has_kahip();
 
+/// Return true if DOLFINX is compiled with zlib
+bool has_zlib();
+
 } // namespace dolfinx
@@ -8,18 +8,162 @@
 
 #include <algorithm>
 #include <boost/functional/hash.hpp>
+#include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <dolfinx/common/MPI.h>
+#include <exception>
 #include <limits>
 #include <mpi.h>
+#include <mutex>
+#include <numeric>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
 namespace dolfinx::common
 {
 
+/// Split the range [0, n) into @p num_threads contiguous blocks and
+/// process the blocks concurrently. The last block is processed on the
+/// calling thread. If @p fn throws, all threads are joined and the
+/// first exception is rethrown on the calling thread.
+/// @param[in] n Size of the range
+/// @param[in] num_threads Number of threads
+/// @param[in] fn The function to execute. It is called as fn(thread,
+///   begin, end), where thread is the thread number in [0,
+///   num_threads) and [begin, end) is the block to process.
+template <typename Fn>
+void parallel_for(std::int32_t n, int num_threads, const Fn& fn)
+{
+  assert(num_threads > 0);
+
+  // Catch exceptions on each thread and keep the first
+  std::mutex mutex;
+  std::exception_ptr error;
+  auto work = [&](int t, std::int32_t begin, std::int32_t end) {
+    try
+    {
+      fn(t, begin, end);
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!error)
+        error = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  const std::int32_t block_size = n / num_threads;
+  const std::int32_t remainder = n % num_threads;
+  std::int32_t begin = 0;
+  for (int t = 0; t < num_threads; ++t)
+  {
+    const std::int32_t end = begin + block_size + (t < remainder ? 1 : 0);
+    if (t == num_threads - 1)
+      work(t, begin, end);
+    else
+    {
+      try
+      {
+        threads.emplace_back(work, t, begin, end);
+      }
+      catch (...)
+      {
+        // Could not start a thread, so process the block here
+        work(t, begin, end);
+      }
+    }
+    begin = end;
+  }
+  for (std::thread& t : threads)
+    t.join();
+  if (error)
+    std::rethrow_exception(error);
+}
+
+/// Compute the permutation that sorts the rows of a two-dimensional
+/// array lexicographically. A stable least-significant-digit radix
+/// sort is used, which needs no comparisons of rows and is computed in
+/// parallel.
+/// @param[in] x Array data (row-major), with num_rows * num_cols
+///   entries. Values must be non-negative.
+/// @param[in] num_rows Number of rows
+/// @param[in] num_cols Number of columns
+/// @param[in] num_threads Number of threads
+/// @return The permutation p such that rows p[0], p[1], ... are in
+///   ascending order
+template <typename T>
+std::vector<std::int32_t> sort_rows_by_perm(const T* x, std::int32_t num_rows,
+                                            int num_cols, int num_threads = 1)
+{
+  std::vector<std::int32_t> perm(num_rows), perm_tmp(num_rows);
+  std::iota(perm.begin(), perm.end(), 0);
+  if (num_rows == 0)
+    return perm;
+
+  // Number of bits required for the largest value
+  const std::int64_t size = std::int64_t(num_rows) * num_cols;
+  const T max_value = *std::max_element(x, x + size);
+  assert(*std::min_element(x, x + size) >= 0);
+  int num_bits = 0;
+  while (num_bits < (int)(8 * sizeof(T)) and (max_value >> num_bits) > 0)
+    ++num_bits;
+
+  // Number of bits per digit
+  const int radix_bits = std::min(num_bits, 16);
+  const std::int32_t num_buckets = 1 << radix_bits;
+  const T mask = num_buckets - 1;
+
+  // Sort by each column, starting with the last, and by each digit,
+  // starting with the least significant
+  std::vector<std::int32_t> offsets(num_threads * num_buckets);
+  for (int col = num_cols - 1; col >= 0; --col)
+  {
+    for (int shift = 0; shift < num_bits; shift += radix_bits)
+    {
+      auto digit = [&](std::int32_t row) -> std::int32_t {
+        return (x[std::int64_t(row) * num_cols + col] >> shift) & mask;
+      };
+
+      // Count digits in the block of each thread
+      std::fill(offsets.begin(), offsets.end(), 0);
+      parallel_for(num_rows, num_threads,
+                   [&](int t, std::int32_t begin, std::int32_t end) {
+                     std::int32_t* count = offsets.data() + t * num_buckets;
+                     for (std::int32_t i = begin; i < end; ++i)
+                       ++count[digit(perm[i])];
+                   });
+
+      // Compute the position of each (digit, thread) block
+      std::int32_t pos = 0;
+      for (std::int32_t d = 0; d < num_buckets; ++d)
+      {
+        for (int t = 0; t < num_threads; ++t)
+        {
+          const std::int32_t count = offsets[t * num_buckets + d];
+          offsets[t * num_buckets + d] = pos;
+          pos += count;
+        }
+      }
+
+      // Move rows to new positions
+      parallel_for(num_rows, num_threads,
+                   [&](int t, std::int32_t begin, std::int32_t end) {
+                     std::int32_t* offset = offsets.data() + t * num_buckets;
+                     for (std::int32_t i = begin; i < end; ++i)
+                       perm_tmp[offset[digit(perm[i])]++] = perm[i];
+                   });
+      std::swap(perm, perm_tmp);
+    }
+  }
+
+  return perm;
+}
+
 /// Sort two arrays based on the values in array @p indices. Any
 /// duplicate indices and the corresponding value are removed. In the
 /// case of duplicates, the entry with the smallest value is retained.
@@ -0,0 +1,441 @@
+// Copyright (C) 2020 agent
+//
+// This file is part of DOLFINX (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "Form.h"
+#include "utils.h"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <dolfinx/common/Timer.h>
+#include <dolfinx/function/FunctionSpace.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/la/MatrixCSR.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <dolfinx/mesh/cell_types.h>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace dolfinx::fem
+{
+
+/// An assembly plan holds data for a Form that does not change between
+/// assemblies when only the values of coefficients and constants
+/// change, e.g. in a time-stepping loop. Creating the plan computes the
+/// required mesh entities and connectivity, the cell and local facet
+/// index of each facet in the integration domains, the permutation data
+/// and the packed coefficients and constants. Repeated assembly with a
+/// plan then only evaluates kernels and accumulates values.
+///
+/// The packed coefficients and constants are not updated automatically.
+/// Call update_coefficients() after changing their values, or
+/// update_changed_coefficients() to repack only the coefficients whose
+/// values have changed since they were last packed.
+///
+/// A plan for a bilinear form can also hold the position of each
+/// element matrix entry in the value array of a la::MatrixCSR, which
+/// allows cell contributions to be added without searching for
+/// entries.
+///
+/// Threaded assembly with a plan requires colorings of the integration
+/// domains, which are computed once by create_colorings().
+
+template <typename T>
+class AssemblyPlan
+{
+public:
+  /// Create an assembly plan for a form
+  /// @param[in] a The form
+  explicit AssemblyPlan(std::shared_ptr<const Form<T>> a) : _form(a)
+  {
+    assert(_form);
+    common::Timer timer("Build assembly plan");
+
+    std::shared_ptr<const mesh::Mesh> mesh = _form->mesh();
+    assert(mesh);
+    const int tdim = mesh->topology().dim();
+    const std::int32_t num_cells
+        = mesh->topology().connectivity(tdim, 0)->num_nodes();
+
+    const FormIntegrals<T>& integrals = _form->integrals();
+    if (integrals.needs_permutation_data())
+    {
+      mesh->topology_mutable().create_entity_permutations();
+      _cell_info = mesh->topology().get_cell_permutation_info();
+    }
+    else
+      _cell_info.setZero(num_cells);
+
+    const int num_exterior
+        = integrals.num_integrals(IntegralType::exterior_facet);
+    const int num_interior
+        = integrals.num_integrals(IntegralType::interior_facet);
+    if (num_exterior > 0 or num_interior > 0)
+    {
+      mesh->topology_mutable().create_entities(tdim - 1);
+      mesh->topology_mutable().create_connectivity(tdim - 1, tdim);
+      mesh->topology_mutable().create_connectivity(tdim, tdim - 1);
+      if (integrals.needs_permutation_data())
+        _perms = mesh->topology().get_facet_permutations();
+      else
+      {
+        const int facets_per_cell
+            = mesh::cell_num_entities(mesh->topology().cell_type(), tdim - 1);
+        _perms.setZero(facets_per_cell, num_cells);
+      }
+    }
+
+    for (int i = 0; i < num_exterior; ++i)
+    {
+      _exterior_facets.push_back(compute_facet_data<2>(
+          mesh->topology(),
+          integrals.integral_domains(IntegralType::exterior_facet, i)));
+    }
+    for (int i = 0; i < num_interior; ++i)
+    {
+      _interior_facets.push_back(compute_facet_data<4>(
+          mesh->topology(),
+          integrals.integral_domains(IntegralType::interior_facet, i)));
+    }
+
+    update_coefficients();
+  }
+
+  /// Create an assembly plan for a bilinear form, including the
+  /// positions of cell matrix entries in the values of a CSR matrix.
+  /// The plan can be used to assemble into any la::MatrixCSR with the
+  /// same sparsity pattern as @p A.
+  /// @param[in] a The bilinear form
+  /// @param[in] A A matrix with the sparsity pattern of the form
+  AssemblyPlan(std::shared_ptr<const Form<T>> a, const la::MatrixCSR<T>& A)
+      : AssemblyPlan(a)
+  {
+    if (_form->rank() != 2)
+      throw std::runtime_error("CSR positions require a bilinear form.");
+    common::Timer timer("Compute CSR insertion positions");
+
+    const graph::AdjacencyList<std::int32_t>& dofs0
+        = _form->function_space(0)->dofmap()->list();
+    const graph::AdjacencyList<std::int32_t>& dofs1
+        = _form->function_space(1)->dofmap()->list();
+    const int num_dofs0 = dofs0.num_nodes() > 0 ? dofs0.num_links(0) : 0;
+    const int num_dofs1 = dofs1.num_nodes() > 0 ? dofs1.num_links(0) : 0;
+
+    // Compute positions for cells in cell integral domains. Other rows
+    // are unused.
+    _csr_positions.setConstant(dofs0.num_nodes(), num_dofs0 * num_dofs1, -1);
+    const FormIntegrals<T>& integrals = _form->integrals();
+    for (int i = 0; i < integrals.num_integrals(IntegralType::cell); ++i)
+    {
+      for (std::int32_t c : integrals.integral_domains(IntegralType::cell, i))
+      {
+        auto dmap0 = dofs0.links(c);
+        auto dmap1 = dofs1.links(c);
+        for (int k = 0; k < num_dofs0; ++k)
+        {
+          for (int l = 0; l < num_dofs1; ++l)
+          {
+            const std::int32_t pos = A.position(dmap0[k], dmap1[l]);
+            if (pos < 0)
+            {
+              throw std::runtime_error(
+                  "Matrix sparsity pattern does not contain cell entries.");
+            }
+            _csr_positions(c, k * num_dofs1 + l) = pos;
+          }
+        }
+      }
+    }
+    _csr_size = A.values().size();
+  }
+
+  /// Copy constructor
+  AssemblyPlan(const AssemblyPlan& plan) = default;
+
+  /// Move constructor
+  AssemblyPlan(AssemblyPlan&& plan) = default;
+
+  /// Destructor
+  ~AssemblyPlan() = default;
+
+  /// Repack the coefficient and constant values of the form. Must be
+  /// called after these values have changed and before the next
+  /// assembly with this plan.
+  /// @param[in] num_threads Number of threads used to pack the
+  ///   coefficients
+  void update_coefficients(int num_threads = 1)
+  {
+    const std::vector<bool> pack(_form->coefficients().size(), true);
+    repack(pack, num_threads);
+  }
+
+  /// Repack the constant values of the form and the coefficients whose
+  /// values have changed, as reported by function::Function::version(),
+  /// or that have been replaced since they were last packed. The
+  /// packed values are updated in place.
+  /// @param[in] num_threads Number of threads used to pack the
+  ///   coefficients
+  /// @return The number of coefficients that were repacked
+  int update_changed_coefficients(int num_threads = 1)
+  {
+    const FormCoefficients<T>& coefficients = _form->coefficients();
+    std::vector<bool> pack(coefficients.size(), true);
+    for (int i = 0; i < coefficients.size(); ++i)
+    {
+      std::shared_ptr<const function::Function<T>> u = coefficients.get(i);
+      pack[i] = (i >= (int)_coeff_versions.size()
+                 or _coeff_versions[i].first != u->id()
+                 or _coeff_versions[i].second != u->version());
+    }
+    repack(pack, num_threads);
+    return std::count(pack.begin(), pack.end(), true);
+  }
+
+  /// Group the entities of each integral domain into colors such that
+  /// entities in the same color share no dof of the test space, see
+  /// fem::color_cells. The colorings are used for assembly with more
+  /// than one thread and are computed only once.
+  void create_colorings()
+  {
+    if (_colored)
+      return;
+    if (_form->rank() < 1)
+      throw std::runtime_error("Colorings require a linear or bilinear form.");
+    common::Timer timer("Color assembly plan integral domains");
+
+    const graph::AdjacencyList<std::int32_t>& dofs
+        = _form->function_space(0)->dofmap()->list();
+    const FormIntegrals<T>& integrals = _form->integrals();
+    for (int i = 0; i < integrals.num_integrals(IntegralType::cell); ++i)
+    {
+      _cell_colors.push_back(
+          color_cells(integrals.integral_domains(IntegralType::cell, i), dofs));
+    }
+    for (const auto& facets : _exterior_facets)
+      _exterior_facet_colors.push_back(color_facets<2>(facets, dofs));
+    for (const auto& facets : _interior_facets)
+      _interior_facet_colors.push_back(color_facets<4>(facets, dofs));
+    _colored = true;
+  }
+
+  /// The form
+  const Form<T>& form() const { return *_form; }
+
+  /// Packed constants
+  const Eigen::Array<T, Eigen::Dynamic, 1>& constants() const
+  {
+    return _constants;
+  }
+
+  /// Packed coefficients, one row per cell
+  const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>&
+  coefficients() const
+  {
+    return _coeffs;
+  }
+
+  /// Cell permutation info, one entry per cell. Zero if the form does
+  /// not require permutation data.
+  const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info() const
+  {
+    return _cell_info;
+  }
+
+  /// Facet permutation data, (local facet, cell). Zero if the form does
+  /// not require permutation data.
+  const Eigen::Array<std::uint8_t, Eigen::Dynamic, Eigen::Dynamic>&
+  facet_permutations() const
+  {
+    return _perms;
+  }
+
+  /// The (cell, local facet) pair for each facet of the ith exterior
+  /// facet integral
+  const Eigen::Array<std::int32_t, Eigen::Dynamic, 2, Eigen::RowMajor>&
+  exterior_facets(int i) const
+  {
+    return _exterior_facets.at(i);
+  }
+
+  /// The (cell0, local facet0, cell1, local facet1) data for each facet
+  /// of the ith interior facet integral
+  const Eigen::Array<std::int32_t, Eigen::Dynamic, 4, Eigen::RowMajor>&
+  interior_facets(int i) const
+  {
+    return _interior_facets.at(i);
+  }
+
+  /// The cells of the ith cell integral grouped by color. See
+  /// create_colorings(), which must have been called.
+  const std::vector<std::vector<std::int32_t>>& cell_colors(int i) const
+  {
+    check_colored();
+    return _cell_colors.at(i);
+  }
+
+  /// The rows of exterior_facets(i) grouped by color. See
+  /// create_colorings(), which must have been called.
+  const std::vector<std::vector<std::int32_t>>&
+  exterior_facet_colors(int i) const
+  {
+    check_colored();
+    return _exterior_facet_colors.at(i);
+  }
+
+  /// The rows of interior_facets(i) grouped by color. See
+  /// create_colorings(), which must have been called.
+  const std::vector<std::vector<std::int32_t>>&
+  interior_facet_colors(int i) const
+  {
+    check_colored();
+    return _interior_facet_colors.at(i);
+  }
+
+  /// Position of each cell matrix entry (row-major) in the values of
+  /// a CSR matrix, one row per cell. Empty if the plan was not created
+  /// with a matrix.
+  const Eigen::Array<std::int32_t, Eigen::Dynamic, Eigen::Dynamic,
+                     Eigen::RowMajor>&
+  csr_positions() const
+  {
+    return _csr_positions;
+  }
+
+  /// Number of values of the CSR matrix that csr_positions() refers to,
+  /// or -1 if the plan was not created with a matrix
+  std::int64_t csr_size() const { return _csr_size; }
+
+private:
+  // Pack constants and the flagged coefficients, and record the id and
+  // version of each coefficient
+  void repack(const std::vector<bool>& pack, int num_threads)
+  {
+    if (!_form->all_constants_set())
+      throw std::runtime_error("Unset constant in Form");
+    _constants = pack_constants(*_form);
+
+    const FormCoefficients<T>& coefficients = _form->coefficients();
+    if (_coeff_versions.size() != (std::size_t)coefficients.size())
+      _coeffs.resize(0, 0);
+    _coeff_versions.resize(coefficients.size());
+    for (int i = 0; i < coefficients.size(); ++i)
+    {
+      std::shared_ptr<const function::Function<T>> u = coefficients.get(i);
+      _coeff_versions[i] = {u->id(), u->version()};
+    }
+    pack_coefficients(*_form, _coeffs, pack, num_threads);
+  }
+
+  void check_colored() const
+  {
+    if (!_colored)
+    {
+      throw std::runtime_error("Assembly plan has no colorings. Call "
+                               "create_colorings() before threaded assembly.");
+    }
+  }
+
+  // Color the rows of a facet array such that facets in the same color
+  // share no dof of their attached cells. Columns 0, 2, ... of facets
+  // hold cells.
+  template <int N>
+  static std::vector<std::vector<std::int32_t>> color_facets(
+      const Eigen::Array<std::int32_t, Eigen::Dynamic, N, Eigen::RowMajor>&
+          facets,
+      const graph::AdjacencyList<std::int32_t>& dofmap)
+  {
+    // Build graph from facet (row) to the dofs of the attached cells
+    std::vector<std::int32_t> facet_dofs, offsets(1, 0);
+    for (Eigen::Index f = 0; f < facets.rows(); ++f)
+    {
+      for (int c = 0; c < N; c += 2)
+      {
+        auto dofs = dofmap.links(facets(f, c));
+        facet_dofs.insert(facet_dofs.end(), dofs.data(),
+                          dofs.data() + dofs.rows());
+      }
+      offsets.push_back(facet_dofs.size());
+    }
+    const graph::AdjacencyList<std::int32_t> facet_to_dofs(facet_dofs,
+                                                           offsets);
+
+    std::vector<std::int32_t> rows(facets.rows());
+    std::iota(rows.begin(), rows.end(), 0);
+    return color_cells(rows, facet_to_dofs);
+  }
+
+  // Compute the attached cell(s) and local index of each facet with
+  // respect to the cell(s). N = 2 for exterior and N = 4 for interior
+  // facets.
+  template <int N>
+  static Eigen::Array<std::int32_t, Eigen::Dynamic, N, Eigen::RowMajor>
+  compute_facet_data(const mesh::Topology& topology,
+                     const std::vector<std::int32_t>& facets)
+  {
+    const int tdim = topology.dim();
+    auto f_to_c = topology.connectivity(tdim - 1, tdim);
+    assert(f_to_c);
+    auto c_to_f = topology.connectivity(tdim, tdim - 1);
+    assert(c_to_f);
+
+    Eigen::Array<std::int32_t, Eigen::Dynamic, N, Eigen::RowMajor> data(
+        facets.size(), N);
+    for (std::size_t i = 0; i < facets.size(); ++i)
+    {
+      const std::int32_t f = facets[i];
+      auto cells = f_to_c->links(f);
+      assert(cells.rows() == N / 2);
+      for (int j = 0; j < N / 2; ++j)
+      {
+        auto cell_facets = c_to_f->links(cells[j]);
+        const auto* it = std::find(
+            cell_facets.data(), cell_facets.data() + cell_facets.rows(), f);
+        assert(it != (cell_facets.data() + cell_facets.rows()));
+        data(i, 2 * j) = cells[j];
+        data(i, 2 * j + 1) = std::distance(cell_facets.data(), it);
+      }
+    }
+
+    return data;
+  }
+
+  // The form
+  std::shared_ptr<const Form<T>> _form;
+
+  // Packed constants and coefficients
+  Eigen::Array<T, Eigen::Dynamic, 1> _constants;
+  Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> _coeffs;
+
+  // Id and version of each coefficient when it was last packed
+  std::vector<std::pair<std::size_t, std::uint64_t>> _coeff_versions;
+
+  // Permutation data
+  Eigen::Array<std::uint32_t, Eigen::Dynamic, 1> _cell_info;
+  Eigen::Array<std::uint8_t, Eigen::Dynamic, Eigen::Dynamic> _perms;
+
+  // Cell and local facet indices for each facet integral
+  std::vector<Eigen::Array<std::int32_t, Eigen::Dynamic, 2, Eigen::RowMajor>>
+      _exterior_facets;
+  std::vector<Eigen::Array<std::int32_t, Eigen::Dynamic, 4, Eigen::RowMajor>>
+      _interior_facets;
+
+  // Entities of each integral domain grouped by color, for threaded
+  // assembly
+  bool _colored = false;
+  std::vector<std::vector<std::vector<std::int32_t>>> _cell_colors,
+      _exterior_facet_colors, _interior_facet_colors;
+
+  // Positions of cell matrix entries in a CSR matrix
+  Eigen::Array<std::int32_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+      _csr_positions;
+  std::int64_t _csr_size = -1;
+};
+
+} // namespace dolfinx::fem
@@ -226,6 +226,19 @@ public:
       _integrals.set_default_domains(*_mesh);
   }
 
+  /// Register a batched 'tabulate_tensor' function for the existing
+  /// integral i. See FormIntegrals::set_tabulate_tensor_batch for the
+  /// data layout.
+  void set_tabulate_tensor_batch(
+      IntegralType type, int i,
+      const std::function<void(T*, const T*, const T*, const double*,
+                               const int*, const std::uint8_t*,
+                               const std::uint32_t*)>& fn,
+      int batch_size)
+  {
+    _integrals.set_tabulate_tensor_batch(type, i, fn, batch_size);
+  }
+
   /// Access coefficients
   FormCoefficients<T>& coefficients() { return _coefficients; }
 
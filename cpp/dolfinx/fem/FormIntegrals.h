@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <dolfinx/mesh/MeshTags.h>
 #include <functional>
@@ -111,6 +112,77 @@ public:
     integrals.insert(integrals.begin() + pos, {fn, i, {}});
   }
 
+  /// Get the batched 'tabulate_tensor' function for integral i of
+  /// given type. A batched function computes the element tensors for
+  /// a block of cells in one call. The function is empty if no batched
+  /// function has been set.
+  /// @param[in] type Integral type
+  /// @param[in] i Integral number
+  /// @return Batched tabulate function
+  const std::function<void(T*, const T*, const T*, const double*, const int*,
+                           const std::uint8_t*, const std::uint32_t*)>&
+  get_tabulate_tensor_batch(IntegralType type, int i) const
+  {
+    return _integrals.at(static_cast<int>(type)).at(i).tabulate_batch;
+  }
+
+  /// Number of cells processed in one call to the batched tabulate
+  /// function for integral i of given type
+  /// @param[in] type Integral type
+  /// @param[in] i Integral number
+  /// @return The batch size (0 if no batched function is set)
+  int batch_size(IntegralType type, int i) const
+  {
+    return _integrals.at(static_cast<int>(type)).at(i).batch_size;
+  }
+
+  /// Set a batched 'tabulate_tensor' function for the integral with ID
+  /// i of given type. The integral must already exist. When set, the
+  /// batched function is used by the assemblers in place of the
+  /// per-cell function.
+  ///
+  /// The function is called as fn(A, w, c, coordinate_dofs,
+  /// local_index, permutation, cell_info) for @p batch_size cells at a
+  /// time. Data for the cells in a batch are interleaved (cell index
+  /// runs fastest), i.e. for cell l of the batch
+  ///   A[k * batch_size + l] is the kth entry of the element tensor,
+  ///   w[k * batch_size + l] is the kth packed coefficient,
+  ///   coordinate_dofs[(i * gdim + j) * batch_size + l] is the jth
+  ///     component of the ith coordinate dof,
+  ///   local_index[l], permutation[l] and cell_info[l] are the local
+  ///     entity index, the entity permutation and the cell permutation
+  ///     info (local_index and permutation are nullptr for cell
+  ///     integrals).
+  /// Constants c are shared by all cells. A batch is always full;
+  /// incomplete batches are padded by repeating the last cell, and
+  /// the padded results are discarded.
+  /// @param[in] type Integral type
+  /// @param[in] i Integral ID
+  /// @param[in] fn Batched tabulate function
+  /// @param[in] batch_size Number of cells processed by fn per call
+  void set_tabulate_tensor_batch(
+      IntegralType type, int i,
+      const std::function<void(T*, const T*, const T*, const double*,
+                               const int*, const std::uint8_t*,
+                               const std::uint32_t*)>& fn,
+      int batch_size)
+  {
+    if (batch_size < 1)
+      throw std::runtime_error("Batch size must be positive.");
+
+    std::vector<struct FormIntegrals::Integral>& integrals
+        = _integrals.at(static_cast<int>(type));
+    auto it = std::find_if(integrals.begin(), integrals.end(),
+                           [i](const auto& q) { return q.id == i; });
+    if (it == integrals.end())
+    {
+      throw std::runtime_error("Integral with ID " + std::to_string(i)
+                               + " does not exist");
+    }
+    it->tabulate_batch = fn;
+    it->batch_size = batch_size;
+  }
+
   /// Get types of integrals in the form
   /// @return Integrals types
   std::set<IntegralType> types() const
@@ -366,6 +438,10 @@ private:
         tabulate;
     int id;
     std::vector<std::int32_t> active_entities;
+    std::function<void(T*, const T*, const T*, const double*, const int*,
+                       const std::uint8_t*, const std::uint32_t*)>
+        tabulate_batch = nullptr;
+    int batch_size = 0;
   };
 
   // Array of vectors of integrals, arranged by type (see Type enum, and
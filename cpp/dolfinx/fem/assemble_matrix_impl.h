@@ -6,17 +6,24 @@
 
 #pragma once
 
+#include "AssemblyPlan.h"
+#include "DirichletBC.h"
 #include "DofMap.h"
 #include "Form.h"
 #include "utils.h"
 #include <Eigen/Dense>
 #include <dolfinx/function/FunctionSpace.h>
 #include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/la/MatrixCSR.h>
 #include <dolfinx/la/utils.h>
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
+#include <array>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
 #include <vector>
 
 namespace dolfinx::fem::impl
@@ -27,13 +34,84 @@ namespace dolfinx::fem::impl
 /// local indices. Rows (bc0) and columns (bc1) with Dirichlet
 /// conditions are zeroed. Markers (bc0 and bc1) can be empty if not bcs
 /// are applied. Matrix is not finalised.
+///
+/// If num_threads > 1, cell and facet integrals are assembled
+/// concurrently by groups of entities that do not share a row dof. In
+/// this case mat_set_values must be safe to call concurrently for
+/// disjoint rows, see impl::serialise for insertion functions that are
+/// not.
 
 template <typename T>
 void assemble_matrix(
     const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
                             const std::int32_t*, const T*)>& mat_set_values,
     const Form<T>& a, const std::vector<bool>& bc0,
-    const std::vector<bool>& bc1);
+    const std::vector<bool>& bc1, int num_threads = 1);
+
+/// Assemble a matrix using the precomputed data in an assembly plan.
+/// See the above function for the treatment of bc0, bc1 and
+/// num_threads.
+template <typename T>
+void assemble_matrix(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_set_values,
+    const AssemblyPlan<T>& plan, const std::vector<bool>& bc0,
+    const std::vector<bool>& bc1, int num_threads = 1);
+
+/// Assemble a matrix into a CSR matrix using the precomputed data in
+/// an assembly plan. If the plan was created with a matrix that has the
+/// same sparsity pattern as A, cell contributions are added at the
+/// precomputed positions. Other contributions are located by searching
+/// the matrix rows. Contributions to ghost rows are not sent to the
+/// owner. See the above function for the treatment of bc0, bc1 and
+/// num_threads.
+template <typename T>
+void assemble_matrix(la::MatrixCSR<T>& A, const AssemblyPlan<T>& plan,
+                     const std::vector<bool>& bc0,
+                     const std::vector<bool>& bc1, int num_threads = 1);
+
+/// Execute kernels for the exterior and interior facet integrals in an
+/// assembly plan and accumulate result in matrix. See assemble_matrix
+/// for the requirements on mat_set_values if num_threads > 1.
+template <typename T>
+void assemble_facets(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_set_values,
+    const AssemblyPlan<T>& plan, const std::vector<bool>& bc0,
+    const std::vector<bool>& bc1, int num_threads = 1);
+
+/// Execute a function on the rows of a facet array. The rows are
+/// grouped into colors, see AssemblyPlan::exterior_facet_colors, and
+/// each color is split into num_threads blocks that are processed
+/// concurrently. The function is called as fn(facets) with the rows of
+/// a block.
+template <int N, typename Fn>
+void parallel_for_facets(
+    const Eigen::Array<std::int32_t, Eigen::Dynamic, N, Eigen::RowMajor>&
+        facets,
+    const std::vector<std::vector<std::int32_t>>& colors, int num_threads,
+    const Fn& fn);
+
+/// Wrap an insertion function such that calls are serialised by a
+/// lock on mutex. This allows insertion functions that are not thread
+/// safe, e.g. la::PETScMatrix::add_fn, to be used for threaded
+/// assembly, while element kernels are still executed concurrently.
+/// mat_set_values and mutex must outlive the returned function.
+template <typename T>
+std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                  const std::int32_t*, const T*)>
+serialise(const std::function<int(std::int32_t, const std::int32_t*,
+                                  std::int32_t, const std::int32_t*,
+                                  const T*)>& mat_set_values,
+          std::mutex& mutex);
+
+/// Build boundary condition markers for the rows and columns of a
+/// bilinear form. A marker array is empty if no boundary condition
+/// applies to the corresponding space.
+template <typename T>
+std::array<std::vector<bool>, 2> dof_markers(
+    const Form<T>& a,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs);
 
 /// Execute kernel over cells and accumulate result in matrix
 template <typename T>
@@ -52,12 +130,56 @@ void assemble_cells(
     const Eigen::Array<T, Eigen::Dynamic, 1>& constants,
     const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info);
 
-/// Execute kernel over exterior facets and  accumulate result in Mat
+/// Execute kernel over cells and add result to the values of a CSR
+/// matrix at precomputed positions, see AssemblyPlan::csr_positions
+template <typename T>
+void assemble_cells_csr(
+    std::vector<T>& values,
+    const Eigen::Array<std::int32_t, Eigen::Dynamic, Eigen::Dynamic,
+                       Eigen::RowMajor>& positions,
+    const mesh::Geometry& geometry,
+    const std::vector<std::int32_t>& active_cells,
+    const graph::AdjacencyList<std::int32_t>& dofmap0,
+    const graph::AdjacencyList<std::int32_t>& dofmap1,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*, const std::uint32_t)>& kernel,
+    const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>&
+        coeffs,
+    const Eigen::Array<T, Eigen::Dynamic, 1>& constants,
+    const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info);
+
+/// Execute batched kernel over blocks of cells and accumulate result
+/// in matrix. See FormIntegrals::set_tabulate_tensor_batch for the data
+/// layout.
+template <typename T>
+void assemble_cells_batched(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_set_values,
+    const mesh::Geometry& geometry,
+    const std::vector<std::int32_t>& active_cells,
+    const graph::AdjacencyList<std::int32_t>& dofmap0,
+    const graph::AdjacencyList<std::int32_t>& dofmap1,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*, const std::uint32_t*)>&
+        kernel,
+    int batch_size,
+    const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>&
+        coeffs,
+    const Eigen::Array<T, Eigen::Dynamic, 1>& constants,
+    const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info);
+
+/// Execute kernel over exterior facets and  accumulate result in Mat.
+/// Each row of facets holds the attached cell and the local index of
+/// the facet with respect to the cell.
 template <typename T>
 void assemble_exterior_facets(
     const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
                             const std::int32_t*, const T*)>& mat_set_values,
-    const mesh::Mesh& mesh, const std::vector<std::int32_t>& active_facets,
+    const mesh::Geometry& geometry,
+    const Eigen::Array<std::int32_t, Eigen::Dynamic, 2, Eigen::RowMajor>&
+        facets,
     const graph::AdjacencyList<std::int32_t>& dofmap0,
     const graph::AdjacencyList<std::int32_t>& dofmap1,
     const std::vector<bool>& bc0, const std::vector<bool>& bc1,
@@ -69,12 +191,36 @@ void assemble_exterior_facets(
     const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info,
     const Eigen::Array<std::uint8_t, Eigen::Dynamic, Eigen::Dynamic>& perms);
 
-/// Execute kernel over interior facets and  accumulate result in Mat
+/// Execute batched kernel over blocks of exterior facets and
+/// accumulate result in matrix
+template <typename T>
+void assemble_exterior_facets_batched(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_set_values,
+    const mesh::Geometry& geometry,
+    const Eigen::Array<std::int32_t, Eigen::Dynamic, 2, Eigen::RowMajor>&
+        facets,
+    const graph::AdjacencyList<std::int32_t>& dofmap0,
+    const graph::AdjacencyList<std::int32_t>& dofmap1,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*, const std::uint32_t*)>& fn,
+    int batch_size,
+    const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>&
+        coeffs,
+    const Eigen::Array<T, Eigen::Dynamic, 1>& constants,
+    const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info,
+    const Eigen::Array<std::uint8_t, Eigen::Dynamic, Eigen::Dynamic>& perms);
+
+/// Execute kernel over interior facets and  accumulate result in Mat.
+/// Each row of facets holds (cell0, local facet0, cell1, local facet1).
 template <typename T>
 void assemble_interior_facets(
     const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
                             const std::int32_t*, const T*)>& mat_set_values,
-    const mesh::Mesh& mesh, const std::vector<std::int32_t>& active_facets,
+    const mesh::Geometry& geometry,
+    const Eigen::Array<std::int32_t, Eigen::Dynamic, 4, Eigen::RowMajor>&
+        facets,
     const DofMap& dofmap0, const DofMap& dofmap1, const std::vector<bool>& bc0,
     const std::vector<bool>& bc1,
     const std::function<void(T*, const T*, const T*, const double*, const int*,
@@ -92,13 +238,27 @@ void assemble_matrix(
     const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
                             const std::int32_t*, const T*)>& mat_set_values,
     const Form<T>& a, const std::vector<bool>& bc0,
-    const std::vector<bool>& bc1)
+    const std::vector<bool>& bc1, int num_threads)
+{
+  // Build a single-use plan. The form outlives the plan, so the plan
+  // does not need to share ownership of it.
+  AssemblyPlan<T> plan(
+      std::shared_ptr<const Form<T>>(&a, [](const Form<T>*) {}));
+  if (num_threads > 1)
+    plan.create_colorings();
+  assemble_matrix(mat_set_values, plan, bc0, bc1, num_threads);
+}
+//-----------------------------------------------------------------------------
+template <typename T>
+void assemble_matrix(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_set_values,
+    const AssemblyPlan<T>& plan, const std::vector<bool>& bc0,
+    const std::vector<bool>& bc1, int num_threads)
 {
+  const Form<T>& a = plan.form();
   std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
   assert(mesh);
-  const int tdim = mesh->topology().dim();
-  const std::int32_t num_cells
-      = mesh->topology().connectivity(tdim, 0)->num_nodes();
 
   // Get dofmap data
   std::shared_ptr<const fem::DofMap> dofmap0 = a.function_space(0)->dofmap();
@@ -108,76 +268,275 @@ void assemble_matrix(
   const graph::AdjacencyList<std::int32_t>& dofs0 = dofmap0->list();
   const graph::AdjacencyList<std::int32_t>& dofs1 = dofmap1->list();
 
-  // Prepare constants
-  if (!a.all_constants_set())
-    throw std::runtime_error("Unset constant in Form");
-  const Eigen::Array<T, Eigen::Dynamic, 1> constants = pack_constants(a);
-
-  // Prepare coefficients
-  const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> coeffs
-      = pack_coefficients(a);
-
-  const FormIntegrals<T>& integrals = a.integrals();
-  const bool needs_permutation_data = integrals.needs_permutation_data();
-  if (needs_permutation_data)
-    mesh->topology_mutable().create_entity_permutations();
+  // Packed data and permutation info
+  const Eigen::Array<T, Eigen::Dynamic, 1>& constants = plan.constants();
+  const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>&
+      coeffs
+      = plan.coefficients();
   const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info
-      = needs_permutation_data
-            ? mesh->topology().get_cell_permutation_info()
-            : Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>(num_cells);
+      = plan.cell_info();
 
+  const FormIntegrals<T>& integrals = a.integrals();
   for (int i = 0; i < integrals.num_integrals(IntegralType::cell); ++i)
   {
     const auto& fn = integrals.get_tabulate_tensor(IntegralType::cell, i);
+    const auto& fn_batch
+        = integrals.get_tabulate_tensor_batch(IntegralType::cell, i);
+    const int batch_size = integrals.batch_size(IntegralType::cell, i);
+    auto assemble = [&](const std::vector<std::int32_t>& cells) {
+      if (fn_batch)
+      {
+        impl::assemble_cells_batched<T>(mat_set_values, mesh->geometry(),
+                                        cells, dofs0, dofs1, bc0, bc1,
+                                        fn_batch, batch_size, coeffs,
+                                        constants, cell_info);
+      }
+      else
+      {
+        impl::assemble_cells<T>(mat_set_values, mesh->geometry(), cells,
+                                dofs0, dofs1, bc0, bc1, fn, coeffs, constants,
+                                cell_info);
+      }
+    };
+
     const std::vector<std::int32_t>& active_cells
         = integrals.integral_domains(IntegralType::cell, i);
-    impl::assemble_cells<T>(mat_set_values, mesh->geometry(), active_cells,
-                            dofs0, dofs1, bc0, bc1, fn, coeffs, constants,
-                            cell_info);
+    if (num_threads > 1)
+    {
+      parallel_for_colors(
+          plan.cell_colors(i), num_threads,
+          [&](int, const std::vector<std::int32_t>& cells) {
+            assemble(cells);
+          });
+    }
+    else
+      assemble(active_cells);
   }
 
-  if (integrals.num_integrals(IntegralType::exterior_facet) > 0
-      or integrals.num_integrals(IntegralType::interior_facet) > 0)
+  assemble_facets(mat_set_values, plan, bc0, bc1, num_threads);
+}
+//-----------------------------------------------------------------------------
+template <typename T>
+void assemble_matrix(la::MatrixCSR<T>& A, const AssemblyPlan<T>& plan,
+                     const std::vector<bool>& bc0,
+                     const std::vector<bool>& bc1, int num_threads)
+{
+  // Without positions, locate entries by search
+  if (plan.csr_size() < 0)
+  {
+    assemble_matrix(A.mat_add_values(), plan, bc0, bc1, num_threads);
+    return;
+  }
+  else if (plan.csr_size() != (std::int64_t)A.values().size())
+  {
+    throw std::runtime_error(
+        "Assembly plan CSR positions do not match the matrix.");
+  }
+
+  const Form<T>& a = plan.form();
+  std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
+  assert(mesh);
+  const graph::AdjacencyList<std::int32_t>& dofs0
+      = a.function_space(0)->dofmap()->list();
+  const graph::AdjacencyList<std::int32_t>& dofs1
+      = a.function_space(1)->dofmap()->list();
+
+  const FormIntegrals<T>& integrals = a.integrals();
+  for (int i = 0; i < integrals.num_integrals(IntegralType::cell); ++i)
   {
-    // FIXME: cleanup these calls? Some of the happen internally again.
-    mesh->topology_mutable().create_entities(tdim - 1);
-    mesh->topology_mutable().create_connectivity(tdim - 1, tdim);
-
-    const int facets_per_cell
-        = mesh::cell_num_entities(mesh->topology().cell_type(), tdim - 1);
-    const Eigen::Array<std::uint8_t, Eigen::Dynamic, Eigen::Dynamic>& perms
-        = needs_permutation_data
-              ? mesh->topology().get_facet_permutations()
-              : Eigen::Array<std::uint8_t, Eigen::Dynamic, Eigen::Dynamic>(
-                  facets_per_cell, num_cells);
-
-    for (int i = 0; i < integrals.num_integrals(IntegralType::exterior_facet);
-         ++i)
+    const auto& fn = integrals.get_tabulate_tensor(IntegralType::cell, i);
+    const auto& fn_batch
+        = integrals.get_tabulate_tensor_batch(IntegralType::cell, i);
+    auto assemble = [&](const std::vector<std::int32_t>& cells) {
+      if (fn_batch)
+      {
+        impl::assemble_cells_batched<T>(
+            A.mat_add_values(), mesh->geometry(), cells, dofs0, dofs1, bc0,
+            bc1, fn_batch, integrals.batch_size(IntegralType::cell, i),
+            plan.coefficients(), plan.constants(), plan.cell_info());
+      }
+      else
+      {
+        impl::assemble_cells_csr<T>(
+            A.values(), plan.csr_positions(), mesh->geometry(), cells, dofs0,
+            dofs1, bc0, bc1, fn, plan.coefficients(), plan.constants(),
+            plan.cell_info());
+      }
+    };
+
+    const std::vector<std::int32_t>& active_cells
+        = integrals.integral_domains(IntegralType::cell, i);
+    if (num_threads > 1)
     {
-      const auto& fn
-          = integrals.get_tabulate_tensor(IntegralType::exterior_facet, i);
-      const std::vector<std::int32_t>& active_facets
-          = integrals.integral_domains(IntegralType::exterior_facet, i);
-      impl::assemble_exterior_facets<T>(mat_set_values, *mesh, active_facets,
-                                        dofs0, dofs1, bc0, bc1, fn, coeffs,
-                                        constants, cell_info, perms);
+      parallel_for_colors(
+          plan.cell_colors(i), num_threads,
+          [&](int, const std::vector<std::int32_t>& cells) {
+            assemble(cells);
+          });
     }
+    else
+      assemble(active_cells);
+  }
 
-    const std::vector<int> c_offsets = a.coefficients().offsets();
-    for (int i = 0; i < integrals.num_integrals(IntegralType::interior_facet);
-         ++i)
+  assemble_facets(A.mat_add_values(), plan, bc0, bc1, num_threads);
+}
+//-----------------------------------------------------------------------------
+template <typename T>
+void assemble_facets(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_set_values,
+    const AssemblyPlan<T>& plan, const std::vector<bool>& bc0,
+    const std::vector<bool>& bc1, int num_threads)
+{
+  const Form<T>& a = plan.form();
+  std::shared_ptr<const mesh::Mesh> mesh = a.mesh();
+  assert(mesh);
+
+  // Get dofmap data
+  std::shared_ptr<const fem::DofMap> dofmap0 = a.function_space(0)->dofmap();
+  std::shared_ptr<const fem::DofMap> dofmap1 = a.function_space(1)->dofmap();
+  assert(dofmap0);
+  assert(dofmap1);
+  const graph::AdjacencyList<std::int32_t>& dofs0 = dofmap0->list();
+  const graph::AdjacencyList<std::int32_t>& dofs1 = dofmap1->list();
+
+  // Packed data and permutation info
+  const Eigen::Array<T, Eigen::Dynamic, 1>& constants = plan.constants();
+  const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>&
+      coeffs
+      = plan.coefficients();
+  const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info
+      = plan.cell_info();
+  const Eigen::Array<std::uint8_t, Eigen::Dynamic, Eigen::Dynamic>& perms
+      = plan.facet_permutations();
+
+  const FormIntegrals<T>& integrals = a.integrals();
+  for (int i = 0; i < integrals.num_integrals(IntegralType::exterior_facet);
+       ++i)
+  {
+    const auto& fn
+        = integrals.get_tabulate_tensor(IntegralType::exterior_facet, i);
+    const auto& fn_batch
+        = integrals.get_tabulate_tensor_batch(IntegralType::exterior_facet, i);
+    auto assemble = [&](const Eigen::Array<std::int32_t, Eigen::Dynamic, 2,
+                                           Eigen::RowMajor>& facets) {
+      if (fn_batch)
+      {
+        impl::assemble_exterior_facets_batched<T>(
+            mat_set_values, mesh->geometry(), facets, dofs0, dofs1, bc0, bc1,
+            fn_batch, integrals.batch_size(IntegralType::exterior_facet, i),
+            coeffs, constants, cell_info, perms);
+      }
+      else
+      {
+        impl::assemble_exterior_facets<T>(mat_set_values, mesh->geometry(),
+                                          facets, dofs0, dofs1, bc0, bc1, fn,
+                                          coeffs, constants, cell_info, perms);
+      }
+    };
+
+    if (num_threads > 1)
     {
-      const auto& fn
-          = integrals.get_tabulate_tensor(IntegralType::interior_facet, i);
-      const std::vector<std::int32_t>& active_facets
-          = integrals.integral_domains(IntegralType::interior_facet, i);
+      parallel_for_facets(plan.exterior_facets(i),
+                          plan.exterior_facet_colors(i), num_threads,
+                          assemble);
+    }
+    else
+      assemble(plan.exterior_facets(i));
+  }
+
+  const std::vector<int> c_offsets = a.coefficients().offsets();
+  for (int i = 0; i < integrals.num_integrals(IntegralType::interior_facet);
+       ++i)
+  {
+    const auto& fn
+        = integrals.get_tabulate_tensor(IntegralType::interior_facet, i);
+    auto assemble = [&](const Eigen::Array<std::int32_t, Eigen::Dynamic, 4,
+                                           Eigen::RowMajor>& facets) {
       impl::assemble_interior_facets<T>(
-          mat_set_values, *mesh, active_facets, *dofmap0, *dofmap1, bc0, bc1,
-          fn, coeffs, c_offsets, constants, cell_info, perms);
+          mat_set_values, mesh->geometry(), facets, *dofmap0, *dofmap1, bc0,
+          bc1, fn, coeffs, c_offsets, constants, cell_info, perms);
+    };
+
+    if (num_threads > 1)
+    {
+      parallel_for_facets(plan.interior_facets(i),
+                          plan.interior_facet_colors(i), num_threads,
+                          assemble);
     }
+    else
+      assemble(plan.interior_facets(i));
   }
 }
 //-----------------------------------------------------------------------------
+template <int N, typename Fn>
+void parallel_for_facets(
+    const Eigen::Array<std::int32_t, Eigen::Dynamic, N, Eigen::RowMajor>&
+        facets,
+    const std::vector<std::vector<std::int32_t>>& colors, int num_threads,
+    const Fn& fn)
+{
+  parallel_for_colors(
+      colors, num_threads,
+      [&](int, const std::vector<std::int32_t>& block_rows) {
+        Eigen::Array<std::int32_t, Eigen::Dynamic, N, Eigen::RowMajor> block(
+            block_rows.size(), N);
+        for (std::size_t k = 0; k < block_rows.size(); ++k)
+          block.row(k) = facets.row(block_rows[k]);
+        fn(block);
+      });
+}
+//-----------------------------------------------------------------------------
+template <typename T>
+std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                  const std::int32_t*, const T*)>
+serialise(const std::function<int(std::int32_t, const std::int32_t*,
+                                  std::int32_t, const std::int32_t*,
+                                  const T*)>& mat_set_values,
+          std::mutex& mutex)
+{
+  return [&mat_set_values, &mutex](std::int32_t m, const std::int32_t* rows,
+                                   std::int32_t n, const std::int32_t* cols,
+                                   const T* vals) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return mat_set_values(m, rows, n, cols, vals);
+  };
+}
+//-----------------------------------------------------------------------------
+template <typename T>
+std::array<std::vector<bool>, 2> dof_markers(
+    const Form<T>& a,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs)
+{
+  // Index maps for dof ranges
+  auto map0 = a.function_space(0)->dofmap()->index_map;
+  auto map1 = a.function_space(1)->dofmap()->index_map;
+
+  // Build dof markers
+  std::array<std::vector<bool>, 2> markers;
+  std::int32_t dim0
+      = map0->block_size() * (map0->size_local() + map0->num_ghosts());
+  std::int32_t dim1
+      = map1->block_size() * (map1->size_local() + map1->num_ghosts());
+  for (std::size_t k = 0; k < bcs.size(); ++k)
+  {
+    assert(bcs[k]);
+    assert(bcs[k]->function_space());
+    if (a.function_space(0)->contains(*bcs[k]->function_space()))
+    {
+      markers[0].resize(dim0, false);
+      bcs[k]->mark_dofs(markers[0]);
+    }
+    if (a.function_space(1)->contains(*bcs[k]->function_space()))
+    {
+      markers[1].resize(dim1, false);
+      bcs[k]->mark_dofs(markers[1]);
+    }
+  }
+
+  return markers;
+}
+//-----------------------------------------------------------------------------
 template <typename T>
 void assemble_cells(
     const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
@@ -251,10 +610,188 @@ void assemble_cells(
 }
 //-----------------------------------------------------------------------------
 template <typename T>
+void assemble_cells_csr(
+    std::vector<T>& values,
+    const Eigen::Array<std::int32_t, Eigen::Dynamic, Eigen::Dynamic,
+                       Eigen::RowMajor>& positions,
+    const mesh::Geometry& geometry,
+    const std::vector<std::int32_t>& active_cells,
+    const graph::AdjacencyList<std::int32_t>& dofmap0,
+    const graph::AdjacencyList<std::int32_t>& dofmap1,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*, const std::uint32_t)>& kernel,
+    const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>&
+        coeffs,
+    const Eigen::Array<T, Eigen::Dynamic, 1>& constants,
+    const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info)
+{
+  const int gdim = geometry.dim();
+
+  // Prepare cell geometry
+  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
+
+  // FIXME: Add proper interface for num coordinate dofs
+  const int num_dofs_g = x_dofmap.num_links(0);
+  const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& x_g
+      = geometry.x();
+
+  // Data structures used in assembly
+  Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+      coordinate_dofs(num_dofs_g, gdim);
+  const int num_dofs0 = dofmap0.links(0).size();
+  const int num_dofs1 = dofmap1.links(0).size();
+  const int num_entries = num_dofs0 * num_dofs1;
+  assert(positions.cols() == num_entries);
+  Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> Ae(
+      num_dofs0, num_dofs1);
+
+  // Iterate over active cells
+  for (std::int32_t c : active_cells)
+  {
+    // Get cell coordinates/geometry
+    auto x_dofs = x_dofmap.links(c);
+    for (int i = 0; i < x_dofs.rows(); ++i)
+      for (int j = 0; j < gdim; ++j)
+        coordinate_dofs(i, j) = x_g(x_dofs[i], j);
+
+    // Tabulate tensor
+    std::fill(Ae.data(), Ae.data() + num_entries, 0);
+    kernel(Ae.data(), coeffs.row(c).data(), constants.data(),
+           coordinate_dofs.data(), nullptr, nullptr, cell_info[c]);
+
+    // Zero rows/columns for essential bcs
+    if (!bc0.empty())
+    {
+      auto dofs0 = dofmap0.links(c);
+      for (Eigen::Index i = 0; i < Ae.rows(); ++i)
+      {
+        if (bc0[dofs0[i]])
+          Ae.row(i).setZero();
+      }
+    }
+    if (!bc1.empty())
+    {
+      auto dofs1 = dofmap1.links(c);
+      for (Eigen::Index j = 0; j < Ae.cols(); ++j)
+      {
+        if (bc1[dofs1[j]])
+          Ae.col(j).setZero();
+      }
+    }
+
+    // Add to matrix values
+    const std::int32_t* pos = positions.row(c).data();
+    for (int k = 0; k < num_entries; ++k)
+      values[pos[k]] += Ae.data()[k];
+  }
+}
+//-----------------------------------------------------------------------------
+template <typename T>
+void assemble_cells_batched(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_set,
+    const mesh::Geometry& geometry,
+    const std::vector<std::int32_t>& active_cells,
+    const graph::AdjacencyList<std::int32_t>& dofmap0,
+    const graph::AdjacencyList<std::int32_t>& dofmap1,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*, const std::uint32_t*)>&
+        kernel,
+    int batch_size,
+    const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>&
+        coeffs,
+    const Eigen::Array<T, Eigen::Dynamic, 1>& constants,
+    const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info)
+{
+  assert(batch_size > 0);
+  const int gdim = geometry.dim();
+
+  // Prepare cell geometry
+  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
+
+  // FIXME: Add proper interface for num coordinate dofs
+  const int num_dofs_g = x_dofmap.num_links(0);
+  const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& x_g
+      = geometry.x();
+
+  // Interleaved data structures for a batch of cells
+  const int num_dofs0 = dofmap0.links(0).size();
+  const int num_dofs1 = dofmap1.links(0).size();
+  const int num_entries = num_dofs0 * num_dofs1;
+  const Eigen::Index num_coeffs = coeffs.cols();
+  std::vector<double> coordinate_dofs(batch_size * num_dofs_g * gdim);
+  std::vector<T> coeffs_batch(batch_size * num_coeffs);
+  std::vector<std::uint32_t> info_batch(batch_size);
+  std::vector<T> A_batch(batch_size * num_entries);
+  Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> Ae(
+      num_dofs0, num_dofs1);
+
+  const std::size_t num_cells = active_cells.size();
+  for (std::size_t start = 0; start < num_cells; start += batch_size)
+  {
+    const int num_valid = std::min(num_cells - start, (std::size_t)batch_size);
+
+    // Pack (interleave) geometry, coefficients and permutation data.
+    // Pad incomplete batches with the last cell.
+    for (int l = 0; l < batch_size; ++l)
+    {
+      const std::int32_t c = active_cells[start + std::min(l, num_valid - 1)];
+      auto x_dofs = x_dofmap.links(c);
+      for (int i = 0; i < num_dofs_g; ++i)
+        for (int j = 0; j < gdim; ++j)
+          coordinate_dofs[(i * gdim + j) * batch_size + l] = x_g(x_dofs[i], j);
+      for (Eigen::Index k = 0; k < num_coeffs; ++k)
+        coeffs_batch[k * batch_size + l] = coeffs(c, k);
+      info_batch[l] = cell_info[c];
+    }
+
+    // Tabulate tensors for batch
+    std::fill(A_batch.begin(), A_batch.end(), 0);
+    kernel(A_batch.data(), coeffs_batch.data(), constants.data(),
+           coordinate_dofs.data(), nullptr, nullptr, info_batch.data());
+
+    for (int l = 0; l < num_valid; ++l)
+    {
+      // Extract element tensor for cell
+      for (int k = 0; k < num_entries; ++k)
+        Ae.data()[k] = A_batch[k * batch_size + l];
+
+      // Zero rows/columns for essential bcs
+      const std::int32_t c = active_cells[start + l];
+      auto dofs0 = dofmap0.links(c);
+      auto dofs1 = dofmap1.links(c);
+      if (!bc0.empty())
+      {
+        for (Eigen::Index i = 0; i < Ae.rows(); ++i)
+        {
+          if (bc0[dofs0[i]])
+            Ae.row(i).setZero();
+        }
+      }
+      if (!bc1.empty())
+      {
+        for (Eigen::Index j = 0; j < Ae.cols(); ++j)
+        {
+          if (bc1[dofs1[j]])
+            Ae.col(j).setZero();
+        }
+      }
+
+      mat_set(dofs0.size(), dofs0.data(), dofs1.size(), dofs1.data(),
+              Ae.data());
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+template <typename T>
 void assemble_exterior_facets(
     const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
                             const std::int32_t*, const T*)>& mat_set_values,
-    const mesh::Mesh& mesh, const std::vector<std::int32_t>& active_facets,
+    const mesh::Geometry& geometry,
+    const Eigen::Array<std::int32_t, Eigen::Dynamic, 2, Eigen::RowMajor>&
+        facets,
     const graph::AdjacencyList<std::int32_t>& dofmap0,
     const graph::AdjacencyList<std::int32_t>& dofmap1,
     const std::vector<bool>& bc0, const std::vector<bool>& bc1,
@@ -266,16 +803,15 @@ void assemble_exterior_facets(
     const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info,
     const Eigen::Array<std::uint8_t, Eigen::Dynamic, Eigen::Dynamic>& perms)
 {
-  const int gdim = mesh.geometry().dim();
-  const int tdim = mesh.topology().dim();
+  const int gdim = geometry.dim();
 
   // Prepare cell geometry
-  const graph::AdjacencyList<std::int32_t>& x_dofmap = mesh.geometry().dofmap();
+  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
 
   // FIXME: Add proper interface for num coordinate dofs
   const int num_dofs_g = x_dofmap.num_links(0);
   const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& x_g
-      = mesh.geometry().x();
+      = geometry.x();
 
   // Data structures used in assembly
   Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
@@ -286,36 +822,26 @@ void assemble_exterior_facets(
       num_dofs0, num_dofs1);
 
   // Iterate over all facets
-  auto f_to_c = mesh.topology().connectivity(tdim - 1, tdim);
-  assert(f_to_c);
-  auto c_to_f = mesh.topology().connectivity(tdim, tdim - 1);
-  assert(c_to_f);
-  for (std::int32_t f : active_facets)
+  for (Eigen::Index f = 0; f < facets.rows(); ++f)
   {
-    auto cells = f_to_c->links(f);
-    assert(cells.rows() == 1);
-
-    // Get local index of facet with respect to the cell
-    auto facets = c_to_f->links(cells[0]);
-    const auto* it = std::find(facets.data(), facets.data() + facets.rows(), f);
-    assert(it != (facets.data() + facets.rows()));
-    const int local_facet = std::distance(facets.data(), it);
+    const std::int32_t cell = facets(f, 0);
+    const int local_facet = facets(f, 1);
 
     // Get cell vertex coordinates
-    auto x_dofs = x_dofmap.links(cells[0]);
+    auto x_dofs = x_dofmap.links(cell);
     for (int i = 0; i < num_dofs_g; ++i)
       for (int j = 0; j < gdim; ++j)
         coordinate_dofs(i, j) = x_g(x_dofs[i], j);
 
     // Tabulate tensor
     std::fill(Ae.data(), Ae.data() + num_dofs0 * num_dofs1, 0);
-    kernel(Ae.data(), coeffs.row(cells[0]).data(), constants.data(),
-           coordinate_dofs.data(), &local_facet, &perms(local_facet, cells[0]),
-           cell_info[cells[0]]);
+    kernel(Ae.data(), coeffs.row(cell).data(), constants.data(),
+           coordinate_dofs.data(), &local_facet, &perms(local_facet, cell),
+           cell_info[cell]);
 
     // Zero rows/columns for essential bcs
-    auto dmap0 = dofmap0.links(cells[0]);
-    auto dmap1 = dofmap1.links(cells[0]);
+    auto dmap0 = dofmap0.links(cell);
+    auto dmap1 = dofmap1.links(cell);
     if (!bc0.empty())
     {
       for (Eigen::Index i = 0; i < Ae.rows(); ++i)
@@ -339,10 +865,121 @@ void assemble_exterior_facets(
 }
 //-----------------------------------------------------------------------------
 template <typename T>
+void assemble_exterior_facets_batched(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_set_values,
+    const mesh::Geometry& geometry,
+    const Eigen::Array<std::int32_t, Eigen::Dynamic, 2, Eigen::RowMajor>&
+        facets,
+    const graph::AdjacencyList<std::int32_t>& dofmap0,
+    const graph::AdjacencyList<std::int32_t>& dofmap1,
+    const std::vector<bool>& bc0, const std::vector<bool>& bc1,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*, const std::uint32_t*)>&
+        kernel,
+    int batch_size,
+    const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>&
+        coeffs,
+    const Eigen::Array<T, Eigen::Dynamic, 1>& constants,
+    const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info,
+    const Eigen::Array<std::uint8_t, Eigen::Dynamic, Eigen::Dynamic>& perms)
+{
+  assert(batch_size > 0);
+  const int gdim = geometry.dim();
+
+  // Prepare cell geometry
+  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
+
+  // FIXME: Add proper interface for num coordinate dofs
+  const int num_dofs_g = x_dofmap.num_links(0);
+  const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& x_g
+      = geometry.x();
+
+  // Interleaved data structures for a batch of facets
+  const int num_dofs0 = dofmap0.links(0).size();
+  const int num_dofs1 = dofmap1.links(0).size();
+  const int num_entries = num_dofs0 * num_dofs1;
+  const Eigen::Index num_coeffs = coeffs.cols();
+  std::vector<double> coordinate_dofs(batch_size * num_dofs_g * gdim);
+  std::vector<T> coeffs_batch(batch_size * num_coeffs);
+  std::vector<int> local_facet(batch_size);
+  std::vector<std::uint8_t> perm_batch(batch_size);
+  std::vector<std::uint32_t> info_batch(batch_size);
+  std::vector<std::int32_t> cells(batch_size);
+  std::vector<T> A_batch(batch_size * num_entries);
+  Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> Ae(
+      num_dofs0, num_dofs1);
+
+  const Eigen::Index num_facets = facets.rows();
+  for (Eigen::Index start = 0; start < num_facets; start += batch_size)
+  {
+    const int num_valid
+        = std::min(num_facets - start, (Eigen::Index)batch_size);
+
+    // Pack (interleave) geometry, coefficients and permutation data.
+    // Pad incomplete batches with the last facet.
+    for (int l = 0; l < batch_size; ++l)
+    {
+      const Eigen::Index f = start + std::min(l, num_valid - 1);
+      const std::int32_t c = facets(f, 0);
+      cells[l] = c;
+      local_facet[l] = facets(f, 1);
+      perm_batch[l] = perms(local_facet[l], c);
+      info_batch[l] = cell_info[c];
+
+      auto x_dofs = x_dofmap.links(c);
+      for (int i = 0; i < num_dofs_g; ++i)
+        for (int j = 0; j < gdim; ++j)
+          coordinate_dofs[(i * gdim + j) * batch_size + l] = x_g(x_dofs[i], j);
+      for (Eigen::Index k = 0; k < num_coeffs; ++k)
+        coeffs_batch[k * batch_size + l] = coeffs(c, k);
+    }
+
+    // Tabulate tensors for batch
+    std::fill(A_batch.begin(), A_batch.end(), 0);
+    kernel(A_batch.data(), coeffs_batch.data(), constants.data(),
+           coordinate_dofs.data(), local_facet.data(), perm_batch.data(),
+           info_batch.data());
+
+    for (int l = 0; l < num_valid; ++l)
+    {
+      // Extract element tensor for facet
+      for (int k = 0; k < num_entries; ++k)
+        Ae.data()[k] = A_batch[k * batch_size + l];
+
+      // Zero rows/columns for essential bcs
+      auto dmap0 = dofmap0.links(cells[l]);
+      auto dmap1 = dofmap1.links(cells[l]);
+      if (!bc0.empty())
+      {
+        for (Eigen::Index i = 0; i < Ae.rows(); ++i)
+        {
+          if (bc0[dmap0[i]])
+            Ae.row(i).setZero();
+        }
+      }
+      if (!bc1.empty())
+      {
+        for (Eigen::Index j = 0; j < Ae.cols(); ++j)
+        {
+          if (bc1[dmap1[j]])
+            Ae.col(j).setZero();
+        }
+      }
+
+      mat_set_values(dmap0.size(), dmap0.data(), dmap1.size(), dmap1.data(),
+                     Ae.data());
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+template <typename T>
 void assemble_interior_facets(
     const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
                             const std::int32_t*, const T*)>& mat_set_values,
-    const mesh::Mesh& mesh, const std::vector<std::int32_t>& active_facets,
+    const mesh::Geometry& geometry,
+    const Eigen::Array<std::int32_t, Eigen::Dynamic, 4, Eigen::RowMajor>&
+        facets,
     const DofMap& dofmap0, const DofMap& dofmap1, const std::vector<bool>& bc0,
     const std::vector<bool>& bc1,
     const std::function<void(T*, const T*, const T*, const double*, const int*,
@@ -354,17 +991,16 @@ void assemble_interior_facets(
     const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info,
     const Eigen::Array<std::uint8_t, Eigen::Dynamic, Eigen::Dynamic>& perms)
 {
-  const int gdim = mesh.geometry().dim();
-  const int tdim = mesh.topology().dim();
+  const int gdim = geometry.dim();
 
   // Prepare cell geometry
-  const graph::AdjacencyList<std::int32_t>& x_dofmap = mesh.geometry().dofmap();
+  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
 
   // FIXME: Add proper interface for num coordinate dofs
   const int num_dofs_g = x_dofmap.num_links(0);
 
   const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& x_g
-      = mesh.geometry().x();
+      = geometry.x();
 
   // Data structures used in assembly
   Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
@@ -377,29 +1013,11 @@ void assemble_interior_facets(
   Eigen::Array<std::int32_t, Eigen::Dynamic, 1> dmapjoint0, dmapjoint1;
 
   // Iterate over all facets
-  auto c = mesh.topology().connectivity(tdim - 1, tdim);
-  assert(c);
-  auto c_to_f = mesh.topology().connectivity(tdim, tdim - 1);
-  assert(c_to_f);
-  for (std::int32_t facet_index : active_facets)
+  for (Eigen::Index f = 0; f < facets.rows(); ++f)
   {
-    // Create attached cells
-    auto cells = c->links(facet_index);
-    assert(cells.rows() == 2);
-
-    // Get local index of facet with respect to the cell
-    auto facets0 = c_to_f->links(cells[0]);
-    const auto* it0 = std::find(facets0.data(), facets0.data() + facets0.rows(),
-                                facet_index);
-    assert(it0 != (facets0.data() + facets0.rows()));
-    const int local_facet0 = std::distance(facets0.data(), it0);
-    auto facets1 = c_to_f->links(cells[1]);
-    const auto* it1 = std::find(facets1.data(), facets1.data() + facets1.rows(),
-                                facet_index);
-    assert(it1 != (facets1.data() + facets1.rows()));
-    const int local_facet1 = std::distance(facets1.data(), it1);
-
-    const std::array local_facet{local_facet0, local_facet1};
+    // Attached cells and local index of facet with respect to each cell
+    const std::array cells{facets(f, 0), facets(f, 2)};
+    const std::array<int, 2> local_facet{facets(f, 1), facets(f, 3)};
 
     // Get cell geometry
     auto x_dofs0 = x_dofmap.links(cells[0]);
@@ -17,14 +17,16 @@
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/Topology.h>
 #include <memory>
+#include <numeric>
 #include <vector>
 
 namespace dolfinx::fem::impl
 {
 
-/// Assemble functional into an scalar
+/// Assemble functional into an scalar. Cell integrals are split
+/// between num_threads threads.
 template <typename T>
-T assemble_scalar(const fem::Form<T>& M);
+T assemble_scalar(const fem::Form<T>& M, int num_threads = 1);
 
 /// Assemble functional over cells
 template <typename T>
@@ -64,7 +66,7 @@ T assemble_interior_facets(
 
 //-----------------------------------------------------------------------------
 template <typename T>
-T assemble_scalar(const fem::Form<T>& M)
+T assemble_scalar(const fem::Form<T>& M, int num_threads)
 {
   std::shared_ptr<const mesh::Mesh> mesh = M.mesh();
   assert(mesh);
@@ -105,8 +107,25 @@ T assemble_scalar(const fem::Form<T>& M)
     const auto& fn = integrals.get_tabulate_tensor(IntegralType::cell, i);
     const std::vector<std::int32_t>& active_cells
         = integrals.integral_domains(IntegralType::cell, i);
-    value += fem::impl::assemble_cells(mesh->geometry(), active_cells, fn,
-                                       coeffs, constant_values, cell_info);
+    if (num_threads > 1)
+    {
+      // No write conflicts for functionals, so use a single 'color' and
+      // accumulate a value per thread
+      std::vector<T> values(num_threads, 0);
+      parallel_for_colors(
+          {active_cells}, num_threads,
+          [&](int thread, const std::vector<std::int32_t>& cells) {
+            values[thread] = fem::impl::assemble_cells(
+                mesh->geometry(), cells, fn, coeffs, constant_values,
+                cell_info);
+          });
+      value = std::accumulate(values.begin(), values.end(), value);
+    }
+    else
+    {
+      value += fem::impl::assemble_cells(mesh->geometry(), active_cells, fn,
+                                         coeffs, constant_values, cell_info);
+    }
   }
 
   if (integrals.num_integrals(IntegralType::exterior_facet) > 0
@@ -32,9 +32,11 @@ namespace dolfinx::fem::impl
 /// @param[in,out] b The vector to be assembled. It will not be zeroed before
 ///   assembly.
 /// @param[in] L The linear forms to assemble into b
+/// @param[in] num_threads Number of threads used to assemble cell
+///   integrals. Cells that share a dof are never assembled concurrently.
 template <typename T>
 void assemble_vector(Eigen::Ref<Eigen::Matrix<T, Eigen::Dynamic, 1>> b,
-                     const Form<T>& L);
+                     const Form<T>& L, int num_threads = 1);
 
 /// Execute kernel over cells and accumulate result in vector
 template <typename T>
@@ -50,6 +52,24 @@ void assemble_cells(
     const Eigen::Array<T, Eigen::Dynamic, 1>& constant_values,
     const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info);
 
+/// Execute batched kernel over blocks of cells and accumulate result
+/// in vector. See FormIntegrals::set_tabulate_tensor_batch for the data
+/// layout.
+template <typename T>
+void assemble_cells_batched(
+    Eigen::Ref<Eigen::Matrix<T, Eigen::Dynamic, 1>> b,
+    const mesh::Geometry& geometry,
+    const std::vector<std::int32_t>& active_cells,
+    const graph::AdjacencyList<std::int32_t>& dofmap,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*, const std::uint32_t*)>&
+        kernel,
+    int batch_size,
+    const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>&
+        coeffs,
+    const Eigen::Array<T, Eigen::Dynamic, 1>& constant_values,
+    const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info);
+
 /// Execute kernel over cells and accumulate result in vector
 template <typename T>
 void assemble_exterior_facets(
@@ -64,6 +84,22 @@ void assemble_exterior_facets(
     const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info,
     const Eigen::Array<std::uint8_t, Eigen::Dynamic, Eigen::Dynamic>& perms);
 
+/// Execute batched kernel over blocks of exterior facets and
+/// accumulate result in vector
+template <typename T>
+void assemble_exterior_facets_batched(
+    Eigen::Ref<Eigen::Matrix<T, Eigen::Dynamic, 1>> b, const mesh::Mesh& mesh,
+    const std::vector<std::int32_t>& active_facets,
+    const graph::AdjacencyList<std::int32_t>& dofmap,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*, const std::uint32_t*)>& fn,
+    int batch_size,
+    const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>&
+        coeffs,
+    const Eigen::Array<T, Eigen::Dynamic, 1>& constant_values,
+    const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info,
+    const Eigen::Array<std::uint8_t, Eigen::Dynamic, Eigen::Dynamic>& perms);
+
 /// Assemble linear form interior facet integrals into an Eigen vector
 template <typename T>
 void assemble_interior_facets(
@@ -416,7 +452,7 @@ void _lift_bc_exterior_facets(
 //-----------------------------------------------------------------------------
 template <typename T>
 void assemble_vector(Eigen::Ref<Eigen::Matrix<T, Eigen::Dynamic, 1>> b,
-                     const Form<T>& L)
+                     const Form<T>& L, int num_threads)
 {
   std::shared_ptr<const mesh::Mesh> mesh = L.mesh();
   assert(mesh);
@@ -451,10 +487,35 @@ void assemble_vector(Eigen::Ref<Eigen::Matrix<T, Eigen::Dynamic, 1>> b,
   for (int i = 0; i < integrals.num_integrals(IntegralType::cell); ++i)
   {
     const auto& fn = integrals.get_tabulate_tensor(IntegralType::cell, i);
+    const auto& fn_batch
+        = integrals.get_tabulate_tensor_batch(IntegralType::cell, i);
+    const int batch_size = integrals.batch_size(IntegralType::cell, i);
+    auto assemble = [&](const std::vector<std::int32_t>& cells) {
+      if (fn_batch)
+      {
+        fem::impl::assemble_cells_batched(b, mesh->geometry(), cells, dofs,
+                                          fn_batch, batch_size, coeffs,
+                                          constant_values, cell_info);
+      }
+      else
+      {
+        fem::impl::assemble_cells(b, mesh->geometry(), cells, dofs, fn,
+                                  coeffs, constant_values, cell_info);
+      }
+    };
+
     const std::vector<std::int32_t>& active_cells
         = integrals.integral_domains(IntegralType::cell, i);
-    fem::impl::assemble_cells(b, mesh->geometry(), active_cells, dofs, fn,
-                              coeffs, constant_values, cell_info);
+    if (num_threads > 1)
+    {
+      parallel_for_colors(
+          color_cells(active_cells, dofs), num_threads,
+          [&](int, const std::vector<std::int32_t>& cells) {
+            assemble(cells);
+          });
+    }
+    else
+      assemble(active_cells);
   }
 
   if (integrals.num_integrals(IntegralType::exterior_facet) > 0
@@ -476,11 +537,24 @@ void assemble_vector(Eigen::Ref<Eigen::Matrix<T, Eigen::Dynamic, 1>> b,
     {
       const auto& fn
           = integrals.get_tabulate_tensor(IntegralType::exterior_facet, i);
+      const auto& fn_batch
+          = integrals.get_tabulate_tensor_batch(IntegralType::exterior_facet,
+                                                i);
       const std::vector<std::int32_t>& active_facets
           = integrals.integral_domains(IntegralType::exterior_facet, i);
-      fem::impl::assemble_exterior_facets(b, *mesh, active_facets, dofs, fn,
-                                          coeffs, constant_values, cell_info,
-                                          perms);
+      if (fn_batch)
+      {
+        fem::impl::assemble_exterior_facets_batched(
+            b, *mesh, active_facets, dofs, fn_batch,
+            integrals.batch_size(IntegralType::exterior_facet, i), coeffs,
+            constant_values, cell_info, perms);
+      }
+      else
+      {
+        fem::impl::assemble_exterior_facets(b, *mesh, active_facets, dofs, fn,
+                                            coeffs, constant_values,
+                                            cell_info, perms);
+      }
     }
 
     const std::vector<int> c_offsets = L.coefficients().offsets();
@@ -550,6 +624,75 @@ void assemble_cells(
 }
 //-----------------------------------------------------------------------------
 template <typename T>
+void assemble_cells_batched(
+    Eigen::Ref<Eigen::Matrix<T, Eigen::Dynamic, 1>> b,
+    const mesh::Geometry& geometry,
+    const std::vector<std::int32_t>& active_cells,
+    const graph::AdjacencyList<std::int32_t>& dofmap,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*, const std::uint32_t*)>&
+        kernel,
+    int batch_size,
+    const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>&
+        coeffs,
+    const Eigen::Array<T, Eigen::Dynamic, 1>& constant_values,
+    const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info)
+{
+  assert(batch_size > 0);
+  const int gdim = geometry.dim();
+
+  // Prepare cell geometry
+  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
+
+  // FIXME: Add proper interface for num coordinate dofs
+  const int num_dofs_g = x_dofmap.num_links(0);
+  const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& x_g
+      = geometry.x();
+
+  // FIXME: Add proper interface for num_dofs
+  // Interleaved data structures for a batch of cells
+  const int num_dofs = dofmap.links(0).size();
+  const Eigen::Index num_coeffs = coeffs.cols();
+  std::vector<double> coordinate_dofs(batch_size * num_dofs_g * gdim);
+  std::vector<T> coeffs_batch(batch_size * num_coeffs);
+  std::vector<std::uint32_t> info_batch(batch_size);
+  std::vector<T> be_batch(batch_size * num_dofs);
+
+  const std::size_t num_cells = active_cells.size();
+  for (std::size_t start = 0; start < num_cells; start += batch_size)
+  {
+    const int num_valid = std::min(num_cells - start, (std::size_t)batch_size);
+
+    // Pack (interleave) geometry, coefficients and permutation data.
+    // Pad incomplete batches with the last cell.
+    for (int l = 0; l < batch_size; ++l)
+    {
+      const std::int32_t c = active_cells[start + std::min(l, num_valid - 1)];
+      auto x_dofs = x_dofmap.links(c);
+      for (int i = 0; i < num_dofs_g; ++i)
+        for (int j = 0; j < gdim; ++j)
+          coordinate_dofs[(i * gdim + j) * batch_size + l] = x_g(x_dofs[i], j);
+      for (Eigen::Index k = 0; k < num_coeffs; ++k)
+        coeffs_batch[k * batch_size + l] = coeffs(c, k);
+      info_batch[l] = cell_info[c];
+    }
+
+    // Tabulate vectors for batch
+    std::fill(be_batch.begin(), be_batch.end(), 0);
+    kernel(be_batch.data(), coeffs_batch.data(), constant_values.data(),
+           coordinate_dofs.data(), nullptr, nullptr, info_batch.data());
+
+    // Scatter cell vectors to 'global' vector array
+    for (int l = 0; l < num_valid; ++l)
+    {
+      auto dofs = dofmap.links(active_cells[start + l]);
+      for (Eigen::Index i = 0; i < num_dofs; ++i)
+        b[dofs[i]] += be_batch[i * batch_size + l];
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+template <typename T>
 void assemble_exterior_facets(
     Eigen::Ref<Eigen::Matrix<T, Eigen::Dynamic, 1>> b, const mesh::Mesh& mesh,
     const std::vector<std::int32_t>& active_facets,
@@ -616,6 +759,96 @@ void assemble_exterior_facets(
 }
 //-----------------------------------------------------------------------------
 template <typename T>
+void assemble_exterior_facets_batched(
+    Eigen::Ref<Eigen::Matrix<T, Eigen::Dynamic, 1>> b, const mesh::Mesh& mesh,
+    const std::vector<std::int32_t>& active_facets,
+    const graph::AdjacencyList<std::int32_t>& dofmap,
+    const std::function<void(T*, const T*, const T*, const double*, const int*,
+                             const std::uint8_t*, const std::uint32_t*)>& fn,
+    int batch_size,
+    const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>&
+        coeffs,
+    const Eigen::Array<T, Eigen::Dynamic, 1>& constant_values,
+    const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info,
+    const Eigen::Array<std::uint8_t, Eigen::Dynamic, Eigen::Dynamic>& perms)
+{
+  assert(batch_size > 0);
+  const int gdim = mesh.geometry().dim();
+  const int tdim = mesh.topology().dim();
+
+  // Prepare cell geometry
+  const graph::AdjacencyList<std::int32_t>& x_dofmap = mesh.geometry().dofmap();
+
+  // FIXME: Add proper interface for num coordinate dofs
+  const int num_dofs_g = x_dofmap.num_links(0);
+  const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& x_g
+      = mesh.geometry().x();
+
+  // FIXME: Add proper interface for num_dofs
+  // Interleaved data structures for a batch of facets
+  const int num_dofs = dofmap.links(0).size();
+  const Eigen::Index num_coeffs = coeffs.cols();
+  std::vector<double> coordinate_dofs(batch_size * num_dofs_g * gdim);
+  std::vector<T> coeffs_batch(batch_size * num_coeffs);
+  std::vector<int> local_facet(batch_size);
+  std::vector<std::uint8_t> perm_batch(batch_size);
+  std::vector<std::uint32_t> info_batch(batch_size);
+  std::vector<std::int32_t> cells(batch_size);
+  std::vector<T> be_batch(batch_size * num_dofs);
+
+  auto f_to_c = mesh.topology().connectivity(tdim - 1, tdim);
+  assert(f_to_c);
+  auto c_to_f = mesh.topology().connectivity(tdim, tdim - 1);
+  assert(c_to_f);
+  const std::size_t num_facets = active_facets.size();
+  for (std::size_t start = 0; start < num_facets; start += batch_size)
+  {
+    const int num_valid
+        = std::min(num_facets - start, (std::size_t)batch_size);
+
+    // Pack (interleave) geometry, coefficients and permutation data.
+    // Pad incomplete batches with the last facet.
+    for (int l = 0; l < batch_size; ++l)
+    {
+      const std::int32_t f = active_facets[start + std::min(l, num_valid - 1)];
+      assert(f_to_c->num_links(f) > 0);
+      const std::int32_t c = f_to_c->links(f)[0];
+      cells[l] = c;
+
+      // Get local index of facet with respect to the cell
+      auto facets = c_to_f->links(c);
+      const auto* it
+          = std::find(facets.data(), facets.data() + facets.rows(), f);
+      assert(it != (facets.data() + facets.rows()));
+      local_facet[l] = std::distance(facets.data(), it);
+      perm_batch[l] = perms(local_facet[l], c);
+      info_batch[l] = cell_info[c];
+
+      auto x_dofs = x_dofmap.links(c);
+      for (int i = 0; i < num_dofs_g; ++i)
+        for (int j = 0; j < gdim; ++j)
+          coordinate_dofs[(i * gdim + j) * batch_size + l] = x_g(x_dofs[i], j);
+      for (Eigen::Index k = 0; k < num_coeffs; ++k)
+        coeffs_batch[k * batch_size + l] = coeffs(c, k);
+    }
+
+    // Tabulate element vectors for batch
+    std::fill(be_batch.begin(), be_batch.end(), 0);
+    fn(be_batch.data(), coeffs_batch.data(), constant_values.data(),
+       coordinate_dofs.data(), local_facet.data(), perm_batch.data(),
+       info_batch.data());
+
+    // Add element vectors to global vector
+    for (int l = 0; l < num_valid; ++l)
+    {
+      auto dofs = dofmap.links(cells[l]);
+      for (Eigen::Index i = 0; i < num_dofs; ++i)
+        b[dofs[i]] += be_batch[i * batch_size + l];
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+template <typename T>
 void assemble_interior_facets(
     Eigen::Ref<Eigen::Matrix<T, Eigen::Dynamic, 1>> b, const mesh::Mesh& mesh,
     const std::vector<std::int32_t>& active_facets, const fem::DofMap& dofmap,
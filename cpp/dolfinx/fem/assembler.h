@@ -10,7 +10,9 @@
 #include "assemble_scalar_impl.h"
 #include "assemble_vector_impl.h"
 #include <Eigen/Dense>
+#include <dolfinx/la/Vector.h>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace dolfinx
@@ -32,12 +34,13 @@ class Form;
 /// Assemble functional into scalar. Caller is responsible for
 /// accumulation across processes.
 /// @param[in] M The form (functional) to assemble
+/// @param[in] num_threads Number of threads to use for cell integrals
 /// @return The contribution to the form (functional) from the local
 ///   process
 template <typename T>
-T assemble_scalar(const Form<T>& M)
+T assemble_scalar(const Form<T>& M, int num_threads = 1)
 {
-  return fem::impl::assemble_scalar(M);
+  return fem::impl::assemble_scalar(M, num_threads);
 }
 
 // -- Vectors ----------------------------------------------------------------
@@ -46,11 +49,14 @@ T assemble_scalar(const Form<T>& M)
 /// @param[in,out] b The Eigen vector to be assembled. It will not be
 ///   zeroed before assembly.
 /// @param[in] L The linear forms to assemble into b
+/// @param[in] num_threads Number of threads to use for cell integrals.
+///   Cells are colored such that cells sharing a dof are not assembled
+///   concurrently.
 template <typename T>
 void assemble_vector(Eigen::Ref<Eigen::Matrix<T, Eigen::Dynamic, 1>> b,
-                     const Form<T>& L)
+                     const Form<T>& L, int num_threads = 1)
 {
-  fem::impl::assemble_vector(b, L);
+  fem::impl::assemble_vector(b, L, num_threads);
 }
 
 // FIXME: clarify how x0 is used
@@ -91,42 +97,19 @@ void apply_lifting(
 /// @param[in] a The bilinear from to assemble
 /// @param[in] bcs Boundary conditions to apply. For boundary condition
 ///  dofs the row and column are zeroed. The diagonal  entry is not set.
+/// @param[in] num_threads Number of threads to use for cell and facet
+///   integrals. Calls to @p mat_add are serialised, so any insertion
+///   function, e.g. la::PETScMatrix::add_fn, can be used.
 template <typename T>
 void assemble_matrix(
     const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
                             const std::int32_t*, const T*)>& mat_add,
     const Form<T>& a,
-    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs)
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs,
+    int num_threads = 1)
 {
-
-  // Index maps for dof ranges
-  auto map0 = a.function_space(0)->dofmap()->index_map;
-  auto map1 = a.function_space(1)->dofmap()->index_map;
-
-  // Build dof markers
-  std::vector<bool> dof_marker0, dof_marker1;
-  std::int32_t dim0
-      = map0->block_size() * (map0->size_local() + map0->num_ghosts());
-  std::int32_t dim1
-      = map1->block_size() * (map1->size_local() + map1->num_ghosts());
-  for (std::size_t k = 0; k < bcs.size(); ++k)
-  {
-    assert(bcs[k]);
-    assert(bcs[k]->function_space());
-    if (a.function_space(0)->contains(*bcs[k]->function_space()))
-    {
-      dof_marker0.resize(dim0, false);
-      bcs[k]->mark_dofs(dof_marker0);
-    }
-    if (a.function_space(1)->contains(*bcs[k]->function_space()))
-    {
-      dof_marker1.resize(dim1, false);
-      bcs[k]->mark_dofs(dof_marker1);
-    }
-  }
-
-  // Assemble
-  impl::assemble_matrix(mat_add, a, dof_marker0, dof_marker1);
+  const auto [dof_marker0, dof_marker1] = impl::dof_markers(a, bcs);
+  assemble_matrix(mat_add, a, dof_marker0, dof_marker1, num_threads);
 }
 
 /// Assemble bilinear form into a matrix. Matrix must already be
@@ -139,15 +122,74 @@ void assemble_matrix(
 /// @param[in] dof_marker1 Boundary condition markers for the columns.
 ///   If bc[i] is true then rows i in A will be zeroed. The index i is a
 ///   local index.
+/// @param[in] num_threads Number of threads to use for cell and facet
+///   integrals. Calls to @p mat_add are serialised.
 template <typename T>
 void assemble_matrix(
     const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
                             const std::int32_t*, const T*)>& mat_add,
     const Form<T>& a, const std::vector<bool>& dof_marker0,
-    const std::vector<bool>& dof_marker1)
+    const std::vector<bool>& dof_marker1, int num_threads = 1)
+
+{
+  if (num_threads > 1)
+  {
+    std::mutex mutex;
+    impl::assemble_matrix<T>(impl::serialise<T>(mat_add, mutex), a,
+                             dof_marker0, dof_marker1, num_threads);
+  }
+  else
+    impl::assemble_matrix(mat_add, a, dof_marker0, dof_marker1);
+}
+
+/// Assemble bilinear form into a matrix using a precomputed assembly
+/// plan. The packed coefficients and constants held by the plan are
+/// used, see AssemblyPlan::update_coefficients. Matrix must already be
+/// initialised. Does not zero or finalise the matrix.
+/// @param[in] mat_add The function for adding values into the matrix
+/// @param[in] plan The assembly plan for the bilinear form
+/// @param[in] bcs Boundary conditions to apply. For boundary condition
+///  dofs the row and column are zeroed. The diagonal  entry is not set.
+/// @param[in] num_threads Number of threads to use for cell and facet
+///   integrals. Calls to @p mat_add are serialised.
+template <typename T>
+void assemble_matrix(
+    const std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                            const std::int32_t*, const T*)>& mat_add,
+    const AssemblyPlan<T>& plan,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs,
+    int num_threads = 1)
+{
+  const auto [dof_marker0, dof_marker1] = impl::dof_markers(plan.form(), bcs);
+  if (num_threads > 1)
+  {
+    std::mutex mutex;
+    impl::assemble_matrix<T>(impl::serialise<T>(mat_add, mutex), plan,
+                             dof_marker0, dof_marker1, num_threads);
+  }
+  else
+    impl::assemble_matrix(mat_add, plan, dof_marker0, dof_marker1);
+}
 
+/// Assemble bilinear form into a CSR matrix using a precomputed
+/// assembly plan. If the plan was created with a matrix that has the
+/// same sparsity pattern as A, cell contributions are added directly at
+/// the precomputed positions in the CSR value array. Contributions to
+/// ghost rows are not sent to the owner. Does not zero the matrix.
+/// @param[in,out] A The matrix to assemble into
+/// @param[in] plan The assembly plan for the bilinear form
+/// @param[in] bcs Boundary conditions to apply. For boundary condition
+///  dofs the row and column are zeroed. The diagonal  entry is not set.
+/// @param[in] num_threads Number of threads to use for cell and facet
+///   integrals
+template <typename T>
+void assemble_matrix(
+    la::MatrixCSR<T>& A, const AssemblyPlan<T>& plan,
+    const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs,
+    int num_threads = 1)
 {
-  impl::assemble_matrix(mat_add, a, dof_marker0, dof_marker1);
+  const auto [dof_marker0, dof_marker1] = impl::dof_markers(plan.form(), bcs);
+  impl::assemble_matrix(A, plan, dof_marker0, dof_marker1, num_threads);
 }
 
 /// Adds a value to the diagonal of a matrix for specified rows. It is
@@ -205,6 +247,176 @@ void add_diagonal(
   }
 }
 
+// -- Matrix-free action -----------------------------------------------------
+
+/// Compute the action y <- y + A x of a bilinear form without
+/// assembling the matrix A. Element tensors are computed entity by
+/// entity and applied directly to the process-local entries of x.
+/// Rows (dof_marker0) and columns (dof_marker1) with Dirichlet
+/// conditions are zeroed, as in assemble_matrix. Ghost contributions
+/// are not accumulated (not sent to owner).
+/// @param[in,out] y The owned and ghost entries of the result, indexed
+///   by the test space dofmap
+/// @param[in] a The bilinear form
+/// @param[in] x The owned and ghost entries of the vector that A is
+///   applied to, indexed by the trial space dofmap. Ghost entries must
+///   be up-to-date.
+/// @param[in] dof_marker0 Boundary condition markers for the rows
+/// @param[in] dof_marker1 Boundary condition markers for the columns
+/// @param[in] num_threads Number of threads to use for cell integrals
+template <typename T>
+void apply_matrix(
+    Eigen::Ref<Eigen::Matrix<T, Eigen::Dynamic, 1>> y, const Form<T>& a,
+    const Eigen::Ref<const Eigen::Matrix<T, Eigen::Dynamic, 1>>& x,
+    const std::vector<bool>& dof_marker0,
+    const std::vector<bool>& dof_marker1, int num_threads = 1)
+{
+  // Build a single-use plan. The form outlives the plan.
+  AssemblyPlan<T> plan(
+      std::shared_ptr<const Form<T>>(&a, [](const Form<T>*) {}));
+  if (num_threads > 1)
+    plan.create_colorings();
+  apply_matrix<T>(y, plan, x, dof_marker0, dof_marker1, num_threads);
+}
+
+/// Compute the action y <- y + A x of a bilinear form without
+/// assembling the matrix A, using a precomputed assembly plan. The
+/// packed coefficients and constants held by the plan are used. See
+/// the above function for details.
+/// @param[in,out] y The owned and ghost entries of the result, indexed
+///   by the test space dofmap
+/// @param[in] plan The assembly plan for the bilinear form
+/// @param[in] x The owned and ghost entries of the vector that A is
+///   applied to, indexed by the trial space dofmap. Ghost entries must
+///   be up-to-date.
+/// @param[in] dof_marker0 Boundary condition markers for the rows
+/// @param[in] dof_marker1 Boundary condition markers for the columns
+/// @param[in] num_threads Number of threads to use for cell and facet
+///   integrals
+template <typename T>
+void apply_matrix(
+    Eigen::Ref<Eigen::Matrix<T, Eigen::Dynamic, 1>> y,
+    const AssemblyPlan<T>& plan,
+    const Eigen::Ref<const Eigen::Matrix<T, Eigen::Dynamic, 1>>& x,
+    const std::vector<bool>& dof_marker0,
+    const std::vector<bool>& dof_marker1, int num_threads = 1)
+{
+  // Rows touched by concurrently executed cells are disjoint, so
+  // accumulating into y is safe when num_threads > 1
+  auto mat_vec
+      = [&y, &x](std::int32_t nrows, const std::int32_t* rows,
+                 std::int32_t ncols, const std::int32_t* cols, const T* vals) {
+          for (std::int32_t i = 0; i < nrows; ++i)
+          {
+            T yi = 0;
+            for (std::int32_t j = 0; j < ncols; ++j)
+              yi += vals[i * ncols + j] * x[cols[j]];
+            y[rows[i]] += yi;
+          }
+          return 0;
+        };
+  impl::assemble_matrix<T>(mat_vec, plan, dof_marker0, dof_marker1,
+                           num_threads);
+}
+
+/// Compute the diagonal d <- d + diag(A) of a bilinear form without
+/// assembling the matrix A, e.g. for Jacobi preconditioning of a
+/// matrix-free operator. The test and trial spaces must share a
+/// dofmap. Ghost contributions are not accumulated (not sent to owner).
+/// @param[in,out] d The owned and ghost entries of the diagonal
+/// @param[in] a The bilinear form
+/// @param[in] dof_marker0 Boundary condition markers for the rows
+/// @param[in] dof_marker1 Boundary condition markers for the columns
+template <typename T>
+void assemble_diagonal(Eigen::Ref<Eigen::Matrix<T, Eigen::Dynamic, 1>> d,
+                       const Form<T>& a, const std::vector<bool>& dof_marker0,
+                       const std::vector<bool>& dof_marker1)
+{
+  const AssemblyPlan<T> plan(
+      std::shared_ptr<const Form<T>>(&a, [](const Form<T>*) {}));
+  assemble_diagonal<T>(d, plan, dof_marker0, dof_marker1);
+}
+
+/// Compute the diagonal d <- d + diag(A) of a bilinear form without
+/// assembling the matrix A, using a precomputed assembly plan. See the
+/// above function for details.
+/// @param[in,out] d The owned and ghost entries of the diagonal
+/// @param[in] plan The assembly plan for the bilinear form
+/// @param[in] dof_marker0 Boundary condition markers for the rows
+/// @param[in] dof_marker1 Boundary condition markers for the columns
+template <typename T>
+void assemble_diagonal(Eigen::Ref<Eigen::Matrix<T, Eigen::Dynamic, 1>> d,
+                       const AssemblyPlan<T>& plan,
+                       const std::vector<bool>& dof_marker0,
+                       const std::vector<bool>& dof_marker1)
+{
+  auto mat_diag = [&d](std::int32_t nrows, const std::int32_t* rows,
+                       std::int32_t ncols, const std::int32_t* cols,
+                       const T* vals) {
+    for (std::int32_t i = 0; i < nrows; ++i)
+      for (std::int32_t j = 0; j < ncols; ++j)
+        if (rows[i] == cols[j])
+          d[rows[i]] += vals[i * ncols + j];
+    return 0;
+  };
+  impl::assemble_matrix<T>(mat_diag, plan, dof_marker0, dof_marker1);
+}
+
+/// Compute the action y = A x of a bilinear form on a distributed
+/// vector without assembling A. Ghost entries of x are updated before
+/// the action is computed, and ghost contributions to y are sent to
+/// the owning process. Rows and columns with Dirichlet conditions are
+/// zeroed, and diagonal * x is added to locally owned rows with a
+/// condition on the test space, which mirrors assemble_matrix followed
+/// by add_diagonal.
+/// @param[in,out] y The result. Ghost entries are not updated.
+/// @param[in] a The bilinear form
+/// @param[in,out] x The vector to which A is applied. Its ghost entries
+///   are updated.
+/// @param[in] bcs Dirichlet boundary conditions
+/// @param[in] diagonal The value on the diagonal of Dirichlet rows
+/// @param[in] num_threads Number of threads to use for cell integrals
+template <typename T>
+void apply_matrix(la::Vector<T>& y, const Form<T>& a, la::Vector<T>& x,
+                  const std::vector<std::shared_ptr<const DirichletBC<T>>>& bcs,
+                  T diagonal = 1.0, int num_threads = 1)
+{
+  // Build dof markers
+  std::vector<bool> dof_marker0, dof_marker1;
+  for (const std::shared_ptr<const DirichletBC<T>>& bc : bcs)
+  {
+    assert(bc);
+    assert(bc->function_space());
+    if (a.function_space(0)->contains(*bc->function_space()))
+    {
+      dof_marker0.resize(y.array().size(), false);
+      bc->mark_dofs(dof_marker0);
+    }
+    if (a.function_space(1)->contains(*bc->function_space()))
+    {
+      dof_marker1.resize(x.array().size(), false);
+      bc->mark_dofs(dof_marker1);
+    }
+  }
+
+  x.scatter_fwd();
+  y.array().setZero();
+  apply_matrix<T>(y.array(), a, x.array(), dof_marker0, dof_marker1,
+                  num_threads);
+  y.scatter_rev(common::IndexMap::Mode::add);
+
+  for (const std::shared_ptr<const DirichletBC<T>>& bc : bcs)
+  {
+    if (a.function_space(0)->contains(*bc->function_space()))
+    {
+      const auto rows = bc->dofs_owned().col(0);
+      for (Eigen::Index i = 0; i < rows.rows(); ++i)
+        y.array()[rows[i]] += diagonal * x.array()[rows[i]];
+    }
+  }
+  y.mark_modified();
+}
+
 // -- Setting bcs ------------------------------------------------------------
 
 // FIXME: Move these function elsewhere?
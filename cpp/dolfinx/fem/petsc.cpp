@@ -7,11 +7,131 @@
 #include "petsc.h"
 #include "SparsityPatternBuilder.h"
 #include "assembler.h"
+#include <dolfinx/common/log.h>
 #include <dolfinx/function/FunctionSpace.h>
 #include <dolfinx/la/SparsityPattern.h>
+#include <dolfinx/la/Vector.h>
 
 using namespace dolfinx;
 
+namespace
+{
+// Data attached to a matrix-free (MATSHELL) operator
+struct MatrixFreeContext
+{
+  // Assembly plan for the form. Coefficients whose values have changed
+  // are repacked before each use.
+  fem::AssemblyPlan<PetscScalar> plan;
+  std::vector<std::shared_ptr<const fem::DirichletBC<PetscScalar>>> bcs;
+  PetscScalar diagonal;
+
+  // Boundary condition markers for the rows and columns
+  std::vector<bool> bc0, bc1;
+
+  // Work vectors, including ghost entries, for the test (y) and trial
+  // (x) spaces
+  la::Vector<PetscScalar> y, x;
+};
+//-----------------------------------------------------------------------------
+PetscErrorCode matrix_free_mult(Mat A, Vec x, Vec y)
+{
+  MatrixFreeContext* ctx = nullptr;
+  MatShellGetContext(A, &ctx);
+  assert(ctx);
+
+  // Exceptions must not propagate into PETSc
+  try
+  {
+    PetscInt n = 0;
+    VecGetLocalSize(x, &n);
+    const PetscScalar* _x = nullptr;
+    VecGetArrayRead(x, &_x);
+    std::copy(_x, _x + n, ctx->x.array().data());
+    VecRestoreArrayRead(x, &_x);
+
+    // Compute y = A x, and add diagonal * x for Dirichlet rows as
+    // fem::apply_matrix does
+    ctx->plan.update_changed_coefficients();
+    ctx->x.scatter_fwd();
+    ctx->y.array().setZero();
+    fem::apply_matrix<PetscScalar>(ctx->y.array(), ctx->plan,
+                                   ctx->x.array(), ctx->bc0, ctx->bc1);
+    ctx->y.scatter_rev(common::IndexMap::Mode::add);
+    const fem::Form<PetscScalar>& a = ctx->plan.form();
+    for (const auto& bc : ctx->bcs)
+    {
+      if (a.function_space(0)->contains(*bc->function_space()))
+      {
+        const auto rows = bc->dofs_owned().col(0);
+        for (Eigen::Index i = 0; i < rows.rows(); ++i)
+          ctx->y.array()[rows[i]] += ctx->diagonal * ctx->x.array()[rows[i]];
+      }
+    }
+
+    VecGetLocalSize(y, &n);
+    PetscScalar* _y = nullptr;
+    VecGetArray(y, &_y);
+    std::copy(ctx->y.array().data(), ctx->y.array().data() + n, _y);
+    VecRestoreArray(y, &_y);
+  }
+  catch (const std::exception& e)
+  {
+    LOG(ERROR) << "Matrix-free MatMult failed: " << e.what();
+    return PETSC_ERR_LIB;
+  }
+
+  return 0;
+}
+//-----------------------------------------------------------------------------
+PetscErrorCode matrix_free_get_diagonal(Mat A, Vec d)
+{
+  MatrixFreeContext* ctx = nullptr;
+  MatShellGetContext(A, &ctx);
+  assert(ctx);
+
+  try
+  {
+    la::Vector<PetscScalar>& _d = ctx->y;
+    _d.array().setZero();
+    ctx->plan.update_changed_coefficients();
+    fem::assemble_diagonal<PetscScalar>(_d.array(), ctx->plan, ctx->bc0,
+                                        ctx->bc1);
+    _d.scatter_rev(common::IndexMap::Mode::add);
+    for (const auto& bc : ctx->bcs)
+    {
+      if (ctx->plan.form().function_space(0)->contains(*bc->function_space()))
+      {
+        const auto rows = bc->dofs_owned().col(0);
+        for (Eigen::Index i = 0; i < rows.rows(); ++i)
+          _d.array()[rows[i]] += ctx->diagonal;
+      }
+    }
+
+    PetscInt n = 0;
+    VecGetLocalSize(d, &n);
+    PetscScalar* array = nullptr;
+    VecGetArray(d, &array);
+    std::copy(_d.array().data(), _d.array().data() + n, array);
+    VecRestoreArray(d, &array);
+  }
+  catch (const std::exception& e)
+  {
+    LOG(ERROR) << "Matrix-free MatGetDiagonal failed: " << e.what();
+    return PETSC_ERR_LIB;
+  }
+
+  return 0;
+}
+//-----------------------------------------------------------------------------
+PetscErrorCode matrix_free_destroy(Mat A)
+{
+  MatrixFreeContext* ctx = nullptr;
+  MatShellGetContext(A, &ctx);
+  delete ctx;
+  return 0;
+}
+} // namespace
+
 //-----------------------------------------------------------------------------
 la::PETScMatrix dolfinx::fem::create_matrix(const Form<PetscScalar>& a)
 {
@@ -188,6 +308,65 @@ la::PETScMatrix fem::create_matrix_nest(
   return la::PETScMatrix(_A);
 }
 //-----------------------------------------------------------------------------
+la::PETScOperator fem::create_matrix_free(
+    std::shared_ptr<const Form<PetscScalar>> a,
+    const std::vector<std::shared_ptr<const DirichletBC<PetscScalar>>>& bcs,
+    PetscScalar diagonal)
+{
+  assert(a);
+  if (a->rank() != 2)
+    throw std::runtime_error("Matrix-free operator requires a bilinear form.");
+
+  std::shared_ptr<const common::IndexMap> map0
+      = a->function_space(0)->dofmap()->index_map;
+  std::shared_ptr<const common::IndexMap> map1
+      = a->function_space(1)->dofmap()->index_map;
+  assert(map0);
+  assert(map1);
+
+  auto ctx = std::make_unique<MatrixFreeContext>(
+      MatrixFreeContext{fem::AssemblyPlan<PetscScalar>(a), bcs, diagonal, {},
+                        {}, la::Vector<PetscScalar>(map0),
+                        la::Vector<PetscScalar>(map1)});
+
+  // Build dof markers once, used for each product and the diagonal
+  for (const auto& bc : bcs)
+  {
+    assert(bc);
+    if (a->function_space(0)->contains(*bc->function_space()))
+    {
+      ctx->bc0.resize(ctx->y.array().size(), false);
+      bc->mark_dofs(ctx->bc0);
+    }
+    if (a->function_space(1)->contains(*bc->function_space()))
+    {
+      ctx->bc1.resize(ctx->x.array().size(), false);
+      bc->mark_dofs(ctx->bc1);
+    }
+  }
+
+  Mat A = nullptr;
+  PetscErrorCode ierr = MatCreateShell(
+      a->mesh()->mpi_comm(), map0->block_size() * map0->size_local(),
+      map1->block_size() * map1->size_local(), PETSC_DETERMINE,
+      PETSC_DETERMINE, ctx.get(), &A);
+  if (ierr != 0)
+    la::petsc_error(ierr, __FILE__, "MatCreateShell");
+
+  // The context is owned by the Mat from here on and freed by
+  // matrix_free_destroy
+  ctx.release();
+  MatShellSetOperation(A, MATOP_MULT, (void (*)(void))matrix_free_mult);
+  MatShellSetOperation(A, MATOP_DESTROY, (void (*)(void))matrix_free_destroy);
+  if (*a->function_space(0) == *a->function_space(1))
+  {
+    MatShellSetOperation(A, MATOP_GET_DIAGONAL,
+                         (void (*)(void))matrix_free_get_diagonal);
+  }
+
+  return la::PETScOperator(A, false);
+}
+//-----------------------------------------------------------------------------
 la::PETScVector fem::create_vector_block(
     const std::vector<std::reference_wrapper<const common::IndexMap>>& maps)
 {
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <dolfinx/la/PETScMatrix.h>
+#include <dolfinx/la/PETScOperator.h>
 #include <dolfinx/la/PETScVector.h>
 #include <memory>
 #include <petscvec.h>
@@ -44,6 +45,25 @@ la::PETScMatrix create_matrix_nest(
         const Eigen::Array<const fem::Form<PetscScalar>*, Eigen::Dynamic,
                            Eigen::Dynamic, Eigen::RowMajor>>& a);
 
+/// Create a matrix-free operator (PETSc MATSHELL) for a bilinear form.
+/// The matrix is never assembled. Each MatMult computes y = A x cell by
+/// cell using fem::apply_matrix, with ghost entries updated via the
+/// dofmap index maps. An assembly plan and the boundary condition
+/// markers are built once, and coefficients whose values have changed
+/// are repacked before each product. If the test and trial spaces are the same,
+/// MatGetDiagonal is also supported, e.g. for Jacobi preconditioning.
+/// Dirichlet conditions are applied as by assemble_matrix followed by
+/// add_diagonal. The operator can be passed to PETScKrylovSolver.
+/// @param[in] a The bilinear form. The operator holds a pointer to the
+///   form, so changes to coefficients are seen by subsequent products.
+/// @param[in] bcs Dirichlet boundary conditions
+/// @param[in] diagonal The value on the diagonal of Dirichlet rows
+/// @return The matrix-free operator
+la::PETScOperator create_matrix_free(
+    std::shared_ptr<const Form<PetscScalar>> a,
+    const std::vector<std::shared_ptr<const DirichletBC<PetscScalar>>>& bcs,
+    PetscScalar diagonal = 1.0);
+
 /// Initialise monolithic vector. Vector is not zeroed.
 la::PETScVector create_vector_block(
     const std::vector<std::reference_wrapper<const common::IndexMap>>& maps);
@@ -16,6 +16,7 @@
 #include <dolfinx/fem/FiniteElement.h>
 #include <dolfinx/fem/Form.h>
 #include <dolfinx/fem/SparsityPatternBuilder.h>
+#include <dolfinx/graph/BoostGraphColoring.h>
 #include <dolfinx/function/Constant.h>
 #include <dolfinx/function/Function.h>
 #include <dolfinx/function/FunctionSpace.h>
@@ -24,6 +25,7 @@
 #include <dolfinx/mesh/Topology.h>
 #include <dolfinx/mesh/TopologyComputation.h>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <ufc.h>
 
@@ -259,3 +261,71 @@ fem::create_functionspace(ufc_function_space* (*fptr)(const char*),
   return V;
 }
 //-----------------------------------------------------------------------------
+std::vector<std::vector<std::int32_t>>
+fem::color_cells(const std::vector<std::int32_t>& cells,
+                 const graph::AdjacencyList<std::int32_t>& dofmap)
+{
+  common::Timer timer("Color cells by shared dofs");
+
+  if (cells.empty())
+    return {};
+
+  // Build map from dof to (position of) cells in the cell list
+  const Eigen::Array<std::int32_t, Eigen::Dynamic, 1>& dofs = dofmap.array();
+  const std::int32_t num_dofs = dofs.size() > 0 ? dofs.maxCoeff() + 1 : 0;
+  std::vector<std::int32_t> dof_offsets(num_dofs + 1, 0);
+  for (std::int32_t c : cells)
+  {
+    auto cell_dofs = dofmap.links(c);
+    for (Eigen::Index i = 0; i < cell_dofs.rows(); ++i)
+      ++dof_offsets[cell_dofs[i] + 1];
+  }
+  std::partial_sum(dof_offsets.begin(), dof_offsets.end(),
+                   dof_offsets.begin());
+  std::vector<std::int32_t> dof_to_cell(dof_offsets.back());
+  std::vector<std::int32_t> pos(dof_offsets.begin(), dof_offsets.end() - 1);
+  for (std::size_t i = 0; i < cells.size(); ++i)
+  {
+    auto cell_dofs = dofmap.links(cells[i]);
+    for (Eigen::Index j = 0; j < cell_dofs.rows(); ++j)
+      dof_to_cell[pos[cell_dofs[j]]++] = i;
+  }
+
+  // Build graph where cells (vertices) are connected if they share a
+  // dof
+  std::vector<std::int32_t> graph_data, graph_offsets(1, 0);
+  std::vector<std::int32_t> marker(cells.size(), -1);
+  for (std::size_t i = 0; i < cells.size(); ++i)
+  {
+    auto cell_dofs = dofmap.links(cells[i]);
+    for (Eigen::Index j = 0; j < cell_dofs.rows(); ++j)
+    {
+      const std::int32_t dof = cell_dofs[j];
+      for (std::int32_t k = dof_offsets[dof]; k < dof_offsets[dof + 1]; ++k)
+      {
+        const std::int32_t nbr = dof_to_cell[k];
+        if (nbr != (std::int32_t)i and marker[nbr] != (std::int32_t)i)
+        {
+          marker[nbr] = i;
+          graph_data.push_back(nbr);
+        }
+      }
+    }
+    graph_offsets.push_back(graph_data.size());
+  }
+  const graph::AdjacencyList<std::int32_t> graph(graph_data, graph_offsets);
+
+  // Color graph
+  std::vector<int> colors;
+  const std::size_t num_colors
+      = graph::BoostGraphColoring::compute_local_vertex_coloring(graph,
+                                                                 colors);
+
+  // Group cells by color
+  std::vector<std::vector<std::int32_t>> colored_cells(num_colors);
+  for (std::size_t i = 0; i < cells.size(); ++i)
+    colored_cells[colors[i]].push_back(cells[i]);
+
+  return colored_cells;
+}
+//-----------------------------------------------------------------------------
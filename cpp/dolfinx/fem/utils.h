@@ -10,13 +10,21 @@
 #include "DofMap.h"
 #include "ElementDofLayout.h"
 #include <dolfinx/common/types.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/fem/Form.h>
 #include <dolfinx/function/Function.h>
 #include <dolfinx/la/SparsityPattern.h>
 #include <dolfinx/mesh/cell_types.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <ufc.h>
 #include <utility>
 #include <vector>
@@ -307,22 +315,134 @@ create_functionspace(ufc_function_space* (*fptr)(const char*),
                      const std::string function_name,
                      std::shared_ptr<mesh::Mesh> mesh);
 
+/// Partition a list of cells into groups ('colors') such that no two
+/// cells in the same group share a degree-of-freedom. Cells in the same
+/// group can be assembled concurrently without write conflicts.
+/// @param[in] cells The cells to color
+/// @param[in] dofmap The cell dofmap (cell -> dofs)
+/// @return List of cells for each color. The cells for each color
+///   preserve the input order.
+std::vector<std::vector<std::int32_t>>
+color_cells(const std::vector<std::int32_t>& cells,
+            const graph::AdjacencyList<std::int32_t>& dofmap);
+
+/// Execute a function on each group of cells in @p colors. Each group
+/// is split into @p num_threads contiguous blocks, and the blocks are
+/// processed concurrently. Groups are processed one after the other.
+/// The threads are started once and wait for each other between
+/// groups. If @p fn throws, the remaining groups are skipped and the
+/// first exception is rethrown on the calling thread after all threads
+/// have been joined.
+/// @param[in] colors Groups of cells, e.g. computed by
+///   fem::color_cells
+/// @param[in] num_threads Number of threads
+/// @param[in] fn The function to execute. It is called as fn(thread,
+///   cells), where thread is the thread number in [0, num_threads) and
+///   cells is the block of cells to process
+template <typename Fn>
+void parallel_for_colors(const std::vector<std::vector<std::int32_t>>& colors,
+                         int num_threads, const Fn& fn)
+{
+  assert(num_threads > 0);
+
+  // Barrier between colors, and the first exception thrown
+  std::mutex mutex;
+  std::condition_variable cv;
+  int num_participants = num_threads, num_waiting = 0, generation = 0;
+  std::exception_ptr error;
+  std::atomic<bool> failed(false);
+  auto barrier = [&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    const int gen = generation;
+    if (++num_waiting == num_participants)
+    {
+      num_waiting = 0;
+      ++generation;
+      cv.notify_all();
+    }
+    else
+      cv.wait(lock, [&]() { return gen != generation; });
+  };
+
+  // Process block t of each color
+  auto work = [&](int t) {
+    std::vector<std::int32_t> block;
+    for (std::size_t c = 0; c < colors.size(); ++c)
+    {
+      if (!failed)
+      {
+        try
+        {
+          const std::vector<std::int32_t>& cells = colors[c];
+          const std::size_t block_size = cells.size() / num_threads;
+          const std::size_t remainder = cells.size() % num_threads;
+          const std::size_t pos
+              = t * block_size + std::min<std::size_t>(t, remainder);
+          const std::size_t size = block_size + (t < (int)remainder ? 1 : 0);
+          block.assign(cells.begin() + pos, cells.begin() + pos + size);
+          fn(t, block);
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (!error)
+            error = std::current_exception();
+          failed = true;
+        }
+      }
+      if (c + 1 < colors.size())
+        barrier();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  try
+  {
+    for (int t = 1; t < num_threads; ++t)
+      threads.emplace_back(work, t);
+  }
+  catch (...)
+  {
+    // Threads that were not started do not take part in the barrier.
+    // The calling thread has not arrived yet, so no waiting thread
+    // needs to be released.
+    std::lock_guard<std::mutex> lock(mutex);
+    error = std::current_exception();
+    failed = true;
+    num_participants = threads.size() + 1;
+  }
+
+  // Process first block on the calling thread
+  work(0);
+  for (std::thread& t : threads)
+    t.join();
+  if (error)
+    std::rethrow_exception(error);
+}
+
 // NOTE: This is subject to change
-/// Pack form coefficients ready for assembly
+/// Pack form coefficients ready for assembly into an existing array.
+/// Only the coefficients flagged in @p pack are copied, which allows
+/// the values of unchanged coefficients to be kept between assemblies.
+/// If @p c does not have the correct shape it is resized and all
+/// coefficients are packed. The cells are split into @p num_threads
+/// contiguous blocks that are packed concurrently.
+/// @param[in] form The form
+/// @param[in,out] c The packed coefficients, one row per cell
+/// @param[in] pack Flag for each coefficient of the form that is true
+///   if the coefficient should be packed
+/// @param[in] num_threads Number of threads
 template <typename T>
-Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
-pack_coefficients(const fem::Form<T>& form)
+void pack_coefficients(
+    const fem::Form<T>& form,
+    Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>& c,
+    const std::vector<bool>& pack, int num_threads = 1)
 {
   // Get form coefficient offsets amd dofmaps
   const fem::FormCoefficients<T>& coefficients = form.coefficients();
   const std::vector<int>& offsets = coefficients.offsets();
-  std::vector<const fem::DofMap*> dofmaps(coefficients.size());
-  std::vector<Eigen::Ref<const Eigen::Matrix<T, Eigen::Dynamic, 1>>> v;
-  for (int i = 0; i < coefficients.size(); ++i)
-  {
-    dofmaps[i] = coefficients.get(i)->function_space()->dofmap().get();
-    v.emplace_back(coefficients.get(i)->x()->array());
-  }
+  if ((int)pack.size() != coefficients.size())
+    throw std::runtime_error("Wrong number of coefficient flags.");
 
   // Get mesh
   std::shared_ptr<const mesh::Mesh> mesh = form.mesh();
@@ -332,24 +452,54 @@ pack_coefficients(const fem::Form<T>& form)
       = mesh->topology().index_map(tdim)->size_local()
         + mesh->topology().index_map(tdim)->num_ghosts();
 
-  // Copy data into coefficient array
-  Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> c(
-      num_cells, offsets.back());
-  if (coefficients.size() > 0)
+  const bool resize = c.rows() != num_cells or c.cols() != offsets.back();
+  if (resize)
+    c.resize(num_cells, offsets.back());
+
+  std::vector<int> coeffs;
+  std::vector<const fem::DofMap*> dofmaps;
+  std::vector<const T*> v;
+  for (int i = 0; i < coefficients.size(); ++i)
   {
-    for (int cell = 0; cell < num_cells; ++cell)
+    if (resize or pack[i])
     {
-      for (std::size_t coeff = 0; coeff < dofmaps.size(); ++coeff)
-      {
-        auto dofs = dofmaps[coeff]->cell_dofs(cell);
-        const Eigen::Ref<const Eigen::Matrix<T, Eigen::Dynamic, 1>>& _v
-            = v[coeff];
-        for (Eigen::Index k = 0; k < dofs.size(); ++k)
-          c(cell, k + offsets[coeff]) = _v[dofs[k]];
-      }
+      std::shared_ptr<const function::Function<T>> u = coefficients.get(i);
+      coeffs.push_back(i);
+      dofmaps.push_back(u->function_space()->dofmap().get());
+      v.push_back(u->x()->array().data());
     }
   }
+  if (coeffs.empty())
+    return;
+
+  // Copy data into coefficient array. Each thread fills a block of rows.
+  common::parallel_for(
+      num_cells, num_threads,
+      [&](int, std::int32_t begin, std::int32_t end) {
+        for (std::int32_t cell = begin; cell < end; ++cell)
+        {
+          T* c_cell = c.row(cell).data();
+          for (std::size_t i = 0; i < coeffs.size(); ++i)
+          {
+            auto dofs = dofmaps[i]->cell_dofs(cell);
+            T* _c = c_cell + offsets[coeffs[i]];
+            const T* _v = v[i];
+            for (Eigen::Index k = 0; k < dofs.size(); ++k)
+              _c[k] = _v[dofs[k]];
+          }
+        }
+      });
+}
 
+// NOTE: This is subject to change
+/// Pack form coefficients ready for assembly
+template <typename T>
+Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+pack_coefficients(const fem::Form<T>& form)
+{
+  Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> c;
+  pack_coefficients(form, c,
+                    std::vector<bool>(form.coefficients().size(), true));
   return c;
 }
 
@@ -0,0 +1,251 @@
+// Copyright (C) 2020 agent
+//
+// This file is part of DOLFINX (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "FunctionSpace.h"
+#include <Eigen/Dense>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/Timer.h>
+#include <dolfinx/fem/DofMap.h>
+#include <dolfinx/fem/FiniteElement.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace dolfinx::function
+{
+
+template <typename T>
+class Function;
+
+/// This class interpolates expressions into a function space. The
+/// interpolation points, i.e. the physical coordinates of the dofs,
+/// and for mixed elements the position of each dof value in the
+/// expression values, are computed once when the object is created.
+/// Repeated interpolation, e.g. of time-dependent boundary or source
+/// terms, then only evaluates the expression at all points in one call
+/// and copies the values.
+///
+/// The interpolation points are not updated if the mesh geometry is
+/// changed after the object is created.
+
+template <typename T>
+class ExpressionInterpolation
+{
+public:
+  /// Compute the interpolation points of a function space
+  /// @param[in] V The function space
+  explicit ExpressionInterpolation(std::shared_ptr<const FunctionSpace> V)
+      : _V(V)
+  {
+    assert(_V);
+    common::Timer timer("Compute interpolation points");
+    _x = _V->tabulate_scalar_subspace_dof_coordinates().transpose();
+
+    std::shared_ptr<const fem::FiniteElement> element = _V->element();
+    assert(element);
+    _value_size = 1;
+    for (int i = 0; i < element->value_rank(); ++i)
+      _value_size *= element->value_dimension(i);
+
+    if (element->family() == "Mixed")
+    {
+      // Compute the position of the value of each dof in the
+      // (value_size, num_points) array of expression values, extracting
+      // the correct components for each subelement
+      std::shared_ptr<const mesh::Mesh> mesh = _V->mesh();
+      assert(mesh);
+      const int tdim = mesh->topology().dim();
+      auto map = mesh->topology().index_map(tdim);
+      assert(map);
+      const std::int32_t num_cells = map->size_local() + map->num_ghosts();
+      std::shared_ptr<const fem::DofMap> dofmap = _V->dofmap();
+      assert(dofmap);
+      const std::int32_t num_points = _x.cols();
+
+      _mixed_positions.resize(_x.cols());
+      int value_offset = 0;
+      for (int i = 0; i < element->num_sub_elements(); ++i)
+      {
+        const std::vector<int> component = {i};
+        const fem::DofMap sub_dofmap = dofmap->extract_sub_dofmap(component);
+        std::shared_ptr<const fem::FiniteElement> sub_element
+            = element->extract_sub_element(component);
+        const int element_block_size = sub_element->block_size();
+        for (std::int32_t cell = 0; cell < num_cells; ++cell)
+        {
+          const auto cell_dofs = sub_dofmap.cell_dofs(cell);
+          const int scalar_dofs = cell_dofs.rows() / element_block_size;
+          for (int dof = 0; dof < scalar_dofs; ++dof)
+          {
+            const std::int32_t col = cell_dofs[element_block_size * dof];
+            for (int b = 0; b < element_block_size; ++b)
+            {
+              _mixed_positions[cell_dofs[element_block_size * dof + b]]
+                  = (value_offset + b) * num_points + col;
+            }
+          }
+        }
+        value_offset += element_block_size;
+      }
+      _num_mixed_values = value_offset;
+    }
+  }
+
+  /// Copy constructor
+  ExpressionInterpolation(const ExpressionInterpolation& op) = default;
+
+  /// Move constructor
+  ExpressionInterpolation(ExpressionInterpolation&& op) = default;
+
+  /// Destructor
+  ~ExpressionInterpolation() = default;
+
+  /// Interpolate an expression
+  /// @param[in,out] u The function to interpolate into
+  /// @param[in] f The expression to be interpolated. It is called once
+  ///   with all interpolation points (shape=(3, num_points)) and returns
+  ///   the values (shape=(value_size, num_points)).
+  void interpolate(
+      Function<T>& u,
+      const std::function<
+          Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>(
+              const Eigen::Ref<const Eigen::Array<double, 3, Eigen::Dynamic,
+                                                  Eigen::RowMajor>>&)>& f)
+      const
+  {
+    check_space(u);
+
+    // Evaluate expression at dof points
+    const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+        values = f(_x);
+
+    Eigen::Matrix<T, Eigen::Dynamic, 1>& coefficients = u.x()->array();
+    if (!_mixed_positions.empty())
+    {
+      if (values.rows() < _num_mixed_values or values.cols() != _x.cols())
+        throw std::runtime_error("Values shape is incorrect.");
+      for (std::size_t i = 0; i < _mixed_positions.size(); ++i)
+        coefficients[i] = values.data()[_mixed_positions[i]];
+      u.x()->mark_modified();
+      return;
+    }
+
+    // Note: pybind11 maps 1D NumPy arrays to column vectors for
+    // Eigen::Array<T, Eigen::Dynamic,Eigen::Dynamic, Eigen::RowMajor>
+    // types, therefore we need to handle vectors as a special case.
+    if (values.cols() == 1 and values.rows() != 1)
+    {
+      if (values.rows() != _x.cols())
+      {
+        throw std::runtime_error("Number of computed values is not equal to "
+                                 "the number of evaluation points. (1)");
+      }
+      coefficients = Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>>(
+          values.data(), coefficients.rows());
+    }
+    else
+    {
+      if (values.rows() != _value_size)
+        throw std::runtime_error("Values shape is incorrect. (2)");
+      if (values.cols() != _x.cols())
+      {
+        throw std::runtime_error("Number of computed values is not equal to "
+                                 "the number of evaluation points. (2)");
+      }
+
+      const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+          values_t = values.transpose();
+      coefficients = Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>>(
+          values_t.data(), coefficients.rows());
+    }
+    u.x()->mark_modified();
+  }
+
+  /// Interpolate an expression f(x) that has an in/out argument for the
+  /// expression values. It is primarily to support C code
+  /// implementations of the expression, e.g. using Numba.
+  /// @param[in,out] u The function to interpolate into
+  /// @param[in] f The expression to be interpolated. It is called once
+  ///   with the coordinates of each dof (shape=(num_dofs, 3)) and fills
+  ///   the values (shape=(num_dofs, value_size)).
+  void interpolate_c(
+      Function<T>& u,
+      const std::function<void(
+          Eigen::Ref<Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic,
+                                  Eigen::RowMajor>>,
+          const Eigen::Ref<const Eigen::Array<double, Eigen::Dynamic, 3,
+                                              Eigen::RowMajor>>&)>& f) const
+  {
+    check_space(u);
+
+    // Repeat the coordinates of each point for each dof in a block
+    std::shared_ptr<const fem::FiniteElement> element = _V->element();
+    assert(element);
+    const int bs = element->block_size();
+    Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor> x(
+        _x.cols() * bs, 3);
+    for (Eigen::Index p = 0; p < _x.cols(); ++p)
+      for (int j = 0; j < bs; ++j)
+        x.row(p * bs + j) = _x.col(p).transpose();
+
+    Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> values(
+        x.rows(), _value_size);
+    f(values, x);
+
+    Eigen::Matrix<T, Eigen::Dynamic, 1>& coefficients = u.x()->array();
+    coefficients = Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>>(
+        values.data(), coefficients.rows());
+    u.x()->mark_modified();
+  }
+
+  /// The function space
+  std::shared_ptr<const FunctionSpace> function_space() const { return _V; }
+
+  /// The interpolation points (shape=(3, num_points)), one for each
+  /// (local and ghost) dof of the scalar subspace
+  const Eigen::Array<double, 3, Eigen::Dynamic, Eigen::RowMajor>&
+  points() const
+  {
+    return _x;
+  }
+
+private:
+  // Check that a function is in the function space
+  void check_space(const Function<T>& u) const
+  {
+    assert(u.function_space());
+    if (*u.function_space() != *_V)
+    {
+      throw std::runtime_error(
+          "Function is not in the interpolation function space.");
+    }
+  }
+
+  // The function space
+  std::shared_ptr<const FunctionSpace> _V;
+
+  // Interpolation points
+  Eigen::Array<double, 3, Eigen::Dynamic, Eigen::RowMajor> _x;
+
+  // Number of values of the expression at each point
+  int _value_size;
+
+  // Position of the value of each dof in the expression values for
+  // mixed elements, and the number of values used. Empty for other
+  // elements.
+  std::vector<std::int64_t> _mixed_positions;
+  int _num_mixed_values = 0;
+};
+
+} // namespace dolfinx::function
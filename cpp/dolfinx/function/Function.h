@@ -8,12 +8,15 @@
 
 #include "FunctionSpace.h"
 #include "interpolate.h"
+#include "utils.h"
 #include <Eigen/Dense>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/UniqueIdGenerator.h>
 #include <dolfinx/common/types.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/fem/DofMap.h>
 #include <dolfinx/fem/FiniteElement.h>
+#include <dolfinx/geometry/PointOwnership.h>
 #include <dolfinx/la/PETScVector.h>
 #include <dolfinx/la/Vector.h>
 #include <dolfinx/mesh/Geometry.h>
@@ -23,6 +26,7 @@
 #include <memory>
 #include <petscvec.h>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace dolfinx::function
@@ -119,7 +123,8 @@ public:
         function_space_new->dofmap()->index_map);
 
     // Copy values into new vector
-    const Eigen::Matrix<T, Eigen::Dynamic, 1>& x_old = _x->array();
+    const Eigen::Matrix<T, Eigen::Dynamic, 1>& x_old
+        = std::as_const(*_x).array();
     Eigen::Matrix<T, Eigen::Dynamic, 1>& x_new = vector_new->array();
     for (std::size_t i = 0; i < collapsed_map.size(); ++i)
     {
@@ -192,7 +197,8 @@ public:
     function::interpolate(*this, f);
   }
 
-  /// Evaluate the Function at points
+  /// Evaluate the Function at points. Points in the same cell are
+  /// evaluated together, and need not be ordered by cell.
   ///
   /// @param[in] x The coordinates of the points. It has shape
   ///   (num_points, 3).
@@ -210,9 +216,6 @@ public:
            Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
            u) const
   {
-    // TODO: This could be easily made more efficient by exploiting points
-    // being ordered by the cell to which they belong.
-
     if (x.rows() != cells.rows())
     {
       throw std::runtime_error(
@@ -225,109 +228,77 @@ public:
           "same as the number of points.");
     }
 
-    // Get mesh
-    assert(_function_space);
-    std::shared_ptr<const mesh::Mesh> mesh = _function_space->mesh();
-    assert(mesh);
-    const int gdim = mesh->geometry().dim();
-    const int tdim = mesh->topology().dim();
-
-    // Get geometry data
-    const graph::AdjacencyList<std::int32_t>& x_dofmap
-        = mesh->geometry().dofmap();
-
-    // FIXME: Add proper interface for num coordinate dofs
-    const int num_dofs_g = x_dofmap.num_links(0);
-    const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& x_g
-        = mesh->geometry().x();
-    Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
-        coordinate_dofs(num_dofs_g, gdim);
-
-    // Get coordinate map
-    const fem::CoordinateElement& cmap = mesh->geometry().cmap();
-
     // Get element
     assert(_function_space->element());
     std::shared_ptr<const fem::FiniteElement> element
         = _function_space->element();
     assert(element);
     const int block_size = element->block_size();
-    const int reference_value_size
-        = element->reference_value_size() / block_size;
     const int value_size = element->value_size() / block_size;
     const int space_dimension = element->space_dimension() / block_size;
 
-    // Prepare geometry data structures
-    Eigen::Tensor<double, 3, Eigen::RowMajor> J(1, gdim, tdim);
-    Eigen::Array<double, Eigen::Dynamic, 1> detJ(1);
-    Eigen::Tensor<double, 3, Eigen::RowMajor> K(1, tdim, gdim);
-    Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> X(
-        1, tdim);
-
-    // Prepare basis function data structures
-    Eigen::Tensor<double, 3, Eigen::RowMajor> basis_reference_values(
-        1, space_dimension, reference_value_size);
-    Eigen::Tensor<double, 3, Eigen::RowMajor> basis_values(1, space_dimension,
-                                                           value_size);
-
-    // Create work vector for expansion coefficients
-    Eigen::Matrix<T, 1, Eigen::Dynamic> coefficients(space_dimension
-                                                     * block_size);
-
     // Get dofmap
     std::shared_ptr<const fem::DofMap> dofmap = _function_space->dofmap();
     assert(dofmap);
 
-    mesh->topology_mutable().create_entity_permutations();
-    const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info
-        = mesh->topology().get_cell_permutation_info();
+    // Create work vector for expansion coefficients
+    Eigen::Matrix<T, 1, Eigen::Dynamic> coefficients(space_dimension
+                                                     * block_size);
 
-    // Loop over points
+    // Loop over cells with points
     u.setZero();
-    const Eigen::Matrix<T, Eigen::Dynamic, 1>& _v = _x->array();
-    for (Eigen::Index p = 0; p < cells.rows(); ++p)
-    {
-      const int cell_index = cells(p);
-
-      // Skip negative cell indices
-      if (cell_index < 0)
-        continue;
-
-      // Get cell geometry (coordinate dofs)
-      auto x_dofs = x_dofmap.links(cell_index);
-      for (int i = 0; i < num_dofs_g; ++i)
-        coordinate_dofs.row(i) = x_g.row(x_dofs[i]).head(gdim);
-
-      // Compute reference coordinates X, and J, detJ and K
-      cmap.compute_reference_geometry(X, J, detJ, K, x.row(p).head(gdim),
-                                      coordinate_dofs);
-
-      // Compute basis on reference element
-      element->evaluate_reference_basis(basis_reference_values, X);
-
-      // Push basis forward to physical element
-      element->transform_reference_basis(basis_values, basis_reference_values,
-                                         X, J, detJ, K, cell_info[cell_index]);
-
-      // Get degrees of freedom for current cell
-      auto dofs = dofmap->cell_dofs(cell_index);
-      for (Eigen::Index i = 0; i < dofs.size(); ++i)
-        coefficients[i] = _v[dofs[i]];
-
-      // Compute expansion
-      for (int block = 0; block < block_size; ++block)
-      {
-        for (int i = 0; i < space_dimension; ++i)
-        {
-          for (int j = 0; j < value_size; ++j)
+    const Eigen::Matrix<T, Eigen::Dynamic, 1>& _v
+        = std::as_const(*_x).array();
+    tabulate_basis_by_cell(
+        *_function_space, x, cells,
+        [&](std::int32_t cell_index, const std::int32_t* points,
+            int num_points,
+            const Eigen::Tensor<double, 3, Eigen::RowMajor>& basis_values) {
+          // Get degrees of freedom for current cell
+          auto dofs = dofmap->cell_dofs(cell_index);
+          for (Eigen::Index i = 0; i < dofs.size(); ++i)
+            coefficients[i] = _v[dofs[i]];
+
+          // Compute expansion
+          for (int k = 0; k < num_points; ++k)
           {
-            // TODO: Find an Eigen shortcut for this operation
-            u.row(p)[j * block_size + block]
-                += coefficients[i * block_size + block] * basis_values(0, i, j);
+            auto u_p = u.row(points[k]);
+            for (int block = 0; block < block_size; ++block)
+            {
+              for (int i = 0; i < space_dimension; ++i)
+              {
+                for (int j = 0; j < value_size; ++j)
+                {
+                  u_p[j * block_size + block]
+                      += coefficients[i * block_size + block]
+                         * basis_values(k, i, j);
+                }
+              }
+            }
           }
-        }
-      }
-    }
+        });
+  }
+
+  /// Evaluate the Function at points that may be located on any
+  /// process. The points are evaluated on the processes that own them
+  /// and the values are sent back. This is collective.
+  ///
+  /// @param[in] plan The owning process and cell of each point,
+  ///   computed for the mesh of the Function
+  /// @param[in,out] u The values at the points passed to the
+  ///   constructor of @p plan on this process. Values are zero for
+  ///   points that are not located on any process. This argument must
+  ///   be passed with the correct size.
+  void
+  eval(const geometry::PointOwnership& plan,
+       Eigen::Ref<
+           Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
+           u) const
+  {
+    Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> values(
+        plan.owned_points().rows(), u.cols());
+    eval(plan.owned_points(), plan.cells(), values);
+    plan.send_values<T>(values, u);
   }
 
   /// Compute values at all mesh 'nodes'
@@ -392,6 +363,26 @@ public:
   /// ID
   std::size_t id() const { return _id; }
 
+  /// Version of the expansion coefficients. The version increases
+  /// whenever the coefficients have been modified, either through x()
+  /// followed by la::Vector::mark_modified(), as done by interpolation,
+  /// or through the PETSc Vec returned by vector() (including its
+  /// ghosted local form). If the version is unchanged, the coefficients
+  /// are unchanged. Modifications through the PETSc Vec of a different
+  /// Function that shares the coefficients, e.g. a sub-function, are
+  /// not tracked.
+  std::uint64_t version() const
+  {
+    std::uint64_t version = _x->version();
+    if (_petsc_vector)
+    {
+      PetscObjectState state;
+      PetscObjectStateGet((PetscObject)_petsc_vector, &state);
+      version += state;
+    }
+    return version;
+  }
+
 private:
   // ID
   std::size_t _id;
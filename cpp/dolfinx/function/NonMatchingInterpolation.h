@@ -0,0 +1,222 @@
+// Copyright (C) 2020 agent
+//
+// This file is part of DOLFINX (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "Function.h"
+#include "FunctionSpace.h"
+#include "utils.h"
+#include <Eigen/Dense>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/Timer.h>
+#include <dolfinx/fem/DofMap.h>
+#include <dolfinx/fem/FiniteElement.h>
+#include <dolfinx/geometry/BoundingBoxTree.h>
+#include <dolfinx/geometry/PointOwnership.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/la/Vector.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace dolfinx::function
+{
+
+template <typename T>
+class Function;
+
+/// This class interpolates Functions between function spaces on
+/// different (non-matching) meshes, which may be distributed
+/// differently across processes.
+///
+/// The interpolation points of the target space are located in the
+/// cells of the source mesh once, using a bounding box tree and a
+/// geometry::PointOwnership communication plan, and the source basis
+/// functions are tabulated at the points. The transfer is then stored
+/// as a sparse matrix from the source degrees-of-freedom to the values
+/// at the points, so that repeated interpolation (e.g. in a
+/// time-stepping loop) is a sparse matrix-vector product followed by
+/// one neighborhood communication.
+///
+/// The target space must be a point-evaluation space, e.g. a (blocked)
+/// Lagrange space. The source space may be any space with the same
+/// value size, e.g. a Raviart-Thomas space. Target interpolation points
+/// outside the source mesh are given the value zero.
+
+template <typename T>
+class NonMatchingInterpolation
+{
+public:
+  /// Create the transfer operator. This is collective.
+  /// @param[in] V The target function space
+  /// @param[in] W The source function space
+  /// @param[in] num_threads Number of threads used to locate the points
+  NonMatchingInterpolation(std::shared_ptr<const FunctionSpace> V,
+                           std::shared_ptr<const FunctionSpace> W,
+                           int num_threads = 1)
+      : _V(V), _W(W)
+  {
+    assert(_V);
+    assert(_W);
+    common::Timer timer("Build non-matching interpolation");
+
+    std::shared_ptr<const fem::FiniteElement> element_v = _V->element();
+    assert(element_v);
+    std::shared_ptr<const fem::FiniteElement> element_w = _W->element();
+    assert(element_w);
+    if (element_v->family() == "Mixed"
+        or element_v->value_size() != element_v->block_size())
+    {
+      throw std::runtime_error("Non-matching interpolation requires a "
+                               "(blocked) point-evaluation target space.");
+    }
+    if (element_v->value_size() != element_w->value_size())
+    {
+      throw std::runtime_error("Non-matching interpolation requires "
+                               "elements with the same value size.");
+    }
+    _value_size = element_v->value_size();
+
+    // Interpolation points of the target space that are owned by this
+    // process
+    std::shared_ptr<const common::IndexMap> map = _V->dofmap()->index_map;
+    assert(map);
+    _num_points = map->block_size() * map->size_local() / _value_size;
+    const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor> x
+        = _V->tabulate_scalar_subspace_dof_coordinates().topRows(
+            _num_points);
+
+    // Locate the points in the source mesh
+    std::shared_ptr<const mesh::Mesh> mesh = _W->mesh();
+    assert(mesh);
+    const geometry::BoundingBoxTree tree(*mesh, mesh->topology().dim(),
+                                         num_threads);
+    _plan = std::make_shared<geometry::PointOwnership>(*mesh, tree, x,
+                                                       num_threads);
+
+    // Tabulate the source basis at the owned points and build the rows
+    // (point, component) of the transfer matrix. Each row has one entry
+    // per (scalar) basis function in the cell.
+    std::shared_ptr<const fem::DofMap> dofmap = _W->dofmap();
+    assert(dofmap);
+    const int block_size = element_w->block_size();
+    const int value_size = element_w->value_size() / block_size;
+    const int space_dimension = element_w->space_dimension() / block_size;
+    const std::int32_t num_owned = _plan->owned_points().rows();
+
+    Eigen::Array<std::int32_t, Eigen::Dynamic, 1> offsets(
+        num_owned * _value_size + 1);
+    for (Eigen::Index r = 0; r < offsets.rows(); ++r)
+      offsets[r] = r * space_dimension;
+    Eigen::Array<std::int32_t, Eigen::Dynamic, 1> columns(offsets.tail(1)[0]);
+    _weights.resize(columns.rows());
+
+    tabulate_basis_by_cell(
+        *_W, _plan->owned_points(), _plan->cells(),
+        [&](std::int32_t cell, const std::int32_t* points, int num_points,
+            const Eigen::Tensor<double, 3, Eigen::RowMajor>& basis_values) {
+          auto dofs = dofmap->cell_dofs(cell);
+          for (int k = 0; k < num_points; ++k)
+          {
+            for (int block = 0; block < block_size; ++block)
+            {
+              for (int j = 0; j < value_size; ++j)
+              {
+                const int comp = j * block_size + block;
+                std::int32_t pos = offsets[points[k] * _value_size + comp];
+                for (int i = 0; i < space_dimension; ++i)
+                {
+                  columns[pos] = dofs[i * block_size + block];
+                  _weights[pos] = basis_values(k, i, j);
+                  ++pos;
+                }
+              }
+            }
+          }
+        });
+    _matrix = std::make_shared<graph::AdjacencyList<std::int32_t>>(
+        std::move(columns), std::move(offsets));
+  }
+
+  /// Copy constructor
+  NonMatchingInterpolation(const NonMatchingInterpolation& op) = default;
+
+  /// Move constructor
+  NonMatchingInterpolation(NonMatchingInterpolation&& op) = default;
+
+  /// Destructor
+  ~NonMatchingInterpolation() = default;
+
+  /// Interpolate a Function on the source space into a Function on the
+  /// target space. This is collective. The ghost values of v must be
+  /// up-to-date, and the ghost values of u are updated.
+  /// @param[in] v The function to interpolate, on the source space
+  /// @param[out] u The function to interpolate into, on the target
+  ///   space
+  void apply(const Function<T>& v, Function<T>& u) const
+  {
+    if (*v.function_space() != *_W or *u.function_space() != *_V)
+    {
+      throw std::runtime_error(
+          "Functions are not on the interpolation spaces.");
+    }
+
+    // Compute values at owned points
+    const Eigen::Matrix<T, Eigen::Dynamic, 1>& _v = v.x()->array();
+    const Eigen::Array<std::int32_t, Eigen::Dynamic, 1>& columns
+        = _matrix->array();
+    const Eigen::Array<std::int32_t, Eigen::Dynamic, 1>& offsets
+        = _matrix->offsets();
+    Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> values(
+        _plan->owned_points().rows(), _value_size);
+    for (std::int32_t r = 0; r < _matrix->num_nodes(); ++r)
+    {
+      T value = 0;
+      for (std::int32_t pos = offsets[r]; pos < offsets[r + 1]; ++pos)
+        value += _weights[pos] * _v[columns[pos]];
+      values.data()[r] = value;
+    }
+
+    // Send values to the processes that own the target dofs
+    Eigen::Matrix<T, Eigen::Dynamic, 1>& coefficients = u.x()->array();
+    Eigen::Map<
+        Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
+        u_values(coefficients.data(), _num_points, _value_size);
+    _plan->send_values<T>(values, u_values);
+    u.x()->mark_modified();
+    u.x()->scatter_fwd();
+  }
+
+  /// The target function space
+  std::shared_ptr<const FunctionSpace> target() const { return _V; }
+
+  /// The source function space
+  std::shared_ptr<const FunctionSpace> source() const { return _W; }
+
+  /// Number of target interpolation points on this process that are
+  /// outside the source mesh
+  std::int32_t num_lost_points() const { return _plan->num_lost_points(); }
+
+private:
+  // Target and source function spaces
+  std::shared_ptr<const FunctionSpace> _V, _W;
+
+  // Value size, and number of owned target interpolation points
+  int _value_size;
+  std::int32_t _num_points;
+
+  // Communication plan for the target interpolation points
+  std::shared_ptr<const geometry::PointOwnership> _plan;
+
+  // Transfer matrix from source dofs to the values at the owned points,
+  // with one row per (point, component). The columns are stored in
+  // _matrix and the values in _weights.
+  std::shared_ptr<const graph::AdjacencyList<std::int32_t>> _matrix;
+  Eigen::Array<double, Eigen::Dynamic, 1> _weights;
+};
+
+} // namespace dolfinx::function
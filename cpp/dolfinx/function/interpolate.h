@@ -6,8 +6,10 @@
 
 #pragma once
 
+#include "ExpressionInterpolation.h"
 #include "Function.h"
 #include "FunctionSpace.h"
+#include "NonMatchingInterpolation.h"
 #include <Eigen/Dense>
 #include <dolfinx/fem/DofMap.h>
 #include <dolfinx/fem/FiniteElement.h>
@@ -20,6 +22,9 @@ namespace dolfinx::function
 template <typename T>
 class Function;
 
+template <typename T>
+class NonMatchingInterpolation;
+
 /// Interpolate a Function (on possibly non-matching meshes)
 /// @param[in,out] u The function to interpolate into
 /// @param[in] v The function to be interpolated
@@ -57,23 +62,23 @@ void interpolate_c(
 namespace detail
 {
 
-// Interpolate data. Fills coefficients using 'values', which are the
-// values of an expression at each dof.
-template <typename T>
-void interpolate_values(
-    Function<T>& u,
-    const Eigen::Ref<const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic,
-                                        Eigen::RowMajor>>& values)
-{
-  Eigen::Matrix<T, Eigen::Dynamic, 1>& coefficients = u.x()->array();
-  coefficients = Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>>(
-      values.data(), coefficients.rows());
-}
-
 template <typename T>
 void interpolate_from_any(Function<T>& u, const Function<T>& v)
 {
   assert(v.function_space());
+  const auto mesh = u.function_space()->mesh();
+  assert(mesh);
+  assert(v.function_space()->mesh());
+  if (mesh->id() != v.function_space()->mesh()->id())
+  {
+    // Interpolate at the dof points of u. Use NonMatchingInterpolation
+    // directly to re-use the transfer operator.
+    const NonMatchingInterpolation<T> op(u.function_space(),
+                                         v.function_space());
+    op.apply(v, u);
+    return;
+  }
+
   const auto element = u.function_space()->element();
   assert(element);
   if (!v.function_space()->has_element(*element))
@@ -81,15 +86,6 @@ void interpolate_from_any(Function<T>& u, const Function<T>& v)
     throw std::runtime_error("Restricting finite elements function in "
                              "different elements not supported.");
   }
-
-  const auto mesh = u.function_space()->mesh();
-  assert(mesh);
-  assert(v.function_space()->mesh());
-  if (mesh->id() != v.function_space()->mesh()->id())
-  {
-    throw std::runtime_error(
-        "Interpolation on different meshes not supported (yet).");
-  }
   const int tdim = mesh->topology().dim();
 
   // Get dofmaps
@@ -113,6 +109,7 @@ void interpolate_from_any(Function<T>& u, const Function<T>& v)
     for (Eigen::Index i = 0; i < dofs_v.size(); ++i)
       expansion_coefficients[cell_dofs[i]] = v_array[dofs_v[i]];
   }
+  u.x()->mark_modified();
 }
 
 } // namespace detail
@@ -163,85 +160,8 @@ void interpolate(
             const Eigen::Ref<const Eigen::Array<double, 3, Eigen::Dynamic,
                                                 Eigen::RowMajor>>&)>& f)
 {
-  // u.function_space()->interpolate(u.x()->array(), f);
-  assert(u.function_space());
-
-  // Evaluate expression at dof points
-  const Eigen::Array<double, 3, Eigen::Dynamic, Eigen::RowMajor> x
-      = u.function_space()
-            ->tabulate_scalar_subspace_dof_coordinates()
-            .transpose();
-  const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> values
-      = f(x);
-
-  const auto element = u.function_space()->element();
-  assert(element);
-  std::vector<int> vshape(element->value_rank(), 1);
-  for (std::size_t i = 0; i < vshape.size(); ++i)
-    vshape[i] = element->value_dimension(i);
-  const int value_size = std::accumulate(std::begin(vshape), std::end(vshape),
-                                         1, std::multiplies<>());
-
-  auto mesh = u.function_space()->mesh();
-  assert(mesh);
-  const int tdim = mesh->topology().dim();
-  if (element->family() == "Mixed")
-  {
-    // Extract the correct components of the result for each subelement of the
-    // MixedElement
-    std::shared_ptr<const fem::DofMap> dofmap = u.function_space()->dofmap();
-    auto map = mesh->topology().index_map(tdim);
-    assert(map);
-    const int num_cells = map->size_local() + map->num_ghosts();
-
-    Eigen::Array<T, 1, Eigen::Dynamic> mixed_values(values.cols());
-    int value_offset = 0;
-    for (int i = 0; i < element->num_sub_elements(); ++i)
-    {
-      const std::vector<int> component = {i};
-      const fem::DofMap sub_dofmap = dofmap->extract_sub_dofmap(component);
-      std::shared_ptr<const fem::FiniteElement> sub_element
-          = element->extract_sub_element(component);
-      const int element_block_size = sub_element->block_size();
-      for (std::size_t cell = 0; cell < num_cells; ++cell)
-      {
-        const auto cell_dofs = sub_dofmap.cell_dofs(cell);
-        const std::size_t scalar_dofs = cell_dofs.rows() / element_block_size;
-        for (std::size_t dof = 0; dof < scalar_dofs; ++dof)
-          for (int b = 0; b < element_block_size; ++b)
-            mixed_values(cell_dofs[element_block_size * dof + b])
-                = values(value_offset + b, cell_dofs[element_block_size * dof]);
-      }
-      value_offset += element_block_size;
-    }
-    detail::interpolate_values<T>(u, mixed_values);
-    return;
-  }
-
-  // Note: pybind11 maps 1D NumPy arrays to column vectors for
-  // Eigen::Array<T, Eigen::Dynamic,Eigen::Dynamic, Eigen::RowMajor>
-  // types, therefore we need to handle vectors as a special case.
-  if (values.cols() == 1 and values.rows() != 1)
-  {
-    if (values.rows() != x.cols())
-    {
-      throw std::runtime_error("Number of computed values is not equal to the "
-                               "number of evaluation points. (1)");
-    }
-    detail::interpolate_values<T>(u, values);
-  }
-  else
-  {
-    if (values.rows() != value_size)
-      throw std::runtime_error("Values shape is incorrect. (2)");
-    if (values.cols() != x.cols())
-    {
-      throw std::runtime_error("Number of computed values is not equal to the "
-                               "number of evaluation points. (2)");
-    }
-
-    detail::interpolate_values<T>(u, values.transpose());
-  }
+  const ExpressionInterpolation<T> op(u.function_space());
+  op.interpolate(u, f);
 }
 //----------------------------------------------------------------------------
 template <typename T>
@@ -253,23 +173,8 @@ void interpolate_c(
         const Eigen::Ref<const Eigen::Array<double, Eigen::Dynamic, 3,
                                             Eigen::RowMajor>>&)>& f)
 {
-  // Build list of points at which to evaluate the Expression
-  const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor> x
-      = u.function_space()->tabulate_dof_coordinates();
-
-  // Evaluate expression at points
-  const auto element = u.function_space()->element();
-  assert(element);
-  std::vector<int> vshape(element->value_rank(), 1);
-  for (std::size_t i = 0; i < vshape.size(); ++i)
-    vshape[i] = element->value_dimension(i);
-  const int value_size = std::accumulate(std::begin(vshape), std::end(vshape),
-                                         1, std::multiplies<>());
-  Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> values(
-      x.rows(), value_size);
-  f(values, x);
-
-  detail::interpolate_values<T>(u, values);
+  const ExpressionInterpolation<T> op(u.function_space());
+  op.interpolate_c(u, f);
 }
 //----------------------------------------------------------------------------
 
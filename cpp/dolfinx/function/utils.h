@@ -0,0 +1,151 @@
+// Copyright (C) 2020 agent
+//
+// This file is part of DOLFINX (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "FunctionSpace.h"
+#include <Eigen/Dense>
+#include <cstdint>
+#include <dolfinx/common/utils.h>
+#include <dolfinx/fem/CoordinateElement.h>
+#include <dolfinx/fem/FiniteElement.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/mesh/Geometry.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <memory>
+#include <unsupported/Eigen/CXX11/Tensor>
+#include <vector>
+
+namespace dolfinx::function
+{
+
+/// Tabulate the basis functions of a function space at points. The
+/// points are sorted by cell, and the reference coordinates and basis
+/// functions are computed for all points in a cell at once. For affine
+/// cells, the reference coordinates are computed without Newton
+/// iterations.
+///
+/// @param[in] V The function space
+/// @param[in] x The coordinates of the points (shape=(num_points, 3))
+/// @param[in] cells The index of the cell that contains each point.
+///   Points with a negative cell index are ignored.
+/// @param[in] fn The function called for each cell that contains
+///   points, as fn(cell, points, num_points, basis_values), where
+///   points are the indices of the points in the cell and
+///   basis_values(k, i, j) is component j of scalar basis function i at
+///   point k
+template <typename Fn>
+void tabulate_basis_by_cell(
+    const FunctionSpace& V,
+    const Eigen::Ref<const Eigen::Array<double, Eigen::Dynamic, 3,
+                                        Eigen::RowMajor>>& x,
+    const Eigen::Ref<const Eigen::Array<int, Eigen::Dynamic, 1>>& cells,
+    Fn fn)
+{
+  // Get mesh
+  std::shared_ptr<const mesh::Mesh> mesh = V.mesh();
+  assert(mesh);
+  const int gdim = mesh->geometry().dim();
+  const int tdim = mesh->topology().dim();
+
+  // Get geometry data
+  const graph::AdjacencyList<std::int32_t>& x_dofmap
+      = mesh->geometry().dofmap();
+
+  // FIXME: Add proper interface for num coordinate dofs
+  const int num_dofs_g = x_dofmap.num_links(0);
+  const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& x_g
+      = mesh->geometry().x();
+  Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+      coordinate_dofs(num_dofs_g, gdim);
+
+  // Get coordinate map
+  const fem::CoordinateElement& cmap = mesh->geometry().cmap();
+
+  // Get element
+  std::shared_ptr<const fem::FiniteElement> element = V.element();
+  assert(element);
+  const int block_size = element->block_size();
+  const int reference_value_size
+      = element->reference_value_size() / block_size;
+  const int value_size = element->value_size() / block_size;
+  const int space_dimension = element->space_dimension() / block_size;
+
+  mesh->topology_mutable().create_entity_permutations();
+  const Eigen::Array<std::uint32_t, Eigen::Dynamic, 1>& cell_info
+      = mesh->topology().get_cell_permutation_info();
+
+  // Sort the points with a non-negative cell index by cell
+  std::vector<std::int32_t> points;
+  points.reserve(cells.rows());
+  for (Eigen::Index p = 0; p < cells.rows(); ++p)
+  {
+    if (cells[p] >= 0)
+      points.push_back(p);
+  }
+  std::vector<std::int32_t> point_cells(points.size());
+  for (std::size_t i = 0; i < points.size(); ++i)
+    point_cells[i] = cells[points[i]];
+  const std::vector<std::int32_t> perm
+      = common::sort_rows_by_perm(point_cells.data(), points.size(), 1);
+  std::vector<std::int32_t> sorted_points(points.size());
+  for (std::size_t i = 0; i < perm.size(); ++i)
+    sorted_points[i] = points[perm[i]];
+
+  // Geometry and basis function data structures, sized for the
+  // number of points in a cell
+  Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> xp;
+  Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> X;
+  Eigen::Tensor<double, 3, Eigen::RowMajor> J, K;
+  Eigen::Array<double, Eigen::Dynamic, 1> detJ;
+  Eigen::Tensor<double, 3, Eigen::RowMajor> basis_reference_values,
+      basis_values;
+
+  for (std::size_t p0 = 0; p0 < sorted_points.size();)
+  {
+    const int cell_index = cells[sorted_points[p0]];
+    std::size_t p1 = p0 + 1;
+    while (p1 < sorted_points.size() and cells[sorted_points[p1]] == cell_index)
+      ++p1;
+    const int num_points = p1 - p0;
+
+    // Resize data structures if the number of points has changed
+    if (X.rows() != num_points)
+    {
+      xp.resize(num_points, gdim);
+      X.resize(num_points, tdim);
+      J.resize(num_points, gdim, tdim);
+      detJ.resize(num_points);
+      K.resize(num_points, tdim, gdim);
+      basis_reference_values.resize(num_points, space_dimension,
+                                    reference_value_size);
+      basis_values.resize(num_points, space_dimension, value_size);
+    }
+
+    // Get cell geometry (coordinate dofs) and points
+    auto x_dofs = x_dofmap.links(cell_index);
+    for (int i = 0; i < num_dofs_g; ++i)
+      coordinate_dofs.row(i) = x_g.row(x_dofs[i]).head(gdim);
+    for (int k = 0; k < num_points; ++k)
+      xp.row(k) = x.row(sorted_points[p0 + k]).head(gdim);
+
+    // Compute reference coordinates X, and J, detJ and K
+    cmap.compute_reference_geometry(X, J, detJ, K, xp, coordinate_dofs);
+
+    // Compute basis on reference element
+    element->evaluate_reference_basis(basis_reference_values, X);
+
+    // Push basis forward to physical element
+    element->transform_reference_basis(basis_values, basis_reference_values,
+                                       X, J, detJ, K, cell_info[cell_index]);
+
+    fn(cell_index, sorted_points.data() + p0, num_points, basis_values);
+    p0 = p1;
+  }
+}
+
+} // namespace dolfinx::function
@@ -5,9 +5,12 @@
 
 #include "BoundingBoxTree.h"
 #include "utils.h"
+#include <atomic>
+#include <cstdint>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/common/log.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/utils.h>
@@ -18,7 +21,8 @@ using namespace dolfinx::geometry;
 namespace
 {
 //-----------------------------------------------------------------------------
-// Compute bounding box of mesh entity
+// Compute bounding box of mesh entity. The entity-to-cell connectivity
+// must have been computed.
 Eigen::Array<double, 2, 3, Eigen::RowMajor>
 compute_bbox_of_entity(const mesh::Mesh& mesh, int dim, std::int32_t index)
 {
@@ -26,7 +30,6 @@ compute_bbox_of_entity(const mesh::Mesh& mesh, int dim, std::int32_t index)
   const int tdim = mesh.topology().dim();
   const mesh::Geometry& geometry = mesh.geometry();
   const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
-  mesh.topology_mutable().create_connectivity(dim, tdim);
 
   // Find attached cell
   auto e_to_c = mesh.topology().connectivity(dim, tdim);
@@ -69,183 +72,203 @@ compute_bbox_of_entity(const mesh::Mesh& mesh, int dim, std::int32_t index)
   return b;
 }
 //-----------------------------------------------------------------------------
-// Compute bounding box of points
-Eigen::Array<double, 2, 3, Eigen::RowMajor>
-compute_bbox_of_points(const std::vector<Eigen::Vector3d>& points,
-                       const std::vector<int>::iterator& begin,
-                       const std::vector<int>::iterator& end)
+// Length of the common prefix of the keys of sorted leaves i and j, or
+// -1 if j is out of range. Equal Morton codes are made unique by
+// appending the leaf position to the key.
+int common_prefix(const std::vector<std::uint64_t>& codes, std::int32_t i,
+                  std::int32_t j)
 {
-  Eigen::Array<double, 2, 3, Eigen::RowMajor> b;
-  b.row(0) = points[*begin];
-  b.row(1) = points[*begin];
-  for (auto it = begin; it != end; ++it)
-  {
-    const Eigen::Vector3d& p = points[*it];
-    b.row(0) = b.row(0).min(p.transpose().array());
-    b.row(1) = b.row(1).max(p.transpose().array());
-  }
-
-  return b;
+  if (j < 0 or j >= (std::int32_t)codes.size())
+    return -1;
+  else if (const std::uint64_t x = codes[i] ^ codes[j]; x != 0)
+    return __builtin_clzll(x);
+  else
+    return 64 + __builtin_clz(std::uint32_t(i ^ j));
 }
 //-----------------------------------------------------------------------------
-// Compute bounding box of bounding boxes
-Eigen::Array<double, 2, 3, Eigen::RowMajor> compute_bbox_of_bboxes(
-    const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& leaf_bboxes,
-    const std::vector<int>::iterator& begin,
-    const std::vector<int>::iterator& end)
+// Compute the parent of each node from the child nodes. The root has
+// parent -1.
+std::vector<std::int32_t> compute_parents(
+    const Eigen::Array<int, Eigen::Dynamic, 2, Eigen::RowMajor>& bboxes,
+    int num_threads)
 {
-  Eigen::Array<double, 2, 3, Eigen::RowMajor> b
-      = leaf_bboxes.block<2, 3>(2 * (*begin), 0);
-
-  // Compute min and max over remaining boxes
-  for (auto it = begin; it != end; ++it)
-  {
-    b.row(0) = b.row(0).min(leaf_bboxes.row(2 * (*it)));
-    b.row(1) = b.row(1).max(leaf_bboxes.row(2 * (*it) + 1));
-  }
-
-  return b;
+  const std::int32_t num_nodes = bboxes.rows();
+  const std::int32_t n = (num_nodes + 1) / 2;
+  std::vector<std::int32_t> parent(num_nodes, -1);
+  common::parallel_for(
+      num_nodes - n, num_threads,
+      [&](int, std::int32_t begin, std::int32_t end) {
+        for (std::int32_t p = n + begin; p < n + end; ++p)
+        {
+          parent[bboxes(p, 0)] = p;
+          parent[bboxes(p, 1)] = p;
+        }
+      });
+  return parent;
 }
-//------------------------------------------------------------------------------
-int _build_from_leaf(
-    const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& leaf_bboxes,
-    const std::vector<int>::iterator partition_begin,
-    const std::vector<int>::iterator partition_end,
-    std::vector<std::array<int, 2>>& bboxes,
-    std::vector<double>& bbox_coordinates)
+//-----------------------------------------------------------------------------
+// Compute the boxes of the internal nodes bottom-up from the leaf
+// boxes. A path from each leaf is followed towards the root. The first
+// path to reach a node stops and the second computes the node box,
+// which then depends only on completed child boxes.
+void fit_internal_bboxes(
+    const Eigen::Array<int, Eigen::Dynamic, 2, Eigen::RowMajor>& bboxes,
+    const std::vector<std::int32_t>& parent,
+    Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& coords,
+    int num_threads)
 {
-  assert(partition_begin < partition_end);
-
-  if (partition_end - partition_begin == 1)
-  {
-    // Reached leaf
-
-    // Get bounding box coordinates for leaf
-    const int entity_index = *partition_begin;
-    Eigen::Array<double, 2, 3, Eigen::RowMajor> b
-        = leaf_bboxes.block<2, 3>(2 * entity_index, 0);
-
-    // Store bounding box data
-    // bbox[0] = num_bboxes(); // child_0 == node denotes a leaf
-    // bbox[1] = entity_index; // index of entity contained in leaf
-    // return add_bbox(bbox, b);
-    // return add_bbox({num_bboxes(), entity_index}, b);
-    bboxes.push_back({(int)bboxes.size(), entity_index});
-    bbox_coordinates.insert(bbox_coordinates.end(), b.data(), b.data() + 3);
-    bbox_coordinates.insert(bbox_coordinates.end(), b.data() + 3, b.data() + 6);
-    return bboxes.size() - 1;
-  }
-  else
-  {
-    // Compute bounding box of all bounding boxes
-    Eigen::Array<double, 2, 3, Eigen::RowMajor> b
-        = compute_bbox_of_bboxes(leaf_bboxes, partition_begin, partition_end);
-
-    // Sort bounding boxes along longest axis
-    Eigen::Array<double, 2, 3, Eigen::RowMajor>::Index axis;
-    (b.row(1) - b.row(0)).maxCoeff(&axis);
-    auto partition_middle
-        = partition_begin + (partition_end - partition_begin) / 2;
-    std::nth_element(partition_begin, partition_middle, partition_end,
-                     [&leaf_bboxes, axis](int i, int j) -> bool {
-                       const double bi = leaf_bboxes(i * 2, axis)
-                                         + leaf_bboxes(i * 2 + 1, axis);
-                       const double bj = leaf_bboxes(j * 2, axis)
-                                         + leaf_bboxes(j * 2 + 1, axis);
-                       return (bi < bj);
-                     });
-
-    // Split bounding boxes into two groups and call recursively
-    std::array bbox{_build_from_leaf(leaf_bboxes, partition_begin,
-                                     partition_middle, bboxes,
-                                     bbox_coordinates),
-                    _build_from_leaf(leaf_bboxes, partition_middle,
-                                     partition_end, bboxes, bbox_coordinates)};
-
-    // Store bounding box data. Note that root box will be added last.
-    bboxes.push_back(bbox);
-    bbox_coordinates.insert(bbox_coordinates.end(), b.data(), b.data() + 3);
-    bbox_coordinates.insert(bbox_coordinates.end(), b.data() + 3, b.data() + 6);
-    return bboxes.size() - 1;
-  }
+  const std::int32_t n = (bboxes.rows() + 1) / 2;
+  if (n == 0)
+    return;
+  std::vector<std::atomic<int>> visits(n - 1);
+  for (std::atomic<int>& v : visits)
+    v.store(0);
+  common::parallel_for(
+      n, num_threads, [&](int, std::int32_t begin, std::int32_t end) {
+        for (std::int32_t i = begin; i < end; ++i)
+        {
+          for (std::int32_t p = parent[i]; p >= 0; p = parent[p])
+          {
+            if (visits[p - n].fetch_add(1, std::memory_order_acq_rel) == 0)
+              break;
+            const int c0 = bboxes(p, 0);
+            const int c1 = bboxes(p, 1);
+            coords.row(2 * p) = coords.row(2 * c0).min(coords.row(2 * c1));
+            coords.row(2 * p + 1)
+                = coords.row(2 * c0 + 1).max(coords.row(2 * c1 + 1));
+          }
+        }
+      });
 }
 //-----------------------------------------------------------------------------
-std::tuple<Eigen::Array<int, Eigen::Dynamic, 2, Eigen::RowMajor>,
-           Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>>
-build_from_leaf(
-    const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& leaf_bboxes)
+// Compute the bounding box of each leaf entity of a tree for the
+// entities of dimension dim of a mesh
+void compute_leaf_bboxes(
+    const mesh::Mesh& mesh, int dim,
+    const Eigen::Array<int, Eigen::Dynamic, 2, Eigen::RowMajor>& bboxes,
+    Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& coords,
+    int num_threads)
 {
-  assert(leaf_bboxes.size() % 2 == 0);
-  std::vector<int> partition(leaf_bboxes.rows() / 2);
-  std::iota(partition.begin(), partition.end(), 0);
-
-  std::vector<std::array<int, 2>> bboxes;
-  std::vector<double> bbox_coordinates;
-  _build_from_leaf(leaf_bboxes, partition.begin(), partition.end(), bboxes,
-                   bbox_coordinates);
-
-  Eigen::Array<int, Eigen::Dynamic, 2, Eigen::RowMajor> bbox_array(
-      bboxes.size(), 2);
-  for (std::size_t i = 0; i < bboxes.size(); ++i)
-  {
-    bbox_array(i, 0) = bboxes[i][0];
-    bbox_array(i, 1) = bboxes[i][1];
-  }
-  Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor> bbox_coord_array(
-      bbox_coordinates.size() / 3, 3);
-  std::copy(bbox_coordinates.begin(), bbox_coordinates.end(),
-            bbox_coord_array.data());
-
-  return {bbox_array, bbox_coord_array};
+  const std::int32_t n = (bboxes.rows() + 1) / 2;
+  common::parallel_for(n, num_threads,
+                       [&](int, std::int32_t begin, std::int32_t end) {
+                         for (std::int32_t i = begin; i < end; ++i)
+                         {
+                           coords.block<2, 3>(2 * i, 0)
+                               = compute_bbox_of_entity(mesh, dim,
+                                                        bboxes(i, 1));
+                         }
+                       });
 }
 //-----------------------------------------------------------------------------
-int _build_from_point(const std::vector<Eigen::Vector3d>& points,
-                      const std::vector<int>::iterator begin,
-                      const std::vector<int>::iterator end,
-                      std::vector<std::array<int, 2>>& bboxes,
-                      std::vector<double>& bbox_coordinates)
+// Build a linear bounding volume hierarchy from the leaf boxes. The
+// leaves are sorted along a Morton (Z-order) curve through the box
+// midpoints, and the binary radix tree over the Morton codes (Karras,
+// "Maximizing parallelism in the construction of BVHs, octrees, and
+// k-d trees", 2012) gives the internal nodes. All steps are computed in
+// parallel.
+//
+// The sorted leaves are stored first, so spatially close leaves are
+// close in memory, followed by the internal nodes with the root last.
+std::tuple<Eigen::Array<int, Eigen::Dynamic, 2, Eigen::RowMajor>,
+           Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>>
+build_from_leaf(
+    const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& leaf_bboxes,
+    int num_threads)
 {
-  assert(begin < end);
-
-  // Reached leaf
-  if (end - begin == 1)
-  {
-    // Store bounding box data
-    const int point_index = *begin;
-    const int c0 = bboxes.size(); // child_0 == node denotes a leaf
-    const int c1 = point_index;   // index of entity contained in leaf
-    bboxes.push_back({c0, c1});
-    bbox_coordinates.insert(bbox_coordinates.end(), points[point_index].data(),
-                            points[point_index].data() + 3);
-    bbox_coordinates.insert(bbox_coordinates.end(), points[point_index].data(),
-                            points[point_index].data() + 3);
-    return bboxes.size() - 1;
-  }
-
-  // Compute bounding box of all points
-  Eigen::Array<double, 2, 3, Eigen::RowMajor> b
-      = compute_bbox_of_points(points, begin, end);
-
-  // Sort bounding boxes along longest axis
-  auto middle = begin + (end - begin) / 2;
-  Eigen::Array<double, 2, 3, Eigen::RowMajor>::Index axis;
-  (b.row(1) - b.row(0)).maxCoeff(&axis);
-  std::nth_element(begin, middle, end, [&points, &axis](int i, int j) -> bool {
-    const double* pi = points[i].data();
-    const double* pj = points[j].data();
-    return pi[axis] < pj[axis];
-  });
-
-  // Split bounding boxes into two groups and call recursively
-  std::array bbox{
-      _build_from_point(points, begin, middle, bboxes, bbox_coordinates),
-      _build_from_point(points, middle, end, bboxes, bbox_coordinates)};
-
-  // Store bounding box data. Note that root box will be added last
-  bboxes.push_back(bbox);
-  bbox_coordinates.insert(bbox_coordinates.end(), b.data(), b.data() + 3);
-  bbox_coordinates.insert(bbox_coordinates.end(), b.data() + 3, b.data() + 6);
-  return bboxes.size() - 1;
+  assert(leaf_bboxes.rows() % 2 == 0);
+  const std::int32_t n = leaf_bboxes.rows() / 2;
+  const std::int32_t num_nodes = std::max(2 * n - 1, 0);
+  Eigen::Array<int, Eigen::Dynamic, 2, Eigen::RowMajor> bboxes(num_nodes, 2);
+  Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor> coords(
+      2 * num_nodes, 3);
+  if (n == 0)
+    return {bboxes, coords};
+
+  // Compute Morton code of each leaf box midpoint
+  Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor> midpoints(n, 3);
+  common::parallel_for(
+      n, num_threads, [&](int, std::int32_t begin, std::int32_t end) {
+        for (std::int32_t i = begin; i < end; ++i)
+        {
+          midpoints.row(i)
+              = 0.5 * (leaf_bboxes.row(2 * i) + leaf_bboxes.row(2 * i + 1));
+        }
+      });
+  const std::vector<std::uint64_t> codes
+      = compute_morton_codes(midpoints, num_threads);
+
+  // Sort leaves by Morton code and store leaf nodes
+  const std::vector<std::int32_t> perm
+      = common::sort_rows_by_perm(codes.data(), n, 1, num_threads);
+  std::vector<std::uint64_t> sorted_codes(n);
+  common::parallel_for(
+      n, num_threads, [&](int, std::int32_t begin, std::int32_t end) {
+        for (std::int32_t i = begin; i < end; ++i)
+        {
+          sorted_codes[i] = codes[perm[i]];
+          bboxes(i, 0) = i;
+          bboxes(i, 1) = perm[i];
+          coords.block<2, 3>(2 * i, 0)
+              = leaf_bboxes.block<2, 3>(2 * perm[i], 0);
+        }
+      });
+
+  // Compute children of each internal node. Internal node k of the
+  // radix tree is stored as node 2n - 2 - k.
+  auto internal = [n](std::int32_t k) { return 2 * n - 2 - k; };
+  std::vector<std::int32_t> parent(num_nodes, -1);
+  common::parallel_for(
+      n - 1, num_threads, [&](int, std::int32_t begin, std::int32_t end) {
+        for (std::int32_t k = begin; k < end; ++k)
+        {
+          auto delta = [&sorted_codes, k](std::int32_t j) {
+            return common_prefix(sorted_codes, k, j);
+          };
+
+          // Find the direction and other end of the range of leaves
+          // covered by the node
+          const int d = delta(k + 1) > delta(k - 1) ? 1 : -1;
+          const int delta_min = delta(k - d);
+          std::int32_t l_max = 2;
+          while (delta(k + l_max * d) > delta_min)
+            l_max *= 2;
+          std::int32_t l = 0;
+          for (std::int32_t t = l_max / 2; t > 0; t /= 2)
+          {
+            if (delta(k + (l + t) * d) > delta_min)
+              l += t;
+          }
+          const std::int32_t j = k + l * d;
+
+          // Find the split position, i.e. the last leaf of the first
+          // child
+          const int delta_node = delta(j);
+          std::int32_t s = 0;
+          std::int32_t t = l;
+          do
+          {
+            t = (t + 1) / 2;
+            if (delta(k + (s + t) * d) > delta_node)
+              s += t;
+          } while (t > 1);
+          const std::int32_t split = k + s * d + std::min(d, 0);
+
+          const std::int32_t c0
+              = std::min(k, j) == split ? split : internal(split);
+          const std::int32_t c1
+              = std::max(k, j) == split + 1 ? split + 1 : internal(split + 1);
+          bboxes(internal(k), 0) = c0;
+          bboxes(internal(k), 1) = c1;
+          parent[c0] = internal(k);
+          parent[c1] = internal(k);
+        }
+      });
+
+  // Compute internal node boxes bottom-up
+  fit_internal_bboxes(bboxes, parent, coords, num_threads);
+
+  return {bboxes, coords};
 }
 //-----------------------------------------------------------------------------
 } // namespace
@@ -259,7 +282,9 @@ BoundingBoxTree::BoundingBoxTree(
   // Do nothing
 }
 //-----------------------------------------------------------------------------
-BoundingBoxTree::BoundingBoxTree(const mesh::Mesh& mesh, int tdim) : _tdim(tdim)
+BoundingBoxTree::BoundingBoxTree(const mesh::Mesh& mesh, int tdim,
+                                 int num_threads)
+    : _tdim(tdim)
 {
   // Check dimension
   if (tdim < 1 or tdim > mesh.topology().dim())
@@ -270,22 +295,127 @@ BoundingBoxTree::BoundingBoxTree(const mesh::Mesh& mesh, int tdim) : _tdim(tdim)
 
   // Initialize entities of given dimension if they don't exist
   mesh.topology_mutable().create_entities(tdim);
+  mesh.topology_mutable().create_connectivity(tdim, mesh.topology().dim());
+
+  build_local(mesh, num_threads);
+  build_global_tree(mesh);
+}
+//-----------------------------------------------------------------------------
+BoundingBoxTree::BoundingBoxTree(const std::vector<Eigen::Vector3d>& points,
+                                 int num_threads)
+    : _tdim(0)
+{
+  // Create a degenerate leaf box for each point
+  const std::int32_t num_leaves = points.size();
+  Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor> leaf_bboxes(
+      2 * num_leaves, 3);
+  for (std::int32_t i = 0; i < num_leaves; ++i)
+  {
+    leaf_bboxes.row(2 * i) = points[i].transpose();
+    leaf_bboxes.row(2 * i + 1) = points[i].transpose();
+  }
+
+  // Build the bounding box tree from the leaves
+  std::tie(_bboxes, _bbox_coordinates)
+      = build_from_leaf(leaf_bboxes, num_threads);
+  _build_cost = cost();
 
+  LOG(INFO) << "Computed bounding box tree with " << num_bboxes()
+            << " nodes for " << num_leaves << " points.";
+}
+//-----------------------------------------------------------------------------
+void BoundingBoxTree::refit(const mesh::Mesh& mesh, int num_threads)
+{
+  refit_local(mesh, num_threads);
+  build_global_tree(mesh);
+}
+//-----------------------------------------------------------------------------
+bool BoundingBoxTree::update(const mesh::Mesh& mesh, double max_cost_ratio,
+                             int num_threads)
+{
+  refit_local(mesh, num_threads);
+  const bool rebuild = cost() > max_cost_ratio * _build_cost;
+  if (rebuild)
+  {
+    LOG(INFO) << "Rebuilding bounding box tree with cost " << cost()
+              << " (cost after build " << _build_cost << ").";
+    build_local(mesh, num_threads);
+  }
+  build_global_tree(mesh);
+  return rebuild;
+}
+//-----------------------------------------------------------------------------
+double BoundingBoxTree::cost() const
+{
+  const std::int32_t num_nodes = num_bboxes();
+  const std::int32_t n = (num_nodes + 1) / 2;
+  if (n < 2)
+    return 0.0;
+
+  // Use the box surface area, or the box perimeter if the root box
+  // has no area (e.g. a one-dimensional mesh)
+  auto root = get_bbox(num_nodes - 1);
+  const bool flat = (root.row(1) - root.row(0) <= 0.0).count() >= 2;
+  auto measure = [flat](const Eigen::Array<double, 2, 3, Eigen::RowMajor>& b) {
+    const Eigen::Array<double, 1, 3> d = b.row(1) - b.row(0);
+    if (flat)
+      return d.sum();
+    else
+      return d[0] * d[1] + d[1] * d[2] + d[2] * d[0];
+  };
+
+  double sum = 0.0;
+  for (std::int32_t p = n; p < num_nodes; ++p)
+    sum += measure(get_bbox(p));
+  const double root_measure = measure(root);
+  return root_measure > 0.0 ? sum / root_measure : 0.0;
+}
+//-----------------------------------------------------------------------------
+void BoundingBoxTree::build_local(const mesh::Mesh& mesh, int num_threads)
+{
   // Create bounding boxes for all mesh entities (leaves)
-  auto map = mesh.topology().index_map(tdim);
+  auto map = mesh.topology().index_map(_tdim);
   assert(map);
   const std::int32_t num_leaves = map->size_local() + map->num_ghosts();
   Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor> leaf_bboxes(
       2 * num_leaves, 3);
-  for (int e = 0; e < num_leaves; ++e)
-    leaf_bboxes.block<2, 3>(2 * e, 0) = compute_bbox_of_entity(mesh, tdim, e);
-
-  // Recursively build the bounding box tree from the leaves
-  std::tie(_bboxes, _bbox_coordinates) = build_from_leaf(leaf_bboxes);
+  common::parallel_for(num_leaves, num_threads,
+                       [&](int, std::int32_t begin, std::int32_t end) {
+                         for (std::int32_t e = begin; e < end; ++e)
+                         {
+                           leaf_bboxes.block<2, 3>(2 * e, 0)
+                               = compute_bbox_of_entity(mesh, _tdim, e);
+                         }
+                       });
+
+  // Build the bounding box tree from the leaves
+  std::tie(_bboxes, _bbox_coordinates)
+      = build_from_leaf(leaf_bboxes, num_threads);
+  _build_cost = cost();
 
   LOG(INFO) << "Computed bounding box tree with " << num_bboxes()
             << " nodes for " << num_leaves << " entities.";
+}
+//-----------------------------------------------------------------------------
+void BoundingBoxTree::refit_local(const mesh::Mesh& mesh, int num_threads)
+{
+  if (_tdim < 1 or _tdim > mesh.topology().dim())
+    throw std::runtime_error("Only trees for mesh entities can be refitted.");
+  auto map = mesh.topology().index_map(_tdim);
+  assert(map);
+  if (map->size_local() + map->num_ghosts() != (num_bboxes() + 1) / 2)
+  {
+    throw std::runtime_error(
+        "Number of mesh entities does not match number of tree leaves.");
+  }
 
+  compute_leaf_bboxes(mesh, _tdim, _bboxes, _bbox_coordinates, num_threads);
+  fit_internal_bboxes(_bboxes, compute_parents(_bboxes, num_threads),
+                      _bbox_coordinates, num_threads);
+}
+//-----------------------------------------------------------------------------
+void BoundingBoxTree::build_global_tree(const mesh::Mesh& mesh)
+{
   // Build tree for each process
   MPI_Comm comm = mesh.mpi_comm();
   const int mpi_size = MPI::size(comm);
@@ -298,7 +428,7 @@ BoundingBoxTree::BoundingBoxTree(const mesh::Mesh& mesh, int tdim) : _tdim(tdim)
     MPI_Allgather(send_bbox.data(), 6, MPI_DOUBLE, recv_bbox.data(), 6,
                   MPI_DOUBLE, comm);
 
-    auto [global_bboxes, global_coords] = build_from_leaf(recv_bbox);
+    auto [global_bboxes, global_coords] = build_from_leaf(recv_bbox, 1);
     global_tree.reset(new BoundingBoxTree(global_bboxes, global_coords));
 
     LOG(INFO) << "Computed global bounding box tree with "
@@ -306,34 +436,6 @@ BoundingBoxTree::BoundingBoxTree(const mesh::Mesh& mesh, int tdim) : _tdim(tdim)
   }
 }
 //-----------------------------------------------------------------------------
-BoundingBoxTree::BoundingBoxTree(const std::vector<Eigen::Vector3d>& points)
-    : _tdim(0)
-{
-  // Create leaf partition (to be sorted)
-  const int num_leaves = points.size();
-  std::vector<int> leaf_partition(num_leaves);
-  std::iota(leaf_partition.begin(), leaf_partition.end(), 0);
-
-  // Recursively build the bounding box tree from the leaves
-  std::vector<std::array<int, 2>> bboxes;
-  std::vector<double> bbox_coordinates;
-  _build_from_point(points, leaf_partition.begin(), leaf_partition.end(),
-                    bboxes, bbox_coordinates);
-
-  _bboxes.resize(bboxes.size(), 2);
-  for (std::size_t i = 0; i < bboxes.size(); ++i)
-  {
-    _bboxes(i, 0) = bboxes[i][0];
-    _bboxes(i, 1) = bboxes[i][1];
-  }
-  _bbox_coordinates
-      = Eigen::Map<Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>>(
-          bbox_coordinates.data(), bbox_coordinates.size() / 3, 3);
-
-  LOG(INFO) << "Computed bounding box tree with " << num_bboxes()
-            << " nodes for " << num_leaves << " points.";
-}
-//-----------------------------------------------------------------------------
 int BoundingBoxTree::num_bboxes() const { return _bboxes.rows(); }
 //-----------------------------------------------------------------------------
 std::string BoundingBoxTree::str() const
@@ -364,9 +466,3 @@ void BoundingBoxTree::tree_print(std::stringstream& s, int i) const
   }
 }
 //-----------------------------------------------------------------------------
-Eigen::Array<double, 2, 3, Eigen::RowMajor>
-BoundingBoxTree::get_bbox(int node) const
-{
-  return _bbox_coordinates.block<2, 3>(2 * node, 0);
-}
-//-----------------------------------------------------------------------------
@@ -25,6 +25,12 @@ namespace geometry
 
 /// Axis-Aligned bounding box binary tree. It is used to find entities
 /// in a collection (often a mesh::Mesh).
+///
+/// The tree is a linear bounding volume hierarchy. The leaves are
+/// ordered along a Morton (Z-order) curve through the midpoints of
+/// their boxes and the tree is built in parallel. Leaf nodes are stored
+/// first, in Morton order, followed by the internal nodes. The root is
+/// the last node.
 
 class BoundingBoxTree
 {
@@ -34,12 +40,15 @@ public:
   /// @param[in] mesh The mesh for building the bounding box tree
   /// @param[in] tdim The topological dimension of the mesh entities to
   ///                 by the bounding box tree for
-  BoundingBoxTree(const mesh::Mesh& mesh, int tdim);
+  /// @param[in] num_threads Number of threads used to build the tree
+  BoundingBoxTree(const mesh::Mesh& mesh, int tdim, int num_threads = 1);
 
   /// Constructor
   /// @param[in] points Cloud of points to build the bounding box tree
   ///                   around
-  BoundingBoxTree(const std::vector<Eigen::Vector3d>& points);
+  /// @param[in] num_threads Number of threads used to build the tree
+  BoundingBoxTree(const std::vector<Eigen::Vector3d>& points,
+                  int num_threads = 1);
 
   /// Move constructor
   BoundingBoxTree(BoundingBoxTree&& tree) = default;
@@ -57,7 +66,39 @@ public:
   /// @param[in] node The bounding box node index
   /// @return The bounding box where row(0) is the lower corner and
   ///         row(1) is the upper corner
-  Eigen::Array<double, 2, 3, Eigen::RowMajor> get_bbox(int node) const;
+  Eigen::Array<double, 2, 3, Eigen::RowMajor> get_bbox(int node) const
+  {
+    return _bbox_coordinates.block<2, 3>(2 * node, 0);
+  }
+
+  /// Update the bounding boxes after the mesh geometry has changed,
+  /// keeping the tree structure. The leaf boxes are recomputed in
+  /// parallel and the boxes of the internal nodes are fitted
+  /// bottom-up. The mesh topology must not have changed. This is
+  /// collective.
+  /// @param[in] mesh The mesh that the tree was built for
+  /// @param[in] num_threads Number of threads
+  void refit(const mesh::Mesh& mesh, int num_threads = 1);
+
+  /// Refit the tree after the mesh geometry has changed, and rebuild
+  /// it if its quality has degraded, i.e. if cost() has grown by more
+  /// than a factor @p max_cost_ratio since the tree was built. This is
+  /// collective.
+  /// @param[in] mesh The mesh that the tree was built for
+  /// @param[in] max_cost_ratio Rebuild the tree if its cost exceeds
+  ///   the cost after the last build by this factor
+  /// @param[in] num_threads Number of threads
+  /// @return True if the tree was rebuilt
+  bool update(const mesh::Mesh& mesh, double max_cost_ratio = 1.5,
+              int num_threads = 1);
+
+  /// Quality of the tree, measured by the surface area heuristic
+  /// (SAH): the sum of the surface areas of the internal node boxes
+  /// relative to the surface area of the root box. It is proportional
+  /// to the expected number of internal nodes visited by a query, and
+  /// grows when the tree degrades after refitting.
+  /// @return The cost of the tree
+  double cost() const;
 
   /// Return number of bounding boxes
   int num_bboxes() const;
@@ -87,9 +128,22 @@ private:
       const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>&
           bbox_coords);
 
+  // Build the tree for the entities of dimension _tdim of a mesh
+  void build_local(const mesh::Mesh& mesh, int num_threads);
+
+  // Refit the tree for the entities of dimension _tdim of a mesh
+  void refit_local(const mesh::Mesh& mesh, int num_threads);
+
+  // Build the global tree of the process root boxes, if the mesh is
+  // distributed
+  void build_global_tree(const mesh::Mesh& mesh);
+
   // Topological dimension of leaf entities
   int _tdim;
 
+  // Cost of the tree after it was built
+  double _build_cost = 0.0;
+
   // Print out recursively, for debugging
   void tree_print(std::stringstream& s, int i) const;
 
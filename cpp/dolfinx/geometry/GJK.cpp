@@ -15,30 +15,31 @@ using namespace dolfinx;
 
 namespace
 {
-// Find the resulting sub-simplex of the input simplex which is nearest to the
-// origin. Also, return the shortest vector from the origin to the resulting
-// simplex.
-std::pair<Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>,
-          Eigen::Vector3d>
-nearest_simplex(
-    const Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor, 4, 3>& s)
+// Simplex with up to four vertices, stored in the first rows of a
+// fixed-size matrix to avoid dynamic memory allocation
+using Simplex = Eigen::Matrix<double, 4, 3, Eigen::RowMajor>;
+
+// Find the sub-simplex of the input simplex with n vertices which is
+// nearest to the origin. The simplex and n are replaced by the
+// sub-simplex, and the shortest vector from the origin to the
+// sub-simplex is returned.
+Eigen::Vector3d nearest_simplex(Simplex& s, int& n)
 {
-  if (s.rows() == 2)
+  if (n == 2)
   {
     const Eigen::Vector3d ab = s.row(1) - s.row(0);
     const double lm = -s.row(0).dot(ab) / ab.squaredNorm();
     if (lm >= 0.0 and lm <= 1.0)
     {
       // The origin is between A and B
-      Eigen::Vector3d v = s.row(0).transpose() + lm * ab;
-      return {s.topRows(2), v};
+      return s.row(0).transpose() + lm * ab;
     }
-    if (lm < 0.0)
-      return {s.row(0), s.row(0)};
-    else
-      return {s.row(1), s.row(1)};
+    n = 1;
+    if (!(lm < 0.0))
+      s.row(0) = s.row(1);
+    return s.row(0);
   }
-  else if (s.rows() == 4)
+  else if (n == 4)
   {
     Eigen::Vector4d B;
     const Eigen::Vector3d W1 = s.row(0).cross(s.row(1));
@@ -55,14 +56,16 @@ nearest_simplex(
     if (f_inside[1] and f_inside[2] and f_inside[3])
     {
       if (f_inside[0]) // The origin is inside the tetrahedron
-        return {s, Eigen::Vector3d::Zero()};
+        return Eigen::Vector3d::Zero();
 
       // The origin projection P faces BCD
-      return nearest_simplex(s.topRows(3));
+      n = 3;
+      return nearest_simplex(s, n);
     }
 
     // Test ACD, ABD and/or ABC.
-    Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> smin;
+    Simplex smin;
+    int nmin = 0;
     Eigen::Vector3d vmin = {0, 0, 0};
     static const int facets[3][3] = {{0, 1, 3}, {0, 2, 3}, {1, 2, 3}};
     double qmin = std::numeric_limits<double>::max();
@@ -70,25 +73,30 @@ nearest_simplex(
     {
       if (f_inside[i + 1] == false)
       {
-        Eigen::Matrix<double, 3, 3, Eigen::RowMajor> M;
-        M << s.row(facets[i][0]), s.row(facets[i][1]), s.row(facets[i][2]);
-        auto [snew, v] = nearest_simplex(M);
+        Simplex M;
+        M << s.row(facets[i][0]), s.row(facets[i][1]), s.row(facets[i][2]),
+            0, 0, 0;
+        int nnew = 3;
+        const Eigen::Vector3d v = nearest_simplex(M, nnew);
         const double q = v.squaredNorm();
         if (q < qmin)
         {
           qmin = q;
           vmin = v;
-          smin = snew;
+          smin = M;
+          nmin = nnew;
         }
       }
     }
-    return {smin, vmin};
+    s = smin;
+    n = nmin;
+    return vmin;
   }
 
-  assert(s.rows() == 3);
-  const auto a = s.row(0);
-  const auto b = s.row(1);
-  const auto c = s.row(2);
+  assert(n == 3);
+  const Eigen::Vector3d a = s.row(0);
+  const Eigen::Vector3d b = s.row(1);
+  const Eigen::Vector3d c = s.row(2);
   const double ab2 = (a - b).squaredNorm();
   const double ac2 = (a - c).squaredNorm();
   const double bc2 = (b - c).squaredNorm();
@@ -111,20 +119,19 @@ nearest_simplex(
     Eigen::Vector3d p = (a + b + c) / 3.0;
     // Renormalise n in plane of ABC
     v *= v.dot(p) / v.squaredNorm();
-    return {s, v};
+    return v;
   }
 
   // Get closest point
-  int i;
-  s.rowwise().squaredNorm().minCoeff(&i);
-  Eigen::Vector3d vmin = s.row(i);
+  int imin;
+  s.topRows(3).rowwise().squaredNorm().minCoeff(&imin);
+  Eigen::Vector3d vmin = s.row(imin);
   double qmin = vmin.squaredNorm();
-  Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> smin
-      = vmin.transpose();
+  int edge = -1;
 
   // Check if edges are closer
   static const int f[3][2] = {{0, 1}, {0, 2}, {1, 2}};
-  for (int i = 0; i < s.rows(); ++i)
+  for (int i = 0; i < 3; ++i)
   {
     if (lm[i] > 0 and lm[i] < 1)
     {
@@ -135,14 +142,26 @@ nearest_simplex(
       {
         vmin = v;
         qmin = qnorm;
-        smin.resize(2, 3);
-        smin.row(0) = s.row(f[i][0]);
-        smin.row(1) = s.row(f[i][1]);
+        edge = i;
       }
     }
   }
 
-  return {smin, vmin};
+  if (edge < 0)
+  {
+    s.row(0) = vmin.transpose();
+    n = 1;
+  }
+  else
+  {
+    const Eigen::RowVector3d e0 = s.row(f[edge][0]);
+    const Eigen::RowVector3d e1 = s.row(f[edge][1]);
+    s.row(0) = e0;
+    s.row(1) = e1;
+    n = 2;
+  }
+
+  return vmin;
 }
 //-------------------------------------------------------------------------------
 // Support function, finds point p in bd which maximises p.v
@@ -176,8 +195,9 @@ Eigen::Vector3d geometry::compute_distance_gjk(
 
   // Initialise vector and simplex
   Eigen::Vector3d v = p.row(0) - q.row(0);
-  Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor, 4, 3> s
-      = v.transpose();
+  Simplex s;
+  s.row(0) = v.transpose();
+  int n = 1;
 
   // Begin GJK iteration
   int k;
@@ -188,12 +208,12 @@ Eigen::Vector3d geometry::compute_distance_gjk(
 
     // Break if any existing points are the same as w
     int m;
-    for (m = 0; m < s.rows(); ++m)
+    for (m = 0; m < n; ++m)
     {
       if (s(m, 0) == w[0] and s(m, 1) == w[1] and s(m, 2) == w[2])
         break;
     }
-    if (m != s.rows())
+    if (m != n)
       break;
 
     // 1st exit condition (v-w).v = 0
@@ -203,11 +223,11 @@ Eigen::Vector3d geometry::compute_distance_gjk(
       break;
 
     // Add new vertex to simplex
-    s.conservativeResize(s.rows() + 1, 3);
-    s.bottomRows(1) = w.transpose();
+    assert(n < 4);
+    s.row(n++) = w.transpose();
 
     // Find nearest subset of simplex
-    std::tie(s, v) = nearest_simplex(s);
+    v = nearest_simplex(s, n);
 
     // 2nd exit condition - intersecting or touching
     if (v.squaredNorm() < eps * eps)
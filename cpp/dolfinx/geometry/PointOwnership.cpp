@@ -0,0 +1,227 @@
+// Copyright (C) 2020 agent
+//
+// This file is part of DOLFINX (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "PointOwnership.h"
+#include "BoundingBoxTree.h"
+#include "utils.h"
+#include <algorithm>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/Timer.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/Topology.h>
+#include <numeric>
+#include <set>
+
+using namespace dolfinx;
+using namespace dolfinx::geometry;
+
+namespace
+{
+//-----------------------------------------------------------------------------
+// Create a neighborhood communicator
+MPI_Comm create_neighbor_comm(MPI_Comm comm, const std::vector<int>& sources,
+                              const std::vector<int>& dests)
+{
+  MPI_Comm neighbor_comm;
+  std::vector<int> sourceweights(sources.size(), 1);
+  std::vector<int> destweights(dests.size(), 1);
+  MPI_Dist_graph_create_adjacent(comm, sources.size(), sources.data(),
+                                 sourceweights.data(), dests.size(),
+                                 dests.data(), destweights.data(),
+                                 MPI_INFO_NULL, false, &neighbor_comm);
+  return neighbor_comm;
+}
+//-----------------------------------------------------------------------------
+// Compute displacements from sizes. The returned array has one more
+// entry than sizes.
+std::vector<int> compute_disp(const std::vector<int>& sizes)
+{
+  std::vector<int> disp(sizes.size() + 1, 0);
+  std::partial_sum(sizes.begin(), sizes.end(), disp.begin() + 1);
+  return disp;
+}
+//-----------------------------------------------------------------------------
+} // namespace
+
+//-----------------------------------------------------------------------------
+PointOwnership::PointOwnership(
+    const mesh::Mesh& mesh, const BoundingBoxTree& tree,
+    const Eigen::Ref<const Eigen::Array<double, Eigen::Dynamic, 3,
+                                        Eigen::RowMajor>>& points,
+    int num_threads)
+    : _comm(MPI_COMM_NULL)
+{
+  common::Timer timer("Compute point ownership");
+
+  MPI_Comm comm = mesh.mpi_comm();
+  const int rank = dolfinx::MPI::rank(comm);
+  const std::int32_t num_points = points.rows();
+
+  // Find candidate processes for each point from the process bounding
+  // boxes
+  graph::AdjacencyList<std::int32_t> candidates(0);
+  if (tree.global_tree)
+    candidates = compute_collisions(*tree.global_tree, points, num_threads);
+  else
+  {
+    Eigen::Array<std::int32_t, Eigen::Dynamic, 1> offsets(num_points + 1);
+    std::iota(offsets.data(), offsets.data() + offsets.rows(), 0);
+    Eigen::Array<std::int32_t, Eigen::Dynamic, 1> ranks
+        = Eigen::Array<std::int32_t, Eigen::Dynamic, 1>::Constant(num_points,
+                                                                  rank);
+    candidates = graph::AdjacencyList<std::int32_t>(std::move(ranks),
+                                                    std::move(offsets));
+  }
+
+  // Create neighborhood communicators for sending points to candidate
+  // processes (forward) and sending data back (reverse)
+  const Eigen::Array<std::int32_t, Eigen::Dynamic, 1>& candidate_ranks
+      = candidates.array();
+  const std::set<int> dest_set(candidate_ranks.data(),
+                               candidate_ranks.data()
+                                   + candidate_ranks.rows());
+  const std::vector<int> dests(dest_set.begin(), dest_set.end());
+  const std::vector<int> sources
+      = dolfinx::MPI::compute_graph_edges(comm, dest_set);
+  dolfinx::MPI::Comm comm_fwd(create_neighbor_comm(comm, sources, dests),
+                              false);
+  _comm = dolfinx::MPI::Comm(create_neighbor_comm(comm, dests, sources),
+                             false);
+
+  // Pack points for each candidate process, and remember the point
+  // index of each entry in the send buffer
+  std::vector<int> send_sizes(dests.size(), 0);
+  for (Eigen::Index i = 0; i < candidate_ranks.rows(); ++i)
+  {
+    const auto it
+        = std::lower_bound(dests.begin(), dests.end(), candidate_ranks[i]);
+    ++send_sizes[std::distance(dests.begin(), it)];
+  }
+  std::vector<int> send_disp = compute_disp(send_sizes);
+  std::vector<std::int32_t> send_points(send_disp.back());
+  Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor> send_x(
+      send_disp.back(), 3);
+  {
+    std::vector<int> pos(send_disp.begin(), send_disp.end() - 1);
+    for (std::int32_t i = 0; i < num_points; ++i)
+    {
+      for (std::int32_t r : candidates.links(i))
+      {
+        const auto it = std::lower_bound(dests.begin(), dests.end(), r);
+        const int p = pos[std::distance(dests.begin(), it)]++;
+        send_points[p] = i;
+        send_x.row(p) = points.row(i);
+      }
+    }
+  }
+
+  // Send points to candidate processes
+  std::vector<int> recv_sizes(sources.size());
+  MPI_Neighbor_alltoall(send_sizes.data(), 1, MPI_INT, recv_sizes.data(), 1,
+                        MPI_INT, comm_fwd.comm());
+  std::vector<int> recv_disp = compute_disp(recv_sizes);
+  Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor> recv_x(
+      recv_disp.back(), 3);
+  MPI_Datatype point_type;
+  MPI_Type_contiguous(3, MPI_DOUBLE, &point_type);
+  MPI_Type_commit(&point_type);
+  MPI_Neighbor_alltoallv(send_x.data(), send_sizes.data(), send_disp.data(),
+                         point_type, recv_x.data(), recv_sizes.data(),
+                         recv_disp.data(), point_type, comm_fwd.comm());
+  MPI_Type_free(&point_type);
+
+  // Locate received points in the cells owned by this process
+  const int tdim = mesh.topology().dim();
+  auto cell_map = mesh.topology().index_map(tdim);
+  assert(cell_map);
+  const std::int32_t num_owned_cells = cell_map->size_local();
+  const graph::AdjacencyList<std::int32_t> colliding_cells
+      = select_colliding_cells(mesh,
+                               compute_collisions(tree, recv_x, num_threads),
+                               recv_x, num_threads);
+  std::vector<std::int32_t> recv_cells(recv_x.rows(), -1);
+  std::vector<std::uint8_t> found(recv_x.rows(), 0);
+  for (Eigen::Index i = 0; i < recv_x.rows(); ++i)
+  {
+    for (std::int32_t c : colliding_cells.links(i))
+    {
+      if (c < num_owned_cells)
+      {
+        recv_cells[i] = c;
+        found[i] = 1;
+        break;
+      }
+    }
+  }
+
+  // Send back whether each point was found
+  std::vector<std::uint8_t> send_found(send_disp.back());
+  MPI_Neighbor_alltoallv(found.data(), recv_sizes.data(), recv_disp.data(),
+                         MPI_UINT8_T, send_found.data(), send_sizes.data(),
+                         send_disp.data(), MPI_UINT8_T, _comm.comm());
+
+  // Choose the lowest candidate rank that found each point as the owner
+  std::vector<int> owner(num_points, -1);
+  for (std::size_t d = 0; d < dests.size(); ++d)
+  {
+    for (int p = send_disp[d]; p < send_disp[d + 1]; ++p)
+    {
+      if (send_found[p] and owner[send_points[p]] < 0)
+        owner[send_points[p]] = dests[d];
+    }
+  }
+
+  // Tell candidate processes whether they own each point, and compute
+  // the position of the value of each point in the data that is sent
+  // back
+  std::vector<std::uint8_t> owned(send_disp.back(), 0);
+  _positions.assign(num_points, -1);
+  _recv_sizes.assign(dests.size(), 0);
+  std::int32_t num_owned = 0;
+  for (std::size_t d = 0; d < dests.size(); ++d)
+  {
+    for (int p = send_disp[d]; p < send_disp[d + 1]; ++p)
+    {
+      if (owner[send_points[p]] == dests[d])
+      {
+        owned[p] = 1;
+        _positions[send_points[p]] = num_owned++;
+        ++_recv_sizes[d];
+      }
+    }
+  }
+  _recv_disp = compute_disp(_recv_sizes);
+
+  std::vector<std::uint8_t> recv_owned(recv_disp.back());
+  MPI_Neighbor_alltoallv(owned.data(), send_sizes.data(), send_disp.data(),
+                         MPI_UINT8_T, recv_owned.data(), recv_sizes.data(),
+                         recv_disp.data(), MPI_UINT8_T, comm_fwd.comm());
+
+  // Keep the received points that this process owns
+  const std::int32_t num_owned_points
+      = std::count(recv_owned.begin(), recv_owned.end(), 1);
+  _x.resize(num_owned_points, 3);
+  _cells.resize(num_owned_points);
+  _send_sizes.assign(sources.size(), 0);
+  std::int32_t pos = 0;
+  for (std::size_t s = 0; s < sources.size(); ++s)
+  {
+    for (int p = recv_disp[s]; p < recv_disp[s + 1]; ++p)
+    {
+      if (recv_owned[p])
+      {
+        assert(recv_cells[p] >= 0);
+        _x.row(pos) = recv_x.row(p);
+        _cells[pos] = recv_cells[p];
+        ++pos;
+        ++_send_sizes[s];
+      }
+    }
+  }
+  _send_disp = compute_disp(_send_sizes);
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,162 @@
+// Copyright (C) 2020 agent
+//
+// This file is part of DOLFINX (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cstdint>
+#include <dolfinx/common/MPI.h>
+#include <stdexcept>
+#include <vector>
+
+namespace dolfinx
+{
+
+namespace mesh
+{
+class Mesh;
+} // namespace mesh
+
+namespace geometry
+{
+class BoundingBoxTree;
+
+/// This class computes the process and cell that own each point in a
+/// list of points, where the points may be located on any process. The
+/// points are sent to the processes whose bounding boxes contain them
+/// and located there. A point is owned by the process with the lowest
+/// rank that has an owned cell containing the point.
+///
+/// The communication pattern is computed once, so that values at the
+/// points, e.g. of a function::Function, can be repeatedly computed on
+/// the owning processes and sent back with one neighborhood
+/// communication.
+
+class PointOwnership
+{
+public:
+  /// Compute the owner of each point. This is collective.
+  /// @param[in] mesh The mesh
+  /// @param[in] tree A bounding box tree for the cells of the mesh
+  /// @param[in] points The points on this process (shape=(num_points,
+  ///   3))
+  /// @param[in] num_threads Number of threads used to locate the points
+  PointOwnership(
+      const mesh::Mesh& mesh, const BoundingBoxTree& tree,
+      const Eigen::Ref<const Eigen::Array<double, Eigen::Dynamic, 3,
+                                          Eigen::RowMajor>>& points,
+      int num_threads = 1);
+
+  /// Copy constructor
+  PointOwnership(const PointOwnership& plan) = default;
+
+  /// Move constructor
+  PointOwnership(PointOwnership&& plan) = default;
+
+  /// Destructor
+  ~PointOwnership() = default;
+
+  /// Number of points passed to the constructor on this process
+  std::int32_t num_points() const { return _positions.size(); }
+
+  /// Number of points on this process that are not owned by any process
+  std::int32_t num_lost_points() const
+  {
+    return std::count(_positions.begin(), _positions.end(), -1);
+  }
+
+  /// The points owned by this process, which may have been passed to
+  /// the constructor on any process
+  const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>&
+  owned_points() const
+  {
+    return _x;
+  }
+
+  /// The (local) cell that contains each owned point
+  const Eigen::Array<std::int32_t, Eigen::Dynamic, 1>& cells() const
+  {
+    return _cells;
+  }
+
+  /// Send values computed at the owned points to the processes that
+  /// passed the points to the constructor. This is collective.
+  /// @param[in] values The values at the owned points
+  ///   (shape=(num_owned_points, value_size))
+  /// @param[out] u The values at the points passed to the constructor
+  ///   on this process (shape=(num_points, value_size)). Values for
+  ///   points that are not owned by any process are set to zero.
+  template <typename T>
+  void send_values(
+      const Eigen::Ref<const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic,
+                                          Eigen::RowMajor>>& values,
+      Eigen::Ref<
+          Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
+          u) const;
+
+private:
+  // Neighborhood communicator from the processes that own points to
+  // the processes that passed the points to the constructor
+  dolfinx::MPI::Comm _comm;
+
+  // Owned points and the cell that contains each owned point
+  Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor> _x;
+  Eigen::Array<std::int32_t, Eigen::Dynamic, 1> _cells;
+
+  // Number of owned points to send to each out-neighbor on _comm, and
+  // the displacement of the points (ordered by neighbor)
+  std::vector<int> _send_sizes, _send_disp;
+
+  // Number of points received from each in-neighbor on _comm, and the
+  // displacement of the points in the receive buffer
+  std::vector<int> _recv_sizes, _recv_disp;
+
+  // Position of each point passed to the constructor in the receive
+  // buffer, or -1 if the point is not owned by any process
+  std::vector<std::int32_t> _positions;
+};
+
+//-----------------------------------------------------------------------------
+template <typename T>
+void PointOwnership::send_values(
+    const Eigen::Ref<const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic,
+                                        Eigen::RowMajor>>& values,
+    Eigen::Ref<Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
+        u) const
+{
+  if (values.rows() != _x.rows())
+  {
+    throw std::runtime_error(
+        "Number of values does not match number of owned points.");
+  }
+  if (u.rows() != num_points() or u.cols() != values.cols())
+    throw std::runtime_error("Value array has the wrong shape.");
+
+  // Send values of each point as a block
+  MPI_Datatype block;
+  MPI_Type_contiguous(values.cols(), dolfinx::MPI::mpi_type<T>(), &block);
+  MPI_Type_commit(&block);
+
+  Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> recv_values(
+      _recv_disp.back(), values.cols());
+  MPI_Neighbor_alltoallv(values.data(), _send_sizes.data(), _send_disp.data(),
+                         block, recv_values.data(), _recv_sizes.data(),
+                         _recv_disp.data(), block, _comm.comm());
+  MPI_Type_free(&block);
+
+  for (std::size_t i = 0; i < _positions.size(); ++i)
+  {
+    if (_positions[i] < 0)
+      u.row(i).setZero();
+    else
+      u.row(i) = recv_values.row(_positions[i]);
+  }
+}
+//-----------------------------------------------------------------------------
+
+} // namespace geometry
+} // namespace dolfinx
@@ -13,3 +13,4 @@ namespace dolfinx
 
 #include <dolfinx/geometry/BoundingBoxTree.h>
 #include <dolfinx/geometry/GJK.h>
+#include <dolfinx/geometry/PointOwnership.h>
@@ -8,17 +8,34 @@
 #include "utils.h"
 #include "BoundingBoxTree.h"
 #include "GJK.h"
+#include <algorithm>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/log.h>
+#include <dolfinx/common/utils.h>
 #include <dolfinx/mesh/Geometry.h>
 #include <dolfinx/mesh/Mesh.h>
+#include <dolfinx/mesh/cell_types.h>
 #include <dolfinx/mesh/utils.h>
+#include <limits>
 
 using namespace dolfinx;
 
 namespace
 {
 //-----------------------------------------------------------------------------
+// Spread the lowest 21 bits of x so that there are two zero bits
+// between consecutive bits
+std::uint64_t expand_bits(std::uint64_t x)
+{
+  x &= 0x1fffff;
+  x = (x | x << 32) & 0x1f00000000ffff;
+  x = (x | x << 16) & 0x1f0000ff0000ff;
+  x = (x | x << 8) & 0x100f00f00f00f00f;
+  x = (x | x << 4) & 0x10c30c30c30c30c3;
+  x = (x | x << 2) & 0x1249249249249249;
+  return x;
+}
+//-----------------------------------------------------------------------------
 // Check whether bounding box is a leaf node
 inline bool is_leaf(const std::array<int, 2>& bbox, int node)
 {
@@ -44,6 +61,13 @@ bool bbox_in_bbox(const Eigen::Array<double, 2, 3, Eigen::RowMajor>& a,
          and (b.row(1) + eps0 >= a.row(0)).all();
 }
 //-----------------------------------------------------------------------------
+// Squared length of the diagonal of a bounding box
+double bbox_size(const geometry::BoundingBoxTree& tree, int node)
+{
+  const Eigen::Array<double, 2, 3, Eigen::RowMajor> b = tree.get_bbox(node);
+  return (b.row(1) - b.row(0)).square().sum();
+}
+//-----------------------------------------------------------------------------
 // Compute closest entity {closest_entity, R2} (recursive)
 std::pair<int, double>
 _compute_closest_entity(const geometry::BoundingBoxTree& tree,
@@ -131,37 +155,125 @@ _compute_closest_point(const geometry::BoundingBoxTree& tree,
   }
 }
 //-----------------------------------------------------------------------------
-// Compute collisions with point (recursive)
+// Check whether a point is in the bounding boxes of the two children
+// of a node. Both boxes are tested together with fixed-size array
+// operations.
+std::array<bool, 2> point_in_child_bboxes(const geometry::BoundingBoxTree& tree,
+                                          const std::array<int, 2>& children,
+                                          const Eigen::Vector3d& x)
+{
+  const double rtol = 1e-14;
+  const Eigen::Array<double, 2, 3, Eigen::RowMajor> b0
+      = tree.get_bbox(children[0]);
+  const Eigen::Array<double, 2, 3, Eigen::RowMajor> b1
+      = tree.get_bbox(children[1]);
+  Eigen::Array<double, 2, 3, Eigen::RowMajor> lower, upper;
+  lower << b0.row(0), b1.row(0);
+  upper << b0.row(1), b1.row(1);
+  const Eigen::Array<double, 2, 3, Eigen::RowMajor> eps
+      = rtol * (upper - lower);
+  const Eigen::Array<double, 2, 3, Eigen::RowMajor> p
+      = x.transpose().array().replicate<2, 1>();
+  const Eigen::Array<bool, 2, 1> in
+      = ((p >= lower - eps) && (p <= upper + eps)).rowwise().all();
+  return {in[0], in[1]};
+}
+//-----------------------------------------------------------------------------
+// Compute collisions with point. The tree is traversed depth-first
+// using a stack and the children of a node are tested before they are
+// visited. The colliding entities are appended to the list of
+// entities.
 void _compute_collisions_point(const geometry::BoundingBoxTree& tree,
-                               const Eigen::Vector3d& p, int node,
+                               const Eigen::Vector3d& p,
+                               std::vector<int>& stack,
                                std::vector<int>& entities)
 {
-  // Get children of current bounding box node
-  const std::array bbox = tree.bbox(node);
-
-  if (!point_in_bbox(tree.get_bbox(node), p))
-  {
-    // If point is not in bounding box, then don't search further
+  const int root = tree.num_bboxes() - 1;
+  if (root < 0 or !point_in_bbox(tree.get_bbox(root), p))
     return;
-  }
-  else if (is_leaf(bbox, node))
-  {
-    // If box is a leaf (which we know contains the point), then add it
 
-    // child_1 denotes entity for leaves
-    const int entity_index = bbox[1];
-
-    // Add the candidate
-    entities.push_back(entity_index);
-  }
-  else
+  stack.assign(1, root);
+  while (!stack.empty())
   {
-    // Check both children
-    _compute_collisions_point(tree, p, bbox[0], entities);
-    _compute_collisions_point(tree, p, bbox[1], entities);
+    const int node = stack.back();
+    stack.pop_back();
+
+    // Get children of current bounding box node
+    const std::array bbox = tree.bbox(node);
+    if (is_leaf(bbox, node))
+    {
+      // If box is a leaf (which we know contains the point), then add
+      // it. child_1 denotes entity for leaves.
+      entities.push_back(bbox[1]);
+    }
+    else
+    {
+      // Descend into the children that contain the point, with the
+      // first child visited first
+      const std::array<bool, 2> in = point_in_child_bboxes(tree, bbox, p);
+      if (in[1])
+        stack.push_back(bbox[1]);
+      if (in[0])
+        stack.push_back(bbox[0]);
+    }
   }
 }
 //-----------------------------------------------------------------------------
+// Compute a list of links for each point, in parallel. The points are
+// processed in Morton order so that consecutive points on a thread are
+// close in space. The function fn(thread, i, links) appends the links
+// of point i to links. The links computed on each thread are collected
+// in one buffer per thread and then copied into the adjacency list.
+template <typename Fn>
+graph::AdjacencyList<std::int32_t> compute_point_links(
+    const Eigen::Ref<const Eigen::Array<double, Eigen::Dynamic, 3,
+                                        Eigen::RowMajor>>& points,
+    int num_threads, Fn fn)
+{
+  const std::int32_t num_points = points.rows();
+  const std::vector<std::uint64_t> codes
+      = geometry::compute_morton_codes(points, num_threads);
+  const std::vector<std::int32_t> order
+      = common::sort_rows_by_perm(codes.data(), num_points, 1, num_threads);
+
+  // Compute links of each point, and the position of the links in the
+  // buffer of the thread
+  std::vector<std::vector<std::int32_t>> links(num_threads);
+  std::vector<std::int32_t> pos(num_points);
+  Eigen::Array<std::int32_t, Eigen::Dynamic, 1> offsets(num_points + 1);
+  offsets[0] = 0;
+  common::parallel_for(
+      num_points, num_threads,
+      [&](int t, std::int32_t begin, std::int32_t end) {
+        for (std::int32_t k = begin; k < end; ++k)
+        {
+          const std::int32_t i = order[k];
+          pos[i] = links[t].size();
+          fn(t, i, links[t]);
+          offsets[i + 1] = links[t].size() - pos[i];
+        }
+      });
+  std::partial_sum(offsets.data(), offsets.data() + offsets.rows(),
+                   offsets.data());
+
+  // Copy links into the adjacency list. The points are divided between
+  // threads in the same way as above.
+  Eigen::Array<std::int32_t, Eigen::Dynamic, 1> array(offsets[num_points]);
+  common::parallel_for(
+      num_points, num_threads,
+      [&](int t, std::int32_t begin, std::int32_t end) {
+        for (std::int32_t k = begin; k < end; ++k)
+        {
+          const std::int32_t i = order[k];
+          std::copy_n(links[t].data() + pos[i], offsets[i + 1] - offsets[i],
+                      array.data() + offsets[i]);
+        }
+      });
+
+  return graph::AdjacencyList<std::int32_t>(std::move(array),
+                                            std::move(offsets));
+}
+//-----------------------------------------------------------------------------
 // Compute collisions with tree (recursive)
 void _compute_collisions_tree(const geometry::BoundingBoxTree& A,
                               const geometry::BoundingBoxTree& B, int node_A,
@@ -197,12 +309,10 @@ void _compute_collisions_tree(const geometry::BoundingBoxTree& A,
     _compute_collisions_tree(A, B, bbox_A[0], node_B, entities);
     _compute_collisions_tree(A, B, bbox_A[1], node_B, entities);
   }
-  else if (node_A > node_B)
+  else if (bbox_size(A, node_A) > bbox_size(B, node_B))
   {
-    // At this point, we know neither is a leaf so descend the largest
-    // tree first. Note that nodes are added in reverse order with the top
-    // bounding box at the end so the largest tree (the one with the the
-    // most boxes left to traverse) has the largest node number.
+    // At this point, we know neither is a leaf so descend the node
+    // with the larger box first
     _compute_collisions_tree(A, B, bbox_A[0], node_B, entities);
     _compute_collisions_tree(A, B, bbox_A[1], node_B, entities);
   }
@@ -217,6 +327,75 @@ void _compute_collisions_tree(const geometry::BoundingBoxTree& A,
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+// Tabulate the geometry dofs of the closure of each local entity of
+// dimension dim of a cell. Returns an empty list if dim is the
+// topological dimension. Otherwise the entity-cell and cell-entity
+// connectivity is created.
+std::vector<Eigen::Array<int, Eigen::Dynamic, 1>>
+tabulate_entity_closure_dofs(const mesh::Mesh& mesh, int dim)
+{
+  const int tdim = mesh.topology().dim();
+  if (dim == tdim)
+    return {};
+
+  mesh.topology_mutable().create_connectivity(dim, tdim);
+  mesh.topology_mutable().create_connectivity(tdim, dim);
+  const int num_entities
+      = mesh::cell_num_entities(mesh.topology().cell_type(), dim);
+  std::vector<Eigen::Array<int, Eigen::Dynamic, 1>> closure_dofs;
+  for (int i = 0; i < num_entities; ++i)
+  {
+    closure_dofs.push_back(
+        mesh.geometry().cmap().dof_layout().entity_closure_dofs(dim, i));
+  }
+  return closure_dofs;
+}
+//-----------------------------------------------------------------------------
+// Copy the coordinates of the geometry nodes of a mesh entity into
+// nodes. The closure dofs must have been computed by
+// tabulate_entity_closure_dofs.
+void get_entity_nodes(
+    const mesh::Mesh& mesh, int dim,
+    const std::vector<Eigen::Array<int, Eigen::Dynamic, 1>>& closure_dofs,
+    std::int32_t index,
+    Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>& nodes)
+{
+  const int tdim = mesh.topology().dim();
+  const graph::AdjacencyList<std::int32_t>& x_dofmap
+      = mesh.geometry().dofmap();
+  const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& x
+      = mesh.geometry().x();
+  if (dim == tdim)
+  {
+    auto dofs = x_dofmap.links(index);
+    nodes.resize(dofs.rows(), 3);
+    for (int i = 0; i < dofs.rows(); ++i)
+      nodes.row(i) = x.row(dofs[i]).matrix();
+    return;
+  }
+
+  // Find attached cell and local number of entity wrt cell
+  auto e_to_c = mesh.topology().connectivity(dim, tdim);
+  assert(e_to_c);
+  assert(e_to_c->num_links(index) > 0);
+  const std::int32_t c = e_to_c->links(index)[0];
+  auto c_to_e = mesh.topology().connectivity(tdim, dim);
+  assert(c_to_e);
+  auto cell_entities = c_to_e->links(c);
+  const auto* it0 = std::find(
+      cell_entities.data(), cell_entities.data() + cell_entities.rows(), index);
+  assert(it0 != (cell_entities.data() + cell_entities.rows()));
+  const int local_cell_entity = std::distance(cell_entities.data(), it0);
+
+  // Copy the nodes of the entity
+  auto dofs = x_dofmap.links(c);
+  const Eigen::Array<int, Eigen::Dynamic, 1>& entity_dofs
+      = closure_dofs[local_cell_entity];
+  nodes.resize(entity_dofs.rows(), 3);
+  for (int i = 0; i < entity_dofs.rows(); ++i)
+    nodes.row(i) = x.row(dofs[entity_dofs[i]]).matrix();
+}
 } // namespace
 
 //-----------------------------------------------------------------------------
@@ -256,11 +435,79 @@ geometry::compute_collisions(const BoundingBoxTree& tree0,
 std::vector<int> geometry::compute_collisions(const BoundingBoxTree& tree,
                                               const Eigen::Vector3d& p)
 {
-  std::vector<int> entities;
-  _compute_collisions_point(tree, p, tree.num_bboxes() - 1, entities);
+  std::vector<int> stack, entities;
+  _compute_collisions_point(tree, p, stack, entities);
   return entities;
 }
 //-----------------------------------------------------------------------------
+graph::AdjacencyList<std::int32_t> geometry::compute_collisions(
+    const BoundingBoxTree& tree,
+    const Eigen::Ref<const Eigen::Array<double, Eigen::Dynamic, 3,
+                                        Eigen::RowMajor>>& points,
+    int num_threads)
+{
+  std::vector<std::vector<int>> stacks(num_threads);
+  return compute_point_links(
+      points, num_threads,
+      [&](int t, std::int32_t i, std::vector<std::int32_t>& entities) {
+        const Eigen::Vector3d p = points.row(i).transpose().matrix();
+        _compute_collisions_point(tree, p, stacks[t], entities);
+      });
+}
+//-----------------------------------------------------------------------------
+std::vector<std::uint64_t> geometry::compute_morton_codes(
+    const Eigen::Ref<const Eigen::Array<double, Eigen::Dynamic, 3,
+                                        Eigen::RowMajor>>& points,
+    int num_threads)
+{
+  const std::int32_t num_points = points.rows();
+  std::vector<std::uint64_t> codes(num_points);
+  if (num_points == 0)
+    return codes;
+
+  // Compute range of points
+  Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor> range(
+      2 * num_threads, 3);
+  common::parallel_for(
+      num_points, num_threads,
+      [&](int t, std::int32_t begin, std::int32_t end) {
+        range.row(2 * t) = std::numeric_limits<double>::max();
+        range.row(2 * t + 1) = std::numeric_limits<double>::lowest();
+        for (std::int32_t i = begin; i < end; ++i)
+        {
+          range.row(2 * t) = range.row(2 * t).min(points.row(i));
+          range.row(2 * t + 1) = range.row(2 * t + 1).max(points.row(i));
+        }
+      });
+  Eigen::Array<double, 2, 3, Eigen::RowMajor> x_range = range.topRows(2);
+  for (int t = 1; t < num_threads; ++t)
+  {
+    x_range.row(0) = x_range.row(0).min(range.row(2 * t));
+    x_range.row(1) = x_range.row(1).max(range.row(2 * t + 1));
+  }
+
+  // Compute code, with 21 bits for each coordinate
+  const double scale = (1 << 21) - 1;
+  common::parallel_for(
+      num_points, num_threads,
+      [&](int, std::int32_t begin, std::int32_t end) {
+        for (std::int32_t i = begin; i < end; ++i)
+        {
+          std::uint64_t code = 0;
+          for (int k = 0; k < 3; ++k)
+          {
+            const double h = x_range(1, k) - x_range(0, k);
+            const double s
+                = h > 0.0 ? (points(i, k) - x_range(0, k)) / h : 0.0;
+            code |= expand_bits(s * scale) << (2 - k);
+          }
+          codes[i] = code;
+        }
+      });
+
+  return codes;
+}
+//-----------------------------------------------------------------------------
 std::vector<int>
 geometry::compute_process_collisions(const geometry::BoundingBoxTree& tree,
                                      const Eigen::Vector3d& p)
@@ -326,68 +573,61 @@ geometry::compute_closest_point(const BoundingBoxTree& tree,
   // Note that we don't compute a point search tree here... That would
   // be weird.
 
-  // Get initial guess by picking the distance to a "random" point
-  int closest_point = 0;
-  // double R2 = tree.compute_squared_distance_point(p, closest_point);
-  const double R2
-      = (tree.get_bbox(closest_point).row(0).transpose().matrix() - p)
-            .squaredNorm();
+  // Get initial guess by picking the distance to a "random" point. The
+  // first node is always a leaf.
+  const int closest_point = tree.bbox(0)[1];
+  const double R2 = (tree.get_bbox(0).row(0).transpose().matrix() - p)
+                        .squaredNorm();
 
   // Call recursive find function
-  _compute_closest_point(tree, p, tree.num_bboxes() - 1, closest_point, R2);
+  const auto [index, R2_min] = _compute_closest_point(
+      tree, p, tree.num_bboxes() - 1, closest_point, R2);
 
-  return {closest_point, sqrt(R2)};
+  return {index, std::sqrt(R2_min)};
 }
 //-----------------------------------------------------------------------------
 double geometry::squared_distance(const mesh::Mesh& mesh, int dim,
                                   std::int32_t index, const Eigen::Vector3d& p)
 {
-  const int tdim = mesh.topology().dim();
-  const mesh::Geometry& geometry = mesh.geometry();
-  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
-
-  if (dim == tdim)
-  {
-    auto dofs = x_dofmap.links(index);
-    Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> nodes(dofs.size(),
-                                                                    3);
-    for (int i = 0; i < dofs.size(); i++)
-      nodes.row(i) = geometry.node(dofs(i));
-
-    return geometry::compute_distance_gjk(p.transpose(), nodes).squaredNorm();
-  }
-  else
-  {
-    // Find attached cell
-    mesh.topology_mutable().create_connectivity(dim, tdim);
-    auto e_to_c = mesh.topology().connectivity(dim, tdim);
-    assert(e_to_c);
-    assert(e_to_c->num_links(index) > 0);
-    const std::int32_t c = e_to_c->links(index)[0];
-
-    // Find local number of entity wrt cell
-    mesh.topology_mutable().create_connectivity(tdim, dim);
-    auto c_to_e = mesh.topology_mutable().connectivity(tdim, dim);
-    assert(c_to_e);
-    auto cell_entities = c_to_e->links(c);
-    const auto* it0
-        = std::find(cell_entities.data(),
-                    cell_entities.data() + cell_entities.rows(), index);
-    assert(it0 != (cell_entities.data() + cell_entities.rows()));
-    const int local_cell_entity = std::distance(cell_entities.data(), it0);
-
-    // Tabulate geometry dofs for the entity
-    auto dofs = x_dofmap.links(c);
-    const Eigen::Array<int, Eigen::Dynamic, 1> entity_dofs
-        = geometry.cmap().dof_layout().entity_closure_dofs(dim,
-                                                           local_cell_entity);
-    Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> nodes(
-        entity_dofs.size(), 3);
-    for (int i = 0; i < entity_dofs.size(); i++)
-      nodes.row(i) = geometry.node(dofs(entity_dofs(i)));
-
-    return geometry::compute_distance_gjk(p.transpose(), nodes).squaredNorm();
-  }
+  const std::vector<Eigen::Array<int, Eigen::Dynamic, 1>> closure_dofs
+      = tabulate_entity_closure_dofs(mesh, dim);
+  Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> nodes;
+  get_entity_nodes(mesh, dim, closure_dofs, index, nodes);
+  return geometry::compute_distance_gjk(p.transpose(), nodes).squaredNorm();
+}
+//-----------------------------------------------------------------------------
+Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>
+geometry::compute_distances_gjk(const mesh::Mesh& mesh0, int dim0,
+                                const mesh::Mesh& mesh1, int dim1,
+                                const std::vector<std::array<int, 2>>& pairs,
+                                int num_threads)
+{
+  const std::vector<Eigen::Array<int, Eigen::Dynamic, 1>> closure_dofs0
+      = tabulate_entity_closure_dofs(mesh0, dim0);
+  const std::vector<Eigen::Array<int, Eigen::Dynamic, 1>> closure_dofs1
+      = tabulate_entity_closure_dofs(mesh1, dim1);
+
+  // Buffers for the entity nodes on each thread. The buffers are only
+  // reallocated if the number of nodes changes.
+  std::vector<Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>>
+      nodes0(num_threads), nodes1(num_threads);
+  Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor> distances(
+      pairs.size(), 3);
+  common::parallel_for(
+      pairs.size(), num_threads,
+      [&](int t, std::int32_t begin, std::int32_t end) {
+        for (std::int32_t i = begin; i < end; ++i)
+        {
+          get_entity_nodes(mesh0, dim0, closure_dofs0, pairs[i][0],
+                           nodes0[t]);
+          get_entity_nodes(mesh1, dim1, closure_dofs1, pairs[i][1],
+                           nodes1[t]);
+          distances.row(i)
+              = compute_distance_gjk(nodes0[t], nodes1[t]).transpose().array();
+        }
+      });
+
+  return distances;
 }
 //-------------------------------------------------------------------------------
 std::vector<int>
@@ -411,3 +651,47 @@ geometry::select_colliding_cells(const dolfinx::mesh::Mesh& mesh,
   return result;
 }
 //-------------------------------------------------------------------------------
+graph::AdjacencyList<std::int32_t> geometry::select_colliding_cells(
+    const dolfinx::mesh::Mesh& mesh,
+    const graph::AdjacencyList<std::int32_t>& candidate_cells,
+    const Eigen::Ref<const Eigen::Array<double, Eigen::Dynamic, 3,
+                                        Eigen::RowMajor>>& points,
+    int num_threads)
+{
+  if (candidate_cells.num_nodes() != points.rows())
+  {
+    throw std::runtime_error("Number of candidate cell lists does not match "
+                             "number of points.");
+  }
+
+  const double eps2 = 1e-20;
+  const mesh::Geometry& geometry = mesh.geometry();
+  const graph::AdjacencyList<std::int32_t>& x_dofmap = geometry.dofmap();
+  const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& x
+      = geometry.x();
+
+  // Buffers for the point and cell nodes on each thread
+  std::vector<Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>> p(
+      num_threads, Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>(
+                       1, 3));
+  std::vector<Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor>>
+      nodes(num_threads);
+  return compute_point_links(
+      points, num_threads,
+      [&](int t, std::int32_t i, std::vector<std::int32_t>& cells) {
+        p[t] = points.row(i).matrix();
+        for (std::int32_t c : candidate_cells.links(i))
+        {
+          auto dofs = x_dofmap.links(c);
+          nodes[t].resize(dofs.rows(), 3);
+          for (int j = 0; j < dofs.rows(); ++j)
+            nodes[t].row(j) = x.row(dofs[j]).matrix();
+          if (geometry::compute_distance_gjk(p[t], nodes[t]).squaredNorm()
+              < eps2)
+          {
+            cells.push_back(c);
+          }
+        }
+      });
+}
+//-------------------------------------------------------------------------------
@@ -7,6 +7,9 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <array>
+#include <cstdint>
+#include <dolfinx/graph/AdjacencyList.h>
 #include <utility>
 #include <vector>
 
@@ -40,6 +43,31 @@ compute_collisions(const BoundingBoxTree& tree0, const BoundingBoxTree& tree1);
 std::vector<int> compute_collisions(const BoundingBoxTree& tree,
                                     const Eigen::Vector3d& p);
 
+/// Compute all collisions between bounding boxes and each point in a
+/// list of points. The points are processed in parallel and in a
+/// spatially sorted order.
+/// @param[in] tree The bounding box tree
+/// @param[in] points The points (shape=(num_points, 3))
+/// @param[in] num_threads Number of threads
+/// @return For each point, the bounding box leaves that contain the
+///   point
+graph::AdjacencyList<std::int32_t> compute_collisions(
+    const BoundingBoxTree& tree,
+    const Eigen::Ref<const Eigen::Array<double, Eigen::Dynamic, 3,
+                                        Eigen::RowMajor>>& points,
+    int num_threads = 1);
+
+/// Compute the Morton (Z-order) code of each point. Each coordinate is
+/// scaled to the bounding box of the points and quantized to 21 bits.
+/// Sorting the points by code orders them along a space-filling curve.
+/// @param[in] points The points (shape=(num_points, 3))
+/// @param[in] num_threads Number of threads
+/// @return The Morton code of each point
+std::vector<std::uint64_t> compute_morton_codes(
+    const Eigen::Ref<const Eigen::Array<double, Eigen::Dynamic, 3,
+                                        Eigen::RowMajor>>& points,
+    int num_threads = 1);
+
 /// Compute all collisions between processes and Point returning a
 /// list of process ranks
 std::vector<int> compute_process_collisions(const BoundingBoxTree& tree,
@@ -82,6 +110,29 @@ double compute_squared_distance_bbox(
 double squared_distance(const mesh::Mesh& mesh, int dim, std::int32_t index,
                         const Eigen::Vector3d& p);
 
+/// Compute the shortest vector between the entities in each pair of
+/// mesh entities of two meshes, e.g. the candidate pairs computed by
+/// geometry::compute_collisions for bounding box trees of the meshes.
+/// Uses the GJK algorithm, see geometry::compute_distance_gjk for
+/// details. The pairs are processed in parallel.
+///
+/// @note Currently a convex hull approximation of linearized geometry.
+///
+/// @param[in] mesh0 The first mesh
+/// @param[in] dim0 The topological dimension of the entities of mesh0
+/// @param[in] mesh1 The second mesh
+/// @param[in] dim1 The topological dimension of the entities of mesh1
+/// @param[in] pairs Pairs of (mesh0 entity, mesh1 entity) indices
+/// @param[in] num_threads Number of threads
+/// @return The shortest vector from the mesh1 entity to the mesh0
+///   entity for each pair (shape=(num_pairs, 3)). The vector is zero if
+///   the entities intersect.
+Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>
+compute_distances_gjk(const mesh::Mesh& mesh0, int dim0,
+                      const mesh::Mesh& mesh1, int dim1,
+                      const std::vector<std::array<int, 2>>& pairs,
+                      int num_threads = 1);
+
 /// From the given Mesh, select up to n cells from the list which actually
 /// collide with point p. n may be zero (selects all valid cells). Less than n
 /// cells may be returned.
@@ -93,5 +144,21 @@ double squared_distance(const mesh::Mesh& mesh, int dim, std::int32_t index,
 std::vector<int> select_colliding_cells(const dolfinx::mesh::Mesh& mesh,
                                         const std::vector<int>& candidate_cells,
                                         const Eigen::Vector3d& point, int n);
+
+/// From the given Mesh, select the cells from the list of candidate
+/// cells of each point which actually collide with the point. The
+/// points are processed in parallel and in a spatially sorted order.
+/// @param[in] mesh Mesh
+/// @param[in] candidate_cells List of cell indices to test for each
+///   point, e.g. computed by geometry::compute_collisions
+/// @param[in] points The points (shape=(num_points, 3))
+/// @param[in] num_threads Number of threads
+/// @return For each point, the cells which collide with the point
+graph::AdjacencyList<std::int32_t> select_colliding_cells(
+    const dolfinx::mesh::Mesh& mesh,
+    const graph::AdjacencyList<std::int32_t>& candidate_cells,
+    const Eigen::Ref<const Eigen::Array<double, Eigen::Dynamic, 3,
+                                        Eigen::RowMajor>>& points,
+    int num_threads = 1);
 } // namespace geometry
 } // namespace dolfinx
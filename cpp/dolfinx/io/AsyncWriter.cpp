@@ -0,0 +1,101 @@
+// Copyright (C) 2020 agent
+//
+// This file is part of DOLFINX (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#include "AsyncWriter.h"
+#include <cassert>
+#include <dolfinx/common/log.h>
+
+using namespace dolfinx;
+using namespace dolfinx::io;
+
+//-----------------------------------------------------------------------------
+AsyncWriter::AsyncWriter(int max_pending) : _max_pending(max_pending)
+{
+  assert(max_pending > 0);
+  _thread = std::thread(&AsyncWriter::run, this);
+}
+//-----------------------------------------------------------------------------
+AsyncWriter::~AsyncWriter()
+{
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [this] { return _tasks.empty() and _num_running == 0; });
+    _stop = true;
+  }
+  _cv.notify_all();
+  _thread.join();
+
+  if (_error)
+    LOG(ERROR) << "A background write operation failed.";
+}
+//-----------------------------------------------------------------------------
+void AsyncWriter::enqueue(std::function<void()> task)
+{
+  {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [this] {
+      return _error or _tasks.size() + _num_running < _max_pending;
+    });
+    check_error();
+    _tasks.push_back(std::move(task));
+  }
+  _cv.notify_all();
+}
+//-----------------------------------------------------------------------------
+void AsyncWriter::wait()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  _cv.wait(lock, [this] { return _tasks.empty() and _num_running == 0; });
+  check_error();
+}
+//-----------------------------------------------------------------------------
+void AsyncWriter::run()
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true)
+  {
+    _cv.wait(lock, [this] { return _stop or !_tasks.empty(); });
+    if (_tasks.empty())
+      return;
+
+    std::function<void()> task = std::move(_tasks.front());
+    _tasks.pop_front();
+    ++_num_running;
+    const bool skip = static_cast<bool>(_error);
+    lock.unlock();
+
+    // Execute operation, skipping it if an earlier operation failed
+    std::exception_ptr error;
+    if (!skip)
+    {
+      try
+      {
+        task();
+      }
+      catch (...)
+      {
+        error = std::current_exception();
+      }
+    }
+
+    lock.lock();
+    if (error and !_error)
+      _error = error;
+    --_num_running;
+    _cv.notify_all();
+  }
+}
+//-----------------------------------------------------------------------------
+void AsyncWriter::check_error()
+{
+  if (_error)
+  {
+    std::exception_ptr error = _error;
+    _error = nullptr;
+    std::rethrow_exception(error);
+  }
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,83 @@
+// Copyright (C) 2020 agent
+//
+// This file is part of DOLFINX (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace dolfinx::io
+{
+
+/// This class executes write operations in order on a dedicated
+/// background thread, so that the calling thread can continue while
+/// data is written. The data for each operation must be owned by the
+/// operation, e.g. copied into a staging buffer that it captures.
+///
+/// At most max_pending operations are queued or running. When this
+/// number is reached, enqueue() blocks until an operation has finished,
+/// which bounds the memory used for staging data.
+///
+/// An exception thrown by an operation is rethrown on the calling
+/// thread by the next call to enqueue() or wait().
+
+class AsyncWriter
+{
+public:
+  /// Start the background thread
+  /// @param[in] max_pending The maximum number of operations that can
+  ///   be queued or running
+  explicit AsyncWriter(int max_pending = 2);
+
+  /// Copy constructor
+  AsyncWriter(const AsyncWriter& writer) = delete;
+
+  /// Move constructor
+  AsyncWriter(AsyncWriter&& writer) = delete;
+
+  /// Destructor. Waits for all operations to finish and stops the
+  /// background thread.
+  ~AsyncWriter();
+
+  /// Add a write operation to the queue. Blocks if max_pending
+  /// operations are queued or running.
+  /// @param[in] task The write operation
+  void enqueue(std::function<void()> task);
+
+  /// Wait for all queued operations to finish
+  void wait();
+
+private:
+  // Execute queued operations until stopped
+  void run();
+
+  // Rethrow an exception from an operation, if any. Must be called with
+  // the mutex locked.
+  void check_error();
+
+  // Maximum number of queued or running operations
+  const std::size_t _max_pending;
+
+  // Queued operations, and the number of running operations (0 or 1)
+  std::deque<std::function<void()>> _tasks;
+  std::size_t _num_running = 0;
+
+  // True when the background thread should stop
+  bool _stop = false;
+
+  // Exception thrown by an operation
+  std::exception_ptr _error;
+
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::thread _thread;
+};
+
+} // namespace dolfinx::io
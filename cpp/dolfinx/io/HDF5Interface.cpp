@@ -5,6 +5,7 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "HDF5Interface.h"
+#include <algorithm>
 #include <boost/filesystem.hpp>
 #include <dolfinx/common/MPI.h>
 
@@ -56,8 +57,10 @@ bool has_group(const hid_t handle, const std::string& group_name)
 } // namespace
 
 //-----------------------------------------------------------------------------
-hid_t HDF5Interface::open_file(MPI_Comm mpi_comm, const std::string& filename,
-                               const std::string& mode, const bool use_mpi_io)
+hid_t HDF5Interface::open_file(
+    [[maybe_unused]] MPI_Comm mpi_comm, const std::string& filename,
+    const std::string& mode, [[maybe_unused]] const bool use_mpi_io,
+    [[maybe_unused]] const std::map<std::string, std::string>& mpi_info)
 {
   // Set parallel access with communicator
   const hid_t plist_id = H5Pcreate(H5P_FILE_ACCESS);
@@ -67,6 +70,8 @@ hid_t HDF5Interface::open_file(MPI_Comm mpi_comm, const std::string& filename,
   {
     MPI_Info info;
     MPI_Info_create(&info);
+    for (const auto& [key, value] : mpi_info)
+      MPI_Info_set(info, key.c_str(), value.c_str());
     if (H5Pset_fapl_mpio(plist_id, mpi_comm, info) < 0)
       throw std::runtime_error("Call to H5Pset_fapl_mpio unsuccessful");
     MPI_Info_free(&info);
@@ -226,6 +231,111 @@ HDF5Interface::get_dataset_shape(const hid_t handle,
   return std::vector<std::int64_t>(size.begin(), size.end());
 }
 //-----------------------------------------------------------------------------
+hid_t HDF5Interface::create_dataset_plist(const std::vector<hsize_t>& dims,
+                                          std::size_t value_size,
+                                          const DatasetProperties& properties,
+                                          [[maybe_unused]] bool use_mpi_io)
+{
+  Chunking chunking = properties.chunking;
+  if (chunking == Chunking::none and properties.filter != Filter::none)
+    chunking = Chunking::automatic;
+
+  // Chunk dimensions cannot exceed the dataset dimensions, so empty
+  // datasets are stored contiguously
+  if (chunking == Chunking::none or dims.empty() or dims[0] == 0)
+    return H5P_DEFAULT;
+
+#if defined(H5_HAVE_PARALLEL) and !H5_VERSION_GE(1, 10, 2)
+  if (use_mpi_io and properties.filter != Filter::none)
+  {
+    throw std::runtime_error(
+        "Compressed parallel HDF5 writes require HDF5 1.10.2 or later.");
+  }
+#endif
+
+  // Compute the number of rows in each chunk
+  hsize_t row_size = value_size;
+  for (std::size_t i = 1; i < dims.size(); ++i)
+    row_size *= dims[i];
+  hsize_t chunk_rows = 0;
+  if (chunking == Chunking::rows)
+  {
+    if (properties.chunk_rows <= 0)
+      throw std::runtime_error("Number of chunk rows must be positive.");
+    chunk_rows = properties.chunk_rows;
+  }
+  else
+  {
+    // Aim for chunks of about 1 MB
+    chunk_rows = std::max<hsize_t>(1048576 / row_size, 1);
+  }
+  std::vector<hsize_t> chunk_dims(dims);
+  chunk_dims[0] = std::min(chunk_rows, dims[0]);
+
+  const hid_t plist_id = H5Pcreate(H5P_DATASET_CREATE);
+  if (plist_id < 0)
+    throw std::runtime_error("Failed to create HDF5 property list");
+
+  // Close the property list if it cannot be set up
+  try
+  {
+    if (H5Pset_chunk(plist_id, chunk_dims.size(), chunk_dims.data()) < 0)
+      throw std::runtime_error("Call to H5Pset_chunk unsuccessful");
+
+    // Add compression filter
+    if (properties.filter != Filter::none and properties.shuffle)
+    {
+      if (H5Pset_shuffle(plist_id) < 0)
+        throw std::runtime_error("Call to H5Pset_shuffle unsuccessful");
+    }
+
+    switch (properties.filter)
+    {
+    case Filter::none:
+      break;
+    case Filter::deflate:
+      if (H5Zfilter_avail(H5Z_FILTER_DEFLATE) <= 0)
+        throw std::runtime_error("HDF5 deflate filter is not available.");
+      if (H5Pset_deflate(plist_id, properties.deflate_level) < 0)
+        throw std::runtime_error("Call to H5Pset_deflate unsuccessful");
+      break;
+    case Filter::szip:
+      if (H5Zfilter_avail(H5Z_FILTER_SZIP) <= 0)
+        throw std::runtime_error("HDF5 szip filter is not available.");
+      if (H5Pset_szip(plist_id, H5_SZIP_NN_OPTION_MASK,
+                      properties.szip_pixels_per_block)
+          < 0)
+      {
+        throw std::runtime_error("Call to H5Pset_szip unsuccessful");
+      }
+      break;
+    case Filter::plugin:
+      // Checking availability loads the plugin if it is not registered
+      if (H5Zfilter_avail(properties.plugin_id) <= 0)
+      {
+        throw std::runtime_error("HDF5 filter "
+                                 + std::to_string(properties.plugin_id)
+                                 + " is not available.");
+      }
+      if (H5Pset_filter(plist_id, properties.plugin_id, H5Z_FLAG_MANDATORY,
+                        properties.plugin_parameters.size(),
+                        properties.plugin_parameters.data())
+          < 0)
+      {
+        throw std::runtime_error("Call to H5Pset_filter unsuccessful");
+      }
+      break;
+    }
+  }
+  catch (...)
+  {
+    H5Pclose(plist_id);
+    throw;
+  }
+
+  return plist_id;
+}
+//-----------------------------------------------------------------------------
 void HDF5Interface::set_mpi_atomicity(const hid_t handle, const bool atomic)
 {
 #ifdef H5_HAVE_PARALLEL
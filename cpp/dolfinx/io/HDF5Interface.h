@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <dolfinx/common/log.h>
 #include <hdf5.h>
+#include <map>
 #include <mpi.h>
 #include <string>
 #include <vector>
@@ -27,13 +28,68 @@ class HDF5Interface
 {
 #define HDF5_FAIL -1
 public:
+  /// Chunk shape policy for datasets
+  enum class Chunking
+  {
+    none,      // Contiguous storage
+    automatic, // Chunks of whole rows of about 1 MB
+    rows       // Chunks of a fixed number of whole rows
+  };
+
+  /// Compression filter for datasets
+  enum class Filter
+  {
+    none,    // No compression
+    deflate, // Deflate (gzip) compression
+    szip,    // Szip compression
+    plugin   // A registered or dynamically loaded filter plugin
+  };
+
+  /// Storage properties of datasets created by write_dataset. A
+  /// compression filter requires chunked storage, so automatic
+  /// chunking is used when a filter is set and chunking is none.
+  /// Compressed parallel writes require HDF5 1.10.2 or later.
+  struct DatasetProperties
+  {
+    /// Chunk shape policy
+    Chunking chunking = Chunking::none;
+
+    /// Number of rows in each chunk for Chunking::rows
+    std::int64_t chunk_rows = 0;
+
+    /// Compression filter
+    Filter filter = Filter::none;
+
+    /// Apply the shuffle filter before compression, which usually
+    /// improves the compression of numerical data
+    bool shuffle = true;
+
+    /// Compression level for Filter::deflate (0-9)
+    int deflate_level = 4;
+
+    /// Number of pixels in each block for Filter::szip (even, at most
+    /// 32)
+    int szip_pixels_per_block = 16;
+
+    /// Filter identifier for Filter::plugin
+    int plugin_id = 0;
+
+    /// Filter parameters for Filter::plugin
+    std::vector<unsigned int> plugin_parameters;
+  };
+
   /// Open HDF5 and return file descriptor
   /// @param[in] mpi_comm MPI communicator
   /// @param[in] filename Name of the HDF5 file to open
   /// @param[in] mode Mode in which to open the file (w, r, a)
   /// @param[in] use_mpi_io True if MPI-IO should be used
+  /// @param[in] mpi_info MPI-IO hints, e.g. collective buffering hints
+  ///   such as {"romio_cb_write", "enable"} and {"cb_nodes", "4"}.
+  ///   Ignored if MPI-IO is not used.
   static hid_t open_file(MPI_Comm mpi_comm, const std::string& filename,
-                         const std::string& mode, const bool use_mpi_io);
+                         const std::string& mode, const bool use_mpi_io,
+                         const std::map<std::string, std::string>& mpi_info
+                         = {});
 
   /// Close HDF5 file
   /// @param[in] handle HDF5 file handle
@@ -57,13 +113,39 @@ public:
   /// @param[in] range The local range on this processor
   /// @param[in] global_size The global shape shape of the array
   /// @param[in] use_mpi_io True if MPI-IO should be used
-  /// @param[in] use_chunking True if chunking should be used
+  /// @param[in] properties Storage properties (chunking and
+  ///   compression) of the dataset
   template <typename T>
   static void write_dataset(const hid_t handle, const std::string& dataset_path,
                             const T* data,
                             const std::array<std::int64_t, 2>& range,
                             const std::vector<std::int64_t>& global_size,
-                            bool use_mpi_io, bool use_chunking);
+                            bool use_mpi_io,
+                            const DatasetProperties& properties);
+
+  /// Write data to existing HDF file as defined by range blocks on each
+  /// process
+  /// @param[in] handle HDF5 file handle
+  /// @param[in] dataset_path Path for the dataset in the HDF5 file
+  /// @param[in] data Data to be written, flattened into 1D vector
+  ///   (row-major storage)
+  /// @param[in] range The local range on this processor
+  /// @param[in] global_size The global shape shape of the array
+  /// @param[in] use_mpi_io True if MPI-IO should be used
+  /// @param[in] use_chunking True if (automatic) chunking should be used
+  template <typename T>
+  static void write_dataset(const hid_t handle, const std::string& dataset_path,
+                            const T* data,
+                            const std::array<std::int64_t, 2>& range,
+                            const std::vector<std::int64_t>& global_size,
+                            bool use_mpi_io, bool use_chunking)
+  {
+    DatasetProperties properties;
+    if (use_chunking)
+      properties.chunking = Chunking::automatic;
+    write_dataset(handle, dataset_path, data, range, global_size, use_mpi_io,
+                  properties);
+  }
 
   /// Read data from a HDF5 dataset "dataset_path" as defined by range
   /// blocks on each process.
@@ -111,6 +193,14 @@ private:
   /// @param[in] dataset_path Data set path to add
   static void add_group(const hid_t handle, const std::string& dataset_path);
 
+  // Create a dataset creation property list for a dataset with shape
+  // dims and values of value_size bytes. Returns H5P_DEFAULT for
+  // contiguous storage.
+  static hid_t create_dataset_plist(const std::vector<hsize_t>& dims,
+                                    std::size_t value_size,
+                                    const DatasetProperties& properties,
+                                    bool use_mpi_io);
+
   // Return HDF5 data type
   template <typename T>
   static hid_t hdf5_type()
@@ -161,7 +251,8 @@ template <typename T>
 inline void HDF5Interface::write_dataset(
     const hid_t file_handle, const std::string& dataset_path, const T* data,
     const std::array<std::int64_t, 2>& range,
-    const std::vector<int64_t>& global_size, bool use_mpi_io, bool use_chunking)
+    const std::vector<int64_t>& global_size, bool use_mpi_io,
+    const DatasetProperties& properties)
 {
   // Data rank
   const std::size_t rank = global_size.size();
@@ -190,32 +281,20 @@ inline void HDF5Interface::write_dataset(
   // Generic status report
   herr_t status;
 
-  // Create a global data space
-  const hid_t filespace0 = H5Screate_simple(rank, dimsf.data(), nullptr);
-  assert(filespace0 != HDF5_FAIL);
-
-  // Set chunking parameters
-  hid_t chunking_properties;
-  if (use_chunking)
-  {
-    // Set chunk size and limit to 1kB min/1MB max
-    hsize_t chunk_size = dimsf[0] / 2;
-    if (chunk_size > 1048576)
-      chunk_size = 1048576;
-    if (chunk_size < 1024)
-      chunk_size = 1024;
-
-    hsize_t chunk_dims[2] = {chunk_size, dimsf[1]};
-    chunking_properties = H5Pcreate(H5P_DATASET_CREATE);
-    H5Pset_chunk(chunking_properties, rank, chunk_dims);
-  }
-  else
-    chunking_properties = H5P_DEFAULT;
-
   // Check that group exists and recursively create if required
   const std::string group_name(dataset_path, 0, dataset_path.rfind('/'));
   add_group(file_handle, group_name);
 
+  // Set chunking and compression parameters. This is done before other
+  // HDF5 objects are created, since it throws if the parameters are not
+  // supported.
+  const hid_t chunking_properties
+      = create_dataset_plist(dimsf, sizeof(T), properties, use_mpi_io);
+
+  // Create a global data space
+  const hid_t filespace0 = H5Screate_simple(rank, dimsf.data(), nullptr);
+  assert(filespace0 != HDF5_FAIL);
+
   // Create global dataset (using dataset_path)
   const hid_t dset_id
       = H5Dcreate2(file_handle, dataset_path.c_str(), h5type, filespace0,
@@ -252,7 +331,7 @@ inline void HDF5Interface::write_dataset(
   status = H5Dwrite(dset_id, h5type, memspace, filespace1, plist_id, data);
   assert(status != HDF5_FAIL);
 
-  if (use_chunking)
+  if (chunking_properties != H5P_DEFAULT)
   {
     // Close chunking properties
     status = H5Pclose(chunking_properties);
@@ -11,6 +11,7 @@
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/common/Timer.h>
+#include <dolfinx/common/defines.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/fem/DofMap.h>
 #include <dolfinx/fem/FiniteElement.h>
@@ -31,14 +32,18 @@ namespace
 {
 void write_function(const function::Function<PetscScalar>& u,
                     const std::string filename, const std::size_t counter,
-                    double time);
+                    double time, VTKFile::Encoding encoding);
 void write_mesh(const mesh::Mesh& mesh, const std::string filename,
-                const std::size_t counter, double time);
+                const std::size_t counter, double time,
+                VTKFile::Encoding encoding);
 std::string init(const mesh::Mesh& mesh, const std::string filename,
-                 const std::size_t counter, std::size_t dim);
-void results_write(const function::Function<PetscScalar>& u, std::string file);
+                 const std::size_t counter, std::size_t dim,
+                 VTKFile::Encoding encoding);
+void results_write(const function::Function<PetscScalar>& u, std::string file,
+                   VTKFile::Encoding encoding, std::string& appended_data);
 void write_point_data(const function::Function<PetscScalar>& u,
-                      const mesh::Mesh& mesh, std::string file);
+                      const mesh::Mesh& mesh, std::string file,
+                      VTKFile::Encoding encoding, std::string& appended_data);
 void pvd_file_write(std::size_t step, double time, const std::string filename,
                     std::string file);
 void pvtu_write_function(std::size_t dim, std::size_t rank,
@@ -53,8 +58,10 @@ void pvtu_write(const function::Function<PetscScalar>& u,
                 const std::string filename, const std::string pvtu_filename,
                 const std::size_t counter);
 void vtk_header_open(std::size_t num_vertices, std::size_t num_cells,
-                     const std::string vtu_filename);
-void vtk_header_close(std::string file);
+                     const std::string vtu_filename,
+                     VTKFile::Encoding encoding);
+void vtk_header_close(std::string file, VTKFile::Encoding encoding,
+                      const std::string& appended_data);
 std::string vtu_name(const int process, const int num_processes,
                      const int counter, const std::string filename,
                      const std::string ext);
@@ -64,7 +71,7 @@ void pvtu_write_mesh(pugi::xml_node xml_node);
 
 //----------------------------------------------------------------------------
 void vtk_header_open(std::size_t num_vertices, std::size_t num_cells,
-                     const std::string vtu_filename)
+                     const std::string vtu_filename, VTKFile::Encoding encoding)
 {
   // Open file
   std::ofstream file(vtu_filename.c_str(), std::ios::app);
@@ -74,8 +81,17 @@ void vtk_header_open(std::size_t num_vertices, std::size_t num_cells,
 
   // Write headers
   file << "<?xml version=\"1.0\"?>" << std::endl;
-  file << R"(<VTKFile type="UnstructuredGrid"  version="0.1" )"
-       << ">" << std::endl;
+  file << R"(<VTKFile type="UnstructuredGrid"  version="0.1" )";
+  if (encoding != VTKFile::Encoding::ASCII)
+  {
+    const std::uint16_t one = 1;
+    const bool little_endian = *reinterpret_cast<const std::uint8_t*>(&one);
+    file << R"( header_type="UInt64"  byte_order=")"
+         << (little_endian ? "LittleEndian" : "BigEndian") << "\" ";
+  }
+  if (encoding == VTKFile::Encoding::ZLIB)
+    file << R"( compressor="vtkZLibDataCompressor" )";
+  file << ">" << std::endl;
   file << "<UnstructuredGrid>" << std::endl;
   file << "<Piece  NumberOfPoints=\"" << num_vertices << "\" NumberOfCells=\""
        << num_cells << "\">" << std::endl;
@@ -84,10 +100,11 @@ void vtk_header_open(std::size_t num_vertices, std::size_t num_cells,
   file.close();
 }
 //----------------------------------------------------------------------------
-void vtk_header_close(std::string vtu_filename)
+void vtk_header_close(std::string vtu_filename, VTKFile::Encoding encoding,
+                      const std::string& appended_data)
 {
   // Open file
-  std::ofstream file(vtu_filename.c_str(), std::ios::app);
+  std::ofstream file(vtu_filename.c_str(), std::ios::app | std::ios::binary);
   file.precision(16);
   if (!file.is_open())
   {
@@ -95,9 +112,16 @@ void vtk_header_close(std::string vtu_filename)
   }
 
   // Close headers
-  file << "</Piece>" << std::endl
-       << "</UnstructuredGrid>" << std::endl
-       << "</VTKFile>";
+  file << "</Piece>" << std::endl << "</UnstructuredGrid>" << std::endl;
+
+  // Write values of the data arrays
+  if (encoding != VTKFile::Encoding::ASCII)
+  {
+    file << R"(<AppendedData encoding="raw">)" << std::endl << "_";
+    file.write(appended_data.data(), appended_data.size());
+    file << std::endl << "</AppendedData>" << std::endl;
+  }
+  file << "</VTKFile>";
 
   // Close file
   file.close();
@@ -147,7 +171,8 @@ std::string strip_path(const std::string filename, const std::string file)
 }
 //----------------------------------------------------------------------------
 std::string init(const mesh::Mesh& mesh, const std::string filename,
-                 const std::size_t counter, std::size_t cell_dim)
+                 const std::size_t counter, std::size_t cell_dim,
+                 VTKFile::Encoding encoding)
 {
   // Get MPI communicators
   const MPI_Comm mpi_comm = mesh.mpi_comm();
@@ -166,14 +191,14 @@ std::string init(const mesh::Mesh& mesh, const std::string filename,
   const int num_nodes = mesh.geometry().x().rows();
 
   // Write headers
-  vtk_header_open(num_nodes, num_cells, vtu_filename);
+  vtk_header_open(num_nodes, num_cells, vtu_filename, encoding);
 
   return vtu_filename;
 }
 //----------------------------------------------------------------------------
 void write_function(const function::Function<PetscScalar>& u,
                     const std::string filename, const std::size_t counter,
-                    double time)
+                    double time, VTKFile::Encoding encoding)
 {
   assert(u.function_space());
   std::shared_ptr<const mesh::Mesh> mesh = u.function_space()->mesh();
@@ -184,13 +209,15 @@ void write_function(const function::Function<PetscScalar>& u,
 
   // Get vtu file name and initialise
   std::string vtu_filename
-      = init(*mesh, filename, counter, mesh->topology().dim());
+      = init(*mesh, filename, counter, mesh->topology().dim(), encoding);
 
   // Write mesh
-  VTKWriter::write_mesh(*mesh, mesh->topology().dim(), vtu_filename);
+  std::string appended_data;
+  VTKWriter::write_mesh(*mesh, mesh->topology().dim(), vtu_filename,
+                        encoding, appended_data);
 
   // Write results
-  results_write(u, vtu_filename);
+  results_write(u, vtu_filename, encoding, appended_data);
 
   // Parallel-specific files
   const std::size_t num_processes = dolfinx::MPI::size(mpi_comm);
@@ -204,7 +231,7 @@ void write_function(const function::Function<PetscScalar>& u,
     pvd_file_write(counter, time, filename, vtu_filename);
 
   // Finalise and write pvd files
-  vtk_header_close(vtu_filename);
+  vtk_header_close(vtu_filename, encoding, appended_data);
 
   DLOG(INFO) << "Saved function \""
              << "u"
@@ -212,7 +239,8 @@ void write_function(const function::Function<PetscScalar>& u,
 }
 //----------------------------------------------------------------------------
 void write_mesh(const mesh::Mesh& mesh, const std::string filename,
-                const std::size_t counter, double time)
+                const std::size_t counter, double time,
+                VTKFile::Encoding encoding)
 {
   common::Timer t("Write mesh to PVD/VTK file");
 
@@ -221,10 +249,12 @@ void write_mesh(const mesh::Mesh& mesh, const std::string filename,
 
   // Get vtu file name and initialise out files
   std::string vtu_filename
-      = init(mesh, filename, counter, mesh.topology().dim());
+      = init(mesh, filename, counter, mesh.topology().dim(), encoding);
 
   // Write local mesh to vtu file
-  VTKWriter::write_mesh(mesh, mesh.topology().dim(), vtu_filename);
+  std::string appended_data;
+  VTKWriter::write_mesh(mesh, mesh.topology().dim(), vtu_filename, encoding,
+                        appended_data);
 
   // Parallel-specific files
   const std::size_t num_processes = dolfinx::MPI::size(mpi_comm);
@@ -238,13 +268,14 @@ void write_mesh(const mesh::Mesh& mesh, const std::string filename,
     pvd_file_write(counter, time, filename, vtu_filename);
 
   // Finalise
-  vtk_header_close(vtu_filename);
+  vtk_header_close(vtu_filename, encoding, appended_data);
 
   DLOG(INFO) << "Saved mesh in VTK format to file:" << filename;
 }
 //----------------------------------------------------------------------------
 void results_write(const function::Function<PetscScalar>& u,
-                   std::string vtu_filename)
+                   std::string vtu_filename, VTKFile::Encoding encoding,
+                   std::string& appended_data)
 {
   // Get rank of function::Function
   const int rank = u.function_space()->element()->value_rank();
@@ -291,13 +322,14 @@ void results_write(const function::Function<PetscScalar>& u,
   assert(dofmap);
   assert(dofmap->element_dof_layout);
   if (dofmap->element_dof_layout->num_dofs() == cell_based_dim)
-    VTKWriter::write_cell_data(u, vtu_filename);
+    VTKWriter::write_cell_data(u, vtu_filename, encoding, appended_data);
   else
-    write_point_data(u, *mesh, vtu_filename);
+    write_point_data(u, *mesh, vtu_filename, encoding, appended_data);
 }
 //----------------------------------------------------------------------------
 void write_point_data(const function::Function<PetscScalar>& u,
-                      const mesh::Mesh& mesh, std::string vtu_filename)
+                      const mesh::Mesh& mesh, std::string vtu_filename,
+                      VTKFile::Encoding encoding, std::string& appended_data)
 {
   const int rank = u.function_space()->element()->value_rank();
 
@@ -312,39 +344,42 @@ void write_point_data(const function::Function<PetscScalar>& u,
   Eigen::Array<PetscScalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
       values = u.compute_point_values();
 
+  std::string rank_type;
+  int num_components = 0;
   if (rank == 0)
-  {
-    fp << "<PointData  Scalars=\""
-       << "u"
-       << "\"> " << std::endl;
-    fp << R"(<DataArray  type="Float64"  Name=")"
-       << "u"
-       << "\"  format=\""
-       << "ascii"
-       << "\">";
-  }
+    rank_type = "Scalars";
   else if (rank == 1)
   {
-    fp << "<PointData  Vectors=\""
-       << "u"
-       << "\"> " << std::endl;
-    fp << R"(<DataArray  type="Float64"  Name=")"
-       << "u"
-       << R"("  NumberOfComponents="3" format=")"
-       << "ascii"
-       << "\">";
+    rank_type = "Vectors";
+    num_components = 3;
   }
   else if (rank == 2)
   {
-    fp << "<PointData  Tensors=\""
-       << "u"
-       << "\"> " << std::endl;
-    fp << R"(<DataArray  type="Float64"  Name=")"
-       << "u"
-       << R"("  NumberOfComponents="9" format=")"
-       << "ascii"
-       << "\">";
+    rank_type = "Tensors";
+    num_components = 9;
   }
+  fp << "<PointData  " << rank_type << "=\""
+     << "u"
+     << "\"> " << std::endl;
+
+  if (encoding != VTKFile::Encoding::ASCII)
+  {
+    const std::vector<double> padded
+        = VTKWriter::pad_values(values.data(), values.rows(), dim, rank);
+    fp << VTKWriter::appended_data_array(
+              "Float64", "u", num_components, padded.data(),
+              padded.size() * sizeof(double), encoding, appended_data)
+       << std::endl;
+    fp << "</PointData> " << std::endl;
+    return;
+  }
+
+  fp << R"(<DataArray  type="Float64"  Name=")"
+     << "u"
+     << "\"";
+  if (num_components > 0)
+    fp << "  NumberOfComponents=\"" << num_components << "\"";
+  fp << R"(  format="ascii">)";
 
   std::ostringstream ss;
   ss << std::scientific;
@@ -601,32 +636,34 @@ void pvtu_write(const function::Function<PetscScalar>& u,
 } // namespace
 
 //----------------------------------------------------------------------------
-VTKFile::VTKFile(const std::string filename) : _filename(filename), _counter(0)
+VTKFile::VTKFile(const std::string filename, Encoding encoding)
+    : _filename(filename), _encoding(encoding), _counter(0)
 {
-  // Do nothing
+  if (encoding == Encoding::ZLIB and !has_zlib())
+    throw std::runtime_error("DOLFINX has not been compiled with zlib.");
 }
 //----------------------------------------------------------------------------
 void VTKFile::write(const mesh::Mesh& mesh)
 {
-  write_mesh(mesh, _filename, _counter, _counter);
+  write_mesh(mesh, _filename, _counter, _counter, _encoding);
   ++_counter;
 }
 //----------------------------------------------------------------------------
 void VTKFile::write(const function::Function<PetscScalar>& u)
 {
-  write_function(u, _filename, _counter, _counter);
+  write_function(u, _filename, _counter, _counter, _encoding);
   ++_counter;
 }
 //----------------------------------------------------------------------------
 void VTKFile::write(const mesh::Mesh& mesh, double time)
 {
-  write_mesh(mesh, _filename, _counter, time);
+  write_mesh(mesh, _filename, _counter, time, _encoding);
   ++_counter;
 }
 //----------------------------------------------------------------------------
 void VTKFile::write(const function::Function<PetscScalar>& u, double time)
 {
-  write_function(u, _filename, _counter, time);
+  write_function(u, _filename, _counter, time, _encoding);
   ++_counter;
 }
 //----------------------------------------------------------------------------
@@ -37,12 +37,29 @@ namespace io
 
 /// XML format is suitable for visualisation of higher order geometries.
 /// It is not suitable to checkpointing as it may decimate some data.
+///
+/// Data can be written as ASCII or in binary in the appended data
+/// section of each .vtu file, optionally compressed with zlib. Each
+/// process writes its own .vtu file, and the .pvtu file written by
+/// rank 0 only lists the .vtu files, so no data is gathered.
 
 class VTKFile
 {
 public:
+  /// File encoding type
+  enum class Encoding
+  {
+    ASCII,
+    RAW,
+    ZLIB
+  };
+
   /// Create VTK file
-  VTKFile(const std::string filename);
+  /// @param[in] filename Name of the .pvd file
+  /// @param[in] encoding ASCII, appended raw binary (RAW) or appended
+  ///   zlib-compressed binary (ZLIB) data. ZLIB requires DOLFINX to be
+  ///   compiled with zlib.
+  VTKFile(const std::string filename, Encoding encoding = Encoding::ASCII);
 
   /// Destructor
   ~VTKFile() = default;
@@ -62,6 +79,9 @@ public:
 private:
   const std::string _filename;
 
+  // Encoding of the data
+  const Encoding _encoding;
+
   // Counter for the number of times various data has been written
   std::size_t _counter;
 };
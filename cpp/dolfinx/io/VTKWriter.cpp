@@ -6,6 +6,8 @@
 
 #include "VTKWriter.h"
 #include "cells.h"
+#include <algorithm>
+#include <complex>
 #include <cstdint>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/log.h>
@@ -24,6 +26,10 @@
 #include <sstream>
 #include <vector>
 
+#ifdef HAS_ZLIB
+#include <zlib.h>
+#endif
+
 using namespace dolfinx;
 using namespace dolfinx::io;
 
@@ -105,9 +111,10 @@ std::string ascii_cell_data(const mesh::Mesh& mesh,
   return ss.str();
 }
 //----------------------------------------------------------------------------
-// mesh::Mesh writer (ascii)
-void write_ascii_mesh(const mesh::Mesh& mesh, int cell_dim,
-                      std::string filename)
+// mesh::Mesh writer
+void write_mesh_data(const mesh::Mesh& mesh, int cell_dim,
+                     std::string filename, VTKFile::Encoding encoding,
+                     std::string& appended_data)
 {
   const int num_cells = mesh.topology().index_map(cell_dim)->size_local();
 
@@ -122,31 +129,17 @@ void write_ascii_mesh(const mesh::Mesh& mesh, int cell_dim,
     throw std::runtime_error("Unable to open file:" + filename);
   }
 
-  // Write vertex positions
-  file << "<Points>" << std::endl;
-  file << R"(<DataArray  type="Float64"  NumberOfComponents="3"  format=")"
-       << "ascii"
-       << "\">";
-  const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor> points
+  // Compute cell connectivity
+  const Eigen::Array<double, Eigen::Dynamic, 3, Eigen::RowMajor>& points
       = mesh.geometry().x();
-  for (int i = 0; i < points.rows(); ++i)
-    file << points(i, 0) << " " << points(i, 1) << " " << points(i, 2) << "  ";
-  file << "</DataArray>" << std::endl << "</Points>" << std::endl;
-
-  // Write cell connectivity
-  file << "<Cells>" << std::endl;
-  file << R"(<DataArray  type="Int32"  Name="connectivity"  format=")"
-       << "ascii"
-       << "\">";
-
+  std::vector<std::int32_t> connectivity;
   int num_nodes;
   const int tdim = mesh.topology().dim();
   if (cell_dim == 0)
   {
     // Special case when only points should be visualized
     for (int i = 0; i < points.rows(); ++i)
-      file << i << " ";
-    file << "</DataArray>" << std::endl;
+      connectivity.push_back(i);
     num_nodes = 1;
   }
   else if (cell_dim == tdim)
@@ -175,10 +168,8 @@ void write_ascii_mesh(const mesh::Mesh& mesh, int cell_dim,
     {
       auto x_dofs = x_dofmap.links(c);
       for (int i = 0; i < x_dofs.rows(); ++i)
-        file << x_dofs(map[i]) << " ";
-      file << " ";
+        connectivity.push_back(x_dofs(map[i]));
     }
-    file << "</DataArray>" << std::endl;
   }
   else
   {
@@ -217,14 +208,68 @@ void write_ascii_mesh(const mesh::Mesh& mesh, int cell_dim,
     {
       auto vertices = e_to_v->links(e);
       for (int i = 0; i < num_vertices; ++i)
-        file << vertex_to_node[vertices(map_vtk[i])] << " ";
-      file << " ";
+        connectivity.push_back(vertex_to_node[vertices(map_vtk[i])]);
     }
-    file << "</DataArray>" << std::endl;
     // Change number of nodes to fix offset
     num_nodes = num_vertices;
   }
 
+  if (encoding != VTKFile::Encoding::ASCII)
+  {
+    // Write references to the data arrays, and add the values to the
+    // appended data
+    std::vector<std::int32_t> offsets(num_cells);
+    for (int c = 0; c < num_cells; ++c)
+      offsets[c] = (c + 1) * num_nodes;
+    const std::vector<std::int8_t> types(num_cells, vtk_cell_type);
+
+    file << "<Points>" << std::endl;
+    file << VTKWriter::appended_data_array(
+                "Float64", "", 3, points.data(),
+                points.size() * sizeof(double), encoding, appended_data)
+         << std::endl;
+    file << "</Points>" << std::endl;
+    file << "<Cells>" << std::endl;
+    file << VTKWriter::appended_data_array(
+                "Int32", "connectivity", 0, connectivity.data(),
+                connectivity.size() * sizeof(std::int32_t), encoding,
+                appended_data)
+         << std::endl;
+    file << VTKWriter::appended_data_array(
+                "Int32", "offsets", 0, offsets.data(),
+                offsets.size() * sizeof(std::int32_t), encoding,
+                appended_data)
+         << std::endl;
+    file << VTKWriter::appended_data_array("Int8", "types", 0, types.data(),
+                                           types.size(), encoding,
+                                           appended_data)
+         << std::endl;
+    file << "</Cells>" << std::endl;
+    return;
+  }
+
+  // Write vertex positions
+  file << "<Points>" << std::endl;
+  file << R"(<DataArray  type="Float64"  NumberOfComponents="3"  format=")"
+       << "ascii"
+       << "\">";
+  for (int i = 0; i < points.rows(); ++i)
+    file << points(i, 0) << " " << points(i, 1) << " " << points(i, 2) << "  ";
+  file << "</DataArray>" << std::endl << "</Points>" << std::endl;
+
+  // Write cell connectivity
+  file << "<Cells>" << std::endl;
+  file << R"(<DataArray  type="Int32"  Name="connectivity"  format=")"
+       << "ascii"
+       << "\">";
+  for (std::size_t i = 0; i < connectivity.size(); ++i)
+  {
+    file << connectivity[i] << " ";
+    if ((i + 1) % num_nodes == 0)
+      file << " ";
+  }
+  file << "</DataArray>" << std::endl;
+
   // Write offset into connectivity array for the end of each cell
   file << R"(<DataArray  type="Int32"  Name="offsets"  format=")"
        << "ascii"
@@ -251,13 +296,16 @@ void write_ascii_mesh(const mesh::Mesh& mesh, int cell_dim,
 
 //----------------------------------------------------------------------------
 void VTKWriter::write_mesh(const mesh::Mesh& mesh, std::size_t cell_dim,
-                           std::string filename)
+                           std::string filename, VTKFile::Encoding encoding,
+                           std::string& appended_data)
 {
-  write_ascii_mesh(mesh, cell_dim, filename);
+  write_mesh_data(mesh, cell_dim, filename, encoding, appended_data);
 }
 //----------------------------------------------------------------------------
 void VTKWriter::write_cell_data(const function::Function<PetscScalar>& u,
-                                std::string filename)
+                                std::string filename,
+                                VTKFile::Encoding encoding,
+                                std::string& appended_data)
 {
   assert(u.function_space());
   std::shared_ptr<const mesh::Mesh> mesh = u.function_space()->mesh();
@@ -266,7 +314,6 @@ void VTKWriter::write_cell_data(const function::Function<PetscScalar>& u,
   assert(dofmap);
   const int tdim = mesh->topology().dim();
   const std::int32_t num_cells = mesh->topology().index_map(tdim)->size_local();
-  std::string encode_string = "ascii";
 
   // Get rank of function::Function
   const int rank = u.function_space()->element()->value_rank();
@@ -284,15 +331,10 @@ void VTKWriter::write_cell_data(const function::Function<PetscScalar>& u,
   fp.precision(16);
 
   // Write headers
+  std::string rank_type;
+  int num_components = 0;
   if (rank == 0)
-  {
-    fp << "<CellData  Scalars=\""
-       << "u"
-       << "\"> " << std::endl;
-    fp << R"(<DataArray  type="Float64"  Name=")"
-       << "u"
-       << "\"  format=\"" << encode_string << "\">";
-  }
+    rank_type = "Scalars";
   else if (rank == 1)
   {
     if (!(data_dim == 2 || data_dim == 3))
@@ -301,12 +343,8 @@ void VTKWriter::write_cell_data(const function::Function<PetscScalar>& u,
           "Don't know how to handle vector function with dimension  "
           "other than 2 or 3");
     }
-    fp << "<CellData  Vectors=\""
-       << "u"
-       << "\"> " << std::endl;
-    fp << R"(<DataArray  type="Float64"  Name=")"
-       << "u"
-       << R"("  NumberOfComponents="3" format=")" << encode_string << "\">";
+    rank_type = "Vectors";
+    num_components = 3;
   }
   else if (rank == 2)
   {
@@ -315,13 +353,12 @@ void VTKWriter::write_cell_data(const function::Function<PetscScalar>& u,
       throw std::runtime_error("Don't know how to handle tensor function with "
                                "dimension other than 4 or 9");
     }
-    fp << "<CellData  Tensors=\""
-       << "u"
-       << "\"> " << std::endl;
-    fp << R"(<DataArray  type="Float64"  Name=")"
-       << "u"
-       << R"("  NumberOfComponents="9" format=")" << encode_string << "\">";
+    rank_type = "Tensors";
+    num_components = 9;
   }
+  fp << "<CellData  " << rank_type << "=\""
+     << "u"
+     << "\"> " << std::endl;
 
   // Allocate memory for function values at cell centres
   const std::size_t size = num_cells * data_dim;
@@ -351,8 +388,114 @@ void VTKWriter::write_cell_data(const function::Function<PetscScalar>& u,
     values[i] = _x[dof_set[i]];
 
   // Get cell data
-  fp << ascii_cell_data(*mesh, offset, values, data_dim, rank);
-  fp << "</DataArray> " << std::endl;
+  if (encoding == VTKFile::Encoding::ASCII)
+  {
+    fp << R"(<DataArray  type="Float64"  Name=")"
+       << "u"
+       << "\"";
+    if (num_components > 0)
+      fp << "  NumberOfComponents=\"" << num_components << "\"";
+    fp << R"(  format="ascii">)";
+    fp << ascii_cell_data(*mesh, offset, values, data_dim, rank);
+    fp << "</DataArray> " << std::endl;
+  }
+  else
+  {
+    const std::vector<double> padded
+        = VTKWriter::pad_values(values.data(), num_cells, data_dim, rank);
+    fp << VTKWriter::appended_data_array(
+              "Float64", "u", num_components, padded.data(),
+              padded.size() * sizeof(double), encoding, appended_data)
+       << std::endl;
+  }
   fp << "</CellData> " << std::endl;
 }
 //----------------------------------------------------------------------------
+std::string VTKWriter::appended_data_array(std::string type, std::string name,
+                                           int num_components,
+                                           const void* data,
+                                           std::size_t num_bytes,
+                                           VTKFile::Encoding encoding,
+                                           std::string& appended_data)
+{
+  std::ostringstream ss;
+  ss << "<DataArray  type=\"" << type << "\"";
+  if (!name.empty())
+    ss << "  Name=\"" << name << "\"";
+  if (num_components > 0)
+    ss << "  NumberOfComponents=\"" << num_components << "\"";
+  ss << "  format=\"appended\"  offset=\"" << appended_data.size() << "\"/>";
+
+  const char* bytes = static_cast<const char*>(data);
+  if (encoding == VTKFile::Encoding::ZLIB)
+  {
+#ifdef HAS_ZLIB
+    // Compress the values in blocks. The header contains the number of
+    // blocks, the block size, the size of the last block if it is
+    // partial (zero otherwise) and the compressed size of each block.
+    const std::uint64_t block_size = 1 << 20;
+    const std::uint64_t num_blocks = (num_bytes + block_size - 1) / block_size;
+    std::vector<std::uint64_t> header
+        = {num_blocks, block_size, num_bytes % block_size};
+    std::string blocks;
+    std::vector<Bytef> buffer(compressBound(block_size));
+    for (std::uint64_t b = 0; b < num_blocks; ++b)
+    {
+      const std::uint64_t size
+          = std::min(block_size, (std::uint64_t)num_bytes - b * block_size);
+      uLongf compressed_size = buffer.size();
+      if (compress(buffer.data(), &compressed_size,
+                   reinterpret_cast<const Bytef*>(bytes + b * block_size),
+                   size)
+          != Z_OK)
+      {
+        throw std::runtime_error("Compression of VTK data failed.");
+      }
+      header.push_back(compressed_size);
+      blocks.append(reinterpret_cast<const char*>(buffer.data()),
+                    compressed_size);
+    }
+    appended_data.append(reinterpret_cast<const char*>(header.data()),
+                         header.size() * sizeof(std::uint64_t));
+    appended_data += blocks;
+#else
+    throw std::runtime_error("DOLFINX has not been compiled with zlib.");
+#endif
+  }
+  else if (encoding == VTKFile::Encoding::RAW)
+  {
+    const std::uint64_t size = num_bytes;
+    appended_data.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    appended_data.append(bytes, num_bytes);
+  }
+  else
+    throw std::runtime_error("Data array encoding is not appended.");
+
+  return ss.str();
+}
+//----------------------------------------------------------------------------
+std::vector<double> VTKWriter::pad_values(const PetscScalar* values,
+                                          int num_values, int data_dim,
+                                          int rank)
+{
+  std::vector<double> padded;
+  for (int i = 0; i < num_values; ++i)
+  {
+    const PetscScalar* v = values + i * data_dim;
+    if (rank == 1 and data_dim == 2)
+      padded.insert(padded.end(), {std::real(v[0]), std::real(v[1]), 0.0});
+    else if (rank == 2 and data_dim == 4)
+    {
+      padded.insert(padded.end(), {std::real(v[0]), std::real(v[1]), 0.0,
+                                   std::real(v[2]), std::real(v[3]), 0.0, 0.0,
+                                   0.0, 0.0});
+    }
+    else
+    {
+      for (int j = 0; j < data_dim; ++j)
+        padded.push_back(std::real(v[j]));
+    }
+  }
+  return padded;
+}
+//----------------------------------------------------------------------------
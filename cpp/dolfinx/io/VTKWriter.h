@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "VTKFile.h"
 #include <cstdint>
 #include <petscsys.h>
 #include <string>
@@ -31,13 +32,49 @@ namespace io
 class VTKWriter
 {
 public:
-  /// mesh::Mesh writer
+  /// mesh::Mesh writer. For binary encodings, the values of the data
+  /// arrays are added to @p appended_data, which must be written to
+  /// the AppendedData section of the file.
   static void write_mesh(const mesh::Mesh& mesh, std::size_t cell_dim,
-                         std::string file);
+                         std::string file, VTKFile::Encoding encoding,
+                         std::string& appended_data);
 
-  /// Cell data writer
+  /// Cell data writer. For binary encodings, the values of the data
+  /// arrays are added to @p appended_data, which must be written to
+  /// the AppendedData section of the file.
   static void write_cell_data(const function::Function<PetscScalar>& u,
-                              std::string file);
+                              std::string file, VTKFile::Encoding encoding,
+                              std::string& appended_data);
+
+  /// Add the values of a data array to the appended data of a file and
+  /// return the XML DataArray element that refers to them. The values
+  /// are preceded by a header with their size in bytes (UInt64), and
+  /// for the ZLIB encoding they are compressed in blocks.
+  /// @param[in] type VTK type of the values, e.g. Float64
+  /// @param[in] name Name of the array, or empty for no name
+  /// @param[in] num_components Number of components of each value, or
+  ///   zero to omit
+  /// @param[in] data The values
+  /// @param[in] num_bytes Size of the values in bytes
+  /// @param[in] encoding The encoding, RAW or ZLIB
+  /// @param[in,out] appended_data The appended data
+  /// @return The DataArray element
+  static std::string appended_data_array(std::string type, std::string name,
+                                         int num_components, const void* data,
+                                         std::size_t num_bytes,
+                                         VTKFile::Encoding encoding,
+                                         std::string& appended_data);
+
+  /// Convert values to double, padding the values of vector and tensor
+  /// functions in 2D with zeros to make them 3D
+  /// @param[in] values The values (shape=(num_values, data_dim))
+  /// @param[in] num_values Number of values
+  /// @param[in] data_dim Number of components of each value
+  /// @param[in] rank Value rank of the function
+  /// @return The padded values
+  static std::vector<double> pad_values(const PetscScalar* values,
+                                        int num_values, int data_dim,
+                                        int rank);
 };
 } // namespace io
 } // namespace dolfinx
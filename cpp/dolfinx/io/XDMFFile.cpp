@@ -5,6 +5,7 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "XDMFFile.h"
+#include "AsyncWriter.h"
 #include "cells.h"
 #include "pugixml.hpp"
 #include "xdmf_function.h"
@@ -21,13 +22,48 @@
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/MeshTags.h>
 #include <dolfinx/mesh/utils.h>
+#include <fstream>
+#include <sstream>
 
 using namespace dolfinx;
 using namespace dolfinx::io;
 
+namespace
+{
+//-----------------------------------------------------------------------------
+
+// Closing tags that follow the last time step of a time series when the
+// series is the last Grid in the Domain
+const std::string xml_tail = "    </Grid>\n  </Domain>\n</Xdmf>\n";
+//-----------------------------------------------------------------------------
+
+// Write serialised XML data to file. If offset is negative, data is the
+// whole document, otherwise data overwrites the end of the file from
+// offset.
+void write_xml(const std::string& filename, std::int64_t offset,
+               const std::string& data)
+{
+  std::ofstream file;
+  if (offset < 0)
+    file.open(filename, std::ios::binary | std::ios::trunc);
+  else
+  {
+    file.open(filename, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(offset);
+  }
+  file << data;
+  if (!file)
+    throw std::runtime_error("Failed to write XDMF file " + filename);
+}
+//-----------------------------------------------------------------------------
+
+} // namespace
+
 //-----------------------------------------------------------------------------
 XDMFFile::XDMFFile(MPI_Comm comm, const std::string filename,
-                   const std::string file_mode, const Encoding encoding)
+                   const std::string file_mode, const Encoding encoding,
+                   bool asynchronous,
+                   const std::map<std::string, std::string>& mpi_info)
     : _mpi_comm(comm), _filename(filename), _file_mode(file_mode),
       _xml_doc(new pugi::xml_document), _encoding(encoding)
 {
@@ -44,7 +80,7 @@ XDMFFile::XDMFFile(MPI_Comm comm, const std::string filename,
     const std::string hdf5_filename = xdmf_utils::get_hdf5_filename(_filename);
     const bool mpi_io = MPI::size(_mpi_comm.comm()) > 1 ? true : false;
     _h5_id = HDF5Interface::open_file(_mpi_comm.comm(), hdf5_filename,
-                                      file_mode, mpi_io);
+                                      file_mode, mpi_io, mpi_info);
     assert(_h5_id > 0);
     LOG(INFO) << "Opened HDF5 file with id \"" << _h5_id << "\"";
   }
@@ -112,34 +148,96 @@ XDMFFile::XDMFFile(MPI_Comm comm, const std::string filename,
       assert(domain_node);
     }
   }
+
+  if (asynchronous and _file_mode != "r")
+  {
+    // Writing from a background thread requires a thread-safe HDF5
+    // library, and MPI-IO from a second thread requires
+    // MPI_THREAD_MULTIPLE
+    hbool_t h5_threadsafe = 0;
+    H5is_library_threadsafe(&h5_threadsafe);
+    int mpi_thread = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&mpi_thread);
+    int supported = _encoding == Encoding::HDF5 and h5_threadsafe
+                    and (mpi_thread == MPI_THREAD_MULTIPLE
+                         or MPI::size(_mpi_comm.comm()) == 1);
+    MPI_Allreduce(MPI_IN_PLACE, &supported, 1, MPI_INT, MPI_LAND,
+                  _mpi_comm.comm());
+    if (supported)
+      _writer = std::make_unique<AsyncWriter>(2);
+    else
+    {
+      LOG(WARNING) << "Asynchronous XDMF output is not supported by the "
+                      "encoding, HDF5 library or MPI thread level. Writing "
+                      "synchronously.";
+    }
+  }
 }
 //-----------------------------------------------------------------------------
-XDMFFile::~XDMFFile() { close(); }
+XDMFFile::~XDMFFile()
+{
+  try
+  {
+    close();
+  }
+  catch (const std::exception& e)
+  {
+    LOG(ERROR) << "Error closing XDMF file: " << e.what();
+  }
+}
 //-----------------------------------------------------------------------------
 void XDMFFile::close()
 {
+  // Wait for pending writes before closing the HDF5 file, and close
+  // the file even if a write failed
+  std::exception_ptr error;
+  if (_writer)
+  {
+    try
+    {
+      _writer->wait();
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+    _writer.reset();
+  }
+
   if (_h5_id > 0)
     HDF5Interface::close_file(_h5_id);
   _h5_id = -1;
+
+  if (error)
+    std::rethrow_exception(error);
 }
 //-----------------------------------------------------------------------------
+bool XDMFFile::asynchronous() const { return static_cast<bool>(_writer); }
+//-----------------------------------------------------------------------------
 void XDMFFile::write_mesh(const mesh::Mesh& mesh, const std::string xpath)
 {
+  wait();
+
   pugi::xml_node node = _xml_doc->select_node(xpath.c_str()).node();
   if (!node)
     throw std::runtime_error("XML node '" + xpath + "' not found.");
 
   // Add the mesh Grid to the domain
-  xdmf_mesh::add_mesh(_mpi_comm.comm(), node, _h5_id, mesh, mesh.name);
+  xdmf_mesh::add_mesh(_mpi_comm.comm(), node, _h5_id, mesh, mesh.name,
+                      _dataset_properties);
+
+  // Record the mesh for static-mesh time series
+  record_mesh_grid(node.last_child(), mesh.hash());
 
   // Save XML file (on process 0 only)
-  if (MPI::rank(_mpi_comm.comm()) == 0)
-    _xml_doc->save_file(_filename.c_str(), "  ");
+  save_xml(pugi::xml_node());
 }
 //-----------------------------------------------------------------------------
 void XDMFFile::write_geometry(const mesh::Geometry& geometry,
                               const std::string name, const std::string xpath)
 {
+  wait();
+
   pugi::xml_node node = _xml_doc->select_node(xpath.c_str()).node();
   if (!node)
     throw std::runtime_error("XML node '" + xpath + "' not found.");
@@ -152,11 +250,16 @@ void XDMFFile::write_geometry(const mesh::Geometry& geometry,
 
   const std::string path_prefix = "/Geometry/" + name;
   xdmf_mesh::add_geometry_data(_mpi_comm.comm(), grid_node, _h5_id, path_prefix,
-                               geometry);
+                               geometry, _dataset_properties);
+
+  // The Grid may have the same name as the recorded mesh Grid, in which
+  // case the XPath of the mesh Grid is no longer unique. The mesh Grid
+  // is looked up again by the next static-mesh time step.
+  _mesh_xpath.clear();
+  _mesh_hash = 0;
 
   // Save XML file (on process 0 only)
-  if (MPI::rank(_mpi_comm.comm()) == 0)
-    _xml_doc->save_file(_filename.c_str(), "  ");
+  save_xml(pugi::xml_node());
 }
 //-----------------------------------------------------------------------------
 mesh::Mesh XDMFFile::read_mesh(const fem::CoordinateElement& element,
@@ -182,6 +285,8 @@ Eigen::Array<std::int64_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
 XDMFFile::read_topology_data(const std::string name,
                              const std::string xpath) const
 {
+  wait();
+
   pugi::xml_node node = _xml_doc->select_node(xpath.c_str()).node();
   if (!node)
     throw std::runtime_error("XML node '" + xpath + "' not found.");
@@ -198,6 +303,8 @@ Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
 XDMFFile::read_geometry_data(const std::string name,
                              const std::string xpath) const
 {
+  wait();
+
   pugi::xml_node node = _xml_doc->select_node(xpath.c_str()).node();
   if (!node)
     throw std::runtime_error("XML node '" + xpath + "' not found.");
@@ -210,9 +317,40 @@ XDMFFile::read_geometry_data(const std::string name,
   return xdmf_mesh::read_geometry_data(_mpi_comm.comm(), _h5_id, grid_node);
 }
 //-----------------------------------------------------------------------------
+Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+XDMFFile::read_attribute_data(const std::string name,
+                              const std::string xpath) const
+{
+  wait();
+
+  pugi::xml_node node = _xml_doc->select_node(xpath.c_str()).node();
+  if (!node)
+    throw std::runtime_error("XML node '" + xpath + "' not found.");
+
+  pugi::xml_node data_node
+      = node.select_node(("Attribute[@Name='" + name + "']/DataItem").c_str())
+            .node();
+  if (!data_node)
+    throw std::runtime_error("<Attribute> with name '" + name + "' not found.");
+
+  const std::vector shape = xdmf_utils::get_dataset_shape(data_node);
+  const std::int64_t width = shape.size() > 1 ? shape[1] : 1;
+  const std::vector data
+      = xdmf_read::get_dataset<double>(_mpi_comm.comm(), data_node, _h5_id);
+  return Eigen::Map<const Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic,
+                                       Eigen::RowMajor>>(
+      data.data(), data.size() / width, width);
+}
+//-----------------------------------------------------------------------------
 void XDMFFile::write_function(const function::Function<PetscScalar>& function,
                               const double t, const std::string mesh_xpath)
 {
+  assert(function.function_space());
+  std::shared_ptr<const mesh::Mesh> mesh = function.function_space()->mesh();
+  assert(mesh);
+  const std::string grid_xpath
+      = mesh_xpath.empty() ? static_mesh_xpath(*mesh) : mesh_xpath;
+
   const std::string timegrid_xpath
       = "/Xdmf/Domain/Grid[@GridType='Collection'][@Name='" + function.name
         + "']";
@@ -235,13 +373,13 @@ void XDMFFile::write_function(const function::Function<PetscScalar>& function,
   grid_node.append_attribute("Name") = function.name.c_str();
   grid_node.append_attribute("GridType") = "Uniform";
 
-  pugi::xml_node mesh_node = _xml_doc->select_node(mesh_xpath.c_str()).node();
+  pugi::xml_node mesh_node = _xml_doc->select_node(grid_xpath.c_str()).node();
   if (!mesh_node)
-    LOG(WARNING) << "No mesh found at '" << mesh_xpath
+    LOG(WARNING) << "No mesh found at '" << grid_xpath
                  << "'. Write mesh before function!";
 
   const std::string ref_path
-      = "xpointer(" + mesh_xpath + "/*[self::Topology or self::Geometry])";
+      = "xpointer(" + grid_xpath + "/*[self::Topology or self::Geometry])";
 
   pugi::xml_node topo_geo_ref = grid_node.append_child("xi:include");
   topo_geo_ref.append_attribute("xpointer") = ref_path.c_str();
@@ -252,18 +390,40 @@ void XDMFFile::write_function(const function::Function<PetscScalar>& function,
   time_node.append_attribute("Value") = t_str.c_str();
   assert(time_node);
 
+  if (_writer)
+  {
+    // Stage the function data and the XML document, and write both on
+    // the background thread. Blocks if too many steps are pending.
+    std::vector<std::function<void()>> writes;
+    xdmf_function::add_function(_mpi_comm.comm(), function, t, grid_node,
+                                _h5_id, _dataset_properties, &writes);
+    const bool rank0 = MPI::rank(_mpi_comm.comm()) == 0;
+    auto [xml_offset, xml] = rank0 ? serialise_xml(grid_node)
+                                   : std::pair<std::int64_t, std::string>();
+    _writer->enqueue([writes = std::move(writes), xml_offset = xml_offset,
+                      xml = std::move(xml), rank0, filename = _filename]() {
+      for (const std::function<void()>& write : writes)
+        write();
+      if (rank0)
+        write_xml(filename, xml_offset, xml);
+    });
+    return;
+  }
+
   // Add the mesh Grid to the domain
-  xdmf_function::add_function(_mpi_comm.comm(), function, t, grid_node, _h5_id);
+  xdmf_function::add_function(_mpi_comm.comm(), function, t, grid_node, _h5_id,
+                              _dataset_properties);
 
   // Save XML file (on process 0 only)
-  if (MPI::rank(_mpi_comm.comm()) == 0)
-    _xml_doc->save_file(_filename.c_str(), "  ");
+  save_xml(grid_node);
 }
 //-----------------------------------------------------------------------------
 void XDMFFile::write_meshtags(const mesh::MeshTags<std::int32_t>& meshtags,
                               const std::string geometry_xpath,
                               const std::string xpath)
 {
+  wait();
+
   pugi::xml_node node = _xml_doc->select_node(xpath.c_str()).node();
   if (!node)
     throw std::runtime_error("XML node '" + xpath + "' not found.");
@@ -278,17 +438,18 @@ void XDMFFile::write_meshtags(const mesh::MeshTags<std::int32_t>& meshtags,
   geo_ref_node.append_attribute("xpointer") = geo_ref_path.c_str();
   assert(geo_ref_node);
   xdmf_meshtags::add_meshtags(_mpi_comm.comm(), meshtags, grid_node, _h5_id,
-                              meshtags.name);
+                              meshtags.name, _dataset_properties);
 
   // Save XML file (on process 0 only)
-  if (MPI::rank(_mpi_comm.comm()) == 0)
-    _xml_doc->save_file(_filename.c_str(), "  ");
+  save_xml(pugi::xml_node());
 }
 //-----------------------------------------------------------------------------
 mesh::MeshTags<std::int32_t>
 XDMFFile::read_meshtags(const std::shared_ptr<const mesh::Mesh>& mesh,
                         const std::string name, const std::string xpath)
 {
+  wait();
+
   pugi::xml_node node = _xml_doc->select_node(xpath.c_str()).node();
   if (!node)
     throw std::runtime_error("XML node '" + xpath + "' not found.");
@@ -331,6 +492,8 @@ XDMFFile::read_meshtags(const std::shared_ptr<const mesh::Mesh>& mesh,
 std::pair<mesh::CellType, int>
 XDMFFile::read_cell_type(const std::string grid_name, const std::string xpath)
 {
+  wait();
+
   pugi::xml_node node = _xml_doc->select_node(xpath.c_str()).node();
   if (!node)
     throw std::runtime_error("XML node '" + xpath + "' not found.");
@@ -357,6 +520,8 @@ void XDMFFile::write_information(const std::string name,
                                  const std::string value,
                                  const std::string xpath)
 {
+  wait();
+
   pugi::xml_node node = _xml_doc->select_node(xpath.c_str()).node();
   if (!node)
     throw std::runtime_error("XML node '" + xpath + "' not found.");
@@ -367,13 +532,14 @@ void XDMFFile::write_information(const std::string name,
   info_node.append_attribute("Value") = value.c_str();
 
   // Save XML file (on process 0 only)
-  if (MPI::rank(_mpi_comm.comm()) == 0)
-    _xml_doc->save_file(_filename.c_str(), "  ");
+  save_xml(pugi::xml_node());
 }
 //-----------------------------------------------------------------------------
 std::string XDMFFile::read_information(const std::string name,
                                        const std::string xpath)
 {
+  wait();
+
   pugi::xml_node node = _xml_doc->select_node(xpath.c_str()).node();
   if (!node)
     throw std::runtime_error("XML node '" + xpath + "' not found.");
@@ -390,3 +556,146 @@ std::string XDMFFile::read_information(const std::string name,
 //-----------------------------------------------------------------------------
 MPI_Comm XDMFFile::comm() const { return _mpi_comm.comm(); }
 //-----------------------------------------------------------------------------
+void XDMFFile::set_dataset_properties(
+    const HDF5Interface::DatasetProperties& properties)
+{
+  _dataset_properties = properties;
+}
+//-----------------------------------------------------------------------------
+const HDF5Interface::DatasetProperties&
+XDMFFile::dataset_properties() const
+{
+  return _dataset_properties;
+}
+//-----------------------------------------------------------------------------
+std::pair<std::int64_t, std::string>
+XDMFFile::serialise_xml(const pugi::xml_node& step)
+{
+  // The new time step can be written on its own if the file on disk
+  // holds the document without the step, and the step is the last node
+  // of the document and not the first step of its series (which would
+  // change the series from an empty to a non-empty element)
+  if (step and _xml_tail_offset >= 0)
+  {
+    pugi::xml_node series = step.parent();
+    pugi::xml_node domain = series.parent();
+    if (step == series.last_child() and step.previous_sibling()
+        and series == domain.last_child()
+        and domain == _xml_doc->child("Xdmf").child("Domain")
+        and !domain.next_sibling() and !domain.parent().next_sibling())
+    {
+      std::ostringstream ss;
+      step.print(ss, "  ", pugi::format_default, pugi::encoding_auto, 3);
+      const std::string data = ss.str();
+      const std::int64_t offset = _xml_tail_offset;
+      _xml_tail_offset += data.size();
+      return {offset, data + xml_tail};
+    }
+  }
+
+  // Serialise the whole document, and record where the closing tags of
+  // the last time series start so that subsequent steps can be
+  // appended
+  std::ostringstream ss;
+  _xml_doc->save(ss, "  ");
+  std::string data = ss.str();
+  if (data.size() >= xml_tail.size()
+      and data.compare(data.size() - xml_tail.size(), xml_tail.size(),
+                       xml_tail)
+              == 0)
+  {
+    _xml_tail_offset = data.size() - xml_tail.size();
+  }
+  else
+    _xml_tail_offset = -1;
+
+  return {-1, std::move(data)};
+}
+//-----------------------------------------------------------------------------
+void XDMFFile::save_xml(const pugi::xml_node& step)
+{
+  if (MPI::rank(_mpi_comm.comm()) == 0)
+  {
+    const auto [offset, data] = serialise_xml(step);
+    write_xml(_filename, offset, data);
+  }
+}
+//-----------------------------------------------------------------------------
+std::string XDMFFile::static_mesh_xpath(const mesh::Mesh& mesh)
+{
+  const std::size_t hash = mesh.hash();
+  if (!_mesh_xpath.empty() and hash == _mesh_hash)
+    return _mesh_xpath;
+
+  wait();
+
+  // Look for a mesh Grid with the same hash and a unique name, e.g.
+  // written before the file was opened in append mode
+  const std::string hash_xpath
+      = "//Grid[Information[@Name='MeshHash'][@Value='"
+        + std::to_string(hash) + "']]";
+  for (const pugi::xpath_node& node :
+       _xml_doc->select_nodes(hash_xpath.c_str()))
+  {
+    const pugi::xml_node parent = node.node().parent();
+    const std::string name = node.node().attribute("Name").as_string();
+    const std::string grid_xpath = "Grid[@Name='" + name + "']";
+    if (parent.select_nodes(grid_xpath.c_str()).size() == 1)
+    {
+      _mesh_xpath = parent.path('/') + "/" + grid_xpath;
+      _mesh_hash = hash;
+      return _mesh_xpath;
+    }
+  }
+
+  // Use a Grid name that is not in use, since the name also sets the
+  // HDF5 path of the mesh data
+  pugi::xml_node domain_node = _xml_doc->child("Xdmf").child("Domain");
+  assert(domain_node);
+  std::string name = mesh.name;
+  for (int i = 1; domain_node.find_child_by_attribute("Grid", "Name",
+                                                      name.c_str());
+       ++i)
+  {
+    name = mesh.name + "_" + std::to_string(i);
+  }
+
+  LOG(INFO) << "Writing changed mesh to Grid \"" << name << "\"";
+  xdmf_mesh::add_mesh(_mpi_comm.comm(), domain_node, _h5_id, mesh, name,
+                      _dataset_properties);
+
+  // Move the mesh Grid before the time series, so that a time series
+  // can remain the last Grid and steps can be appended to the file
+  pugi::xml_node grid_node = domain_node.last_child();
+  pugi::xml_node series_node = domain_node.find_child_by_attribute(
+      "Grid", "GridType", "Collection");
+  if (series_node)
+    domain_node.insert_move_before(grid_node, series_node);
+
+  record_mesh_grid(grid_node, hash);
+
+  // Save XML file (on process 0 only)
+  save_xml(pugi::xml_node());
+
+  return _mesh_xpath;
+}
+//-----------------------------------------------------------------------------
+void XDMFFile::record_mesh_grid(pugi::xml_node grid_node, std::size_t hash)
+{
+  assert(grid_node);
+  pugi::xml_node info_node = grid_node.append_child("Information");
+  assert(info_node);
+  info_node.append_attribute("Name") = "MeshHash";
+  info_node.append_attribute("Value") = std::to_string(hash).c_str();
+
+  _mesh_xpath = grid_node.parent().path('/') + "/Grid[@Name='"
+                + grid_node.attribute("Name").as_string() + "']";
+  _mesh_hash = hash;
+}
+//-----------------------------------------------------------------------------
+void XDMFFile::wait() const
+{
+  if (_writer)
+    _writer->wait();
+}
+//-----------------------------------------------------------------------------
@@ -9,6 +9,7 @@
 #include "HDF5Interface.h"
 #include <dolfinx/common/MPI.h>
 #include <dolfinx/mesh/cell_types.h>
+#include <map>
 #include <memory>
 #include <petscsys.h>
 #include <string>
@@ -43,6 +44,7 @@ class MeshTags;
 
 namespace io
 {
+class AsyncWriter;
 
 /// Read and write mesh::Mesh, function::Function and other objects in
 /// XDMF.
@@ -54,6 +56,16 @@ namespace io
 ///
 /// XDMF is not suitable for higher order geometries, as their currently
 /// only supports 1st and 2nd order geometries.
+///
+/// If the file is opened with asynchronous output, write_function
+/// copies the function data into a staging buffer and returns, and the
+/// data and XML file are written by a background thread. At most two
+/// steps are staged at any time; a further write_function call blocks
+/// until the oldest step has been written. All other member functions
+/// wait for pending writes to finish first. Asynchronous output
+/// requires a thread-safe HDF5 library and, in parallel, MPI with
+/// MPI_THREAD_MULTIPLE support, otherwise the data is written
+/// synchronously.
 
 class XDMFFile
 {
@@ -69,20 +81,36 @@ public:
   static const Encoding default_encoding = Encoding::HDF5;
 
   /// Constructor
+  /// @param[in] comm The MPI communicator
+  /// @param[in] filename Name of the XDMF file
+  /// @param[in] file_mode The file mode ("r", "w" or "a")
+  /// @param[in] encoding The file encoding
+  /// @param[in] asynchronous Write function data on a background
+  ///   thread (HDF5 encoding only)
+  /// @param[in] mpi_info MPI-IO hints for the HDF5 file, e.g.
+  ///   collective buffering hints (HDF5 encoding in parallel only)
   XDMFFile(MPI_Comm comm, const std::string filename,
            const std::string file_mode,
-           const Encoding encoding = default_encoding);
+           const Encoding encoding = default_encoding,
+           bool asynchronous = false,
+           const std::map<std::string, std::string>& mpi_info = {});
 
   /// Destructor
   ~XDMFFile();
 
   /// Close the file
   ///
-  /// This closes open underlying HDF5 file. In ASCII mode the XML file
-  /// is closed each time it is written to or read from, so close() has
-  /// no effect.
+  /// This waits for pending asynchronous writes and closes open
+  /// underlying HDF5 file. In ASCII mode the XML file is closed each
+  /// time it is written to or read from, so close() has no effect.
   void close();
 
+  /// Check if function data is written asynchronously
+  /// @return True if function data is written on a background thread,
+  ///   and false if asynchronous output was not requested or is not
+  ///   supported
+  bool asynchronous() const;
+
   /// Save Mesh
   /// @param[in] mesh
   /// @param[in] xpath XPath where Mesh Grid will be written
@@ -124,6 +152,19 @@ public:
   read_geometry_data(const std::string name,
                      const std::string xpath = "/Xdmf/Domain") const;
 
+  /// Read the data of an Attribute, e.g. the values of a Function
+  /// written by write_function. The rows are distributed across
+  /// processes in contiguous blocks, in the same way as the rows read
+  /// by read_geometry_data.
+  /// @param[in] name Name of the Attribute
+  /// @param[in] xpath XPath of the Grid that holds the Attribute, e.g.
+  ///   "/Xdmf/Domain/Grid[@Name='u']/Grid[1]" for the first time step
+  ///   of Function u
+  /// @return Attribute values on each process, one row per point or
+  ///   cell
+  Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+  read_attribute_data(const std::string name, const std::string xpath) const;
+
   /// Read information about cell type
   /// @param[in] grid_name Name of Grid for which cell type is needed
   /// @param[in] xpath XPath where Grid is stored
@@ -132,10 +173,19 @@ public:
                                                 = "/Xdmf/Domain");
 
   /// Write Function
+  ///
+  /// If @p mesh_xpath is empty, the time step references the Topology
+  /// and Geometry of a mesh in the file with the same hash
+  /// (mesh::Mesh::hash) as the mesh of the Function (static-mesh time
+  /// series). The hash of each mesh is stored in the file, so meshes
+  /// written before the file was opened in append mode are reused. The
+  /// mesh is written only if no such mesh is found, e.g. because the
+  /// mesh has moved. This is collective.
+  ///
   /// @param[in] function The Function to write to file
   /// @param[in] t The time stamp to associate with the Function
   /// @param[in] mesh_xpath XPath for a Grid under which Function will
-  ///   be inserted
+  ///   be inserted, or empty to manage the mesh automatically
   void write_function(const function::Function<PetscScalar>& function,
                       const double t,
                       const std::string mesh_xpath
@@ -176,7 +226,42 @@ public:
   /// @return The MPI communicator for the file object
   MPI_Comm comm() const;
 
+  /// Set the storage properties (chunking and compression) of HDF5
+  /// datasets for mesh, MeshTags and Function data written after this
+  /// call
+  /// @param[in] properties The dataset properties
+  void set_dataset_properties(
+      const HDF5Interface::DatasetProperties& properties);
+
+  /// Get the storage properties of HDF5 datasets
+  /// @return The dataset properties
+  const HDF5Interface::DatasetProperties& dataset_properties() const;
+
 private:
+  // Serialise the XML document for writing to file. If step is a new
+  // time step that has been appended to the end of the document, only
+  // the step and the closing tags are serialised, so that the cost does
+  // not grow with the number of steps. Returns (offset, data), where
+  // data replaces the end of the file from offset, or is the whole
+  // document if offset is negative.
+  std::pair<std::int64_t, std::string>
+  serialise_xml(const pugi::xml_node& step);
+
+  // Write the XML document, or only a new time step, to file (on
+  // process 0 only)
+  void save_xml(const pugi::xml_node& step);
+
+  // Wait for pending asynchronous writes to finish
+  void wait() const;
+
+  // Return the XPath of a mesh Grid in the file that is identical to
+  // mesh, writing the mesh if there is no such Grid
+  std::string static_mesh_xpath(const mesh::Mesh& mesh);
+
+  // Store the hash of the mesh in a mesh Grid, and record the Grid as
+  // the last mesh written
+  void record_mesh_grid(pugi::xml_node grid_node, std::size_t hash);
+
   // MPI communicator
   dolfinx::MPI::Comm _mpi_comm;
 
@@ -193,7 +278,25 @@ private:
   // kept open for time series etc.
   std::unique_ptr<pugi::xml_document> _xml_doc;
 
+  // Offset in the XML file of the closing tags of the last time series,
+  // or -1 if the file does not end with a time series. Set on process
+  // 0 only.
+  std::int64_t _xml_tail_offset = -1;
+
   Encoding _encoding;
+
+  // Storage properties of HDF5 datasets
+  HDF5Interface::DatasetProperties _dataset_properties;
+
+  // XPath of the Grid of the last mesh written or found for a
+  // static-mesh time series, and the hash of the mesh. The XPath is
+  // empty if there is no such Grid.
+  std::string _mesh_xpath;
+  std::size_t _mesh_hash = 0;
+
+  // Background writer for asynchronous output (null for synchronous
+  // output)
+  std::unique_ptr<AsyncWriter> _writer;
 };
 
 } // namespace io
@@ -79,7 +79,10 @@ int get_padded_width(const function::Function<PetscScalar>& u)
 void xdmf_function::add_function(MPI_Comm comm,
                                  const function::Function<PetscScalar>& u,
                                  const double t, pugi::xml_node& xml_node,
-                                 const hid_t h5_id)
+                                 const hid_t h5_id,
+                                 const HDF5Interface::DatasetProperties&
+                                     properties,
+                                 std::vector<std::function<void()>>* deferred)
 {
   LOG(INFO) << "Adding function to node \"" << xml_node.path('/') << "\"";
 
@@ -160,13 +163,15 @@ void xdmf_function::add_function(MPI_Comm comm,
         comm, component_data_values.size() / width, true);
     xdmf_utils::add_data_item(attribute_node, h5_id, dataset_name,
                               component_data_values, offset,
-                              {num_values, width}, "", use_mpi_io);
+                              {num_values, width}, "", use_mpi_io, properties,
+                              deferred);
 #else
     // Add data item
     const std::int64_t offset
         = dolfinx::MPI::global_offset(comm, data_values.size() / width, true);
     xdmf_utils::add_data_item(attribute_node, h5_id, dataset_name, data_values,
-                              offset, {num_values, width}, "", use_mpi_io);
+                              offset, {num_values, width}, "", use_mpi_io,
+                              properties, deferred);
 #endif
   }
 }
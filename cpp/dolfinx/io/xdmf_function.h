@@ -6,9 +6,12 @@
 
 #pragma once
 
+#include "HDF5Interface.h"
+#include <functional>
 #include <hdf5.h>
 #include <mpi.h>
 #include <petscsys.h>
+#include <vector>
 
 namespace pugi
 {
@@ -29,9 +32,19 @@ namespace io
 namespace xdmf_function
 {
 
-/// TODO
+/// Add a Function to an XML node and write its data
+/// @param[in] comm The MPI communicator
+/// @param[in] u The Function
+/// @param[in] t The time stamp
+/// @param[in,out] xml_node The Grid node to add the Attribute to
+/// @param[in] h5_id HDF5 file handle, or negative for XML data
+/// @param[in] properties Storage properties of the HDF5 datasets
+/// @param[out] deferred If not null, the data is staged and the HDF5
+///   writes are appended to @p deferred instead of being executed
 void add_function(MPI_Comm comm, const function::Function<PetscScalar>& u,
-                  const double t, pugi::xml_node& xml_node, const hid_t h5_id);
+                  const double t, pugi::xml_node& xml_node, const hid_t h5_id,
+                  const HDF5Interface::DatasetProperties& properties,
+                  std::vector<std::function<void()>>* deferred = nullptr);
 
 } // namespace xdmf_function
 } // namespace io
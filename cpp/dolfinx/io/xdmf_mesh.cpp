@@ -19,7 +19,8 @@ void xdmf_mesh::add_topology_data(
     MPI_Comm comm, pugi::xml_node& xml_node, const hid_t h5_id,
     const std::string path_prefix, const mesh::Topology& topology,
     const mesh::Geometry& geometry, const int dim,
-    const std::vector<std::int32_t>& active_entities)
+    const std::vector<std::int32_t>& active_entities,
+    const HDF5Interface::DatasetProperties& properties)
 {
   LOG(INFO) << "Adding topology data to node \"" << xml_node.path('/') << "\"";
 
@@ -134,13 +135,16 @@ void xdmf_mesh::add_topology_data(
 
   const bool use_mpi_io = (dolfinx::MPI::size(comm) > 1);
   xdmf_utils::add_data_item(topology_node, h5_id, h5_path, topology_data,
-                            offset, shape, number_type, use_mpi_io);
+                            offset, shape, number_type, use_mpi_io,
+                            properties);
 }
 //-----------------------------------------------------------------------------
 void xdmf_mesh::add_geometry_data(MPI_Comm comm, pugi::xml_node& xml_node,
                                   const hid_t h5_id,
                                   const std::string path_prefix,
-                                  const mesh::Geometry& geometry)
+                                  const mesh::Geometry& geometry,
+                                  const HDF5Interface::DatasetProperties&
+                                      properties)
 {
 
   LOG(INFO) << "Adding geometry data to node \"" << xml_node.path('/') << "\"";
@@ -187,12 +191,13 @@ void xdmf_mesh::add_geometry_data(MPI_Comm comm, pugi::xml_node& xml_node,
       = dolfinx::MPI::global_offset(comm, num_points_local, true);
   const bool use_mpi_io = (dolfinx::MPI::size(comm) > 1);
   xdmf_utils::add_data_item(geometry_node, h5_id, h5_path, x, offset, shape, "",
-                            use_mpi_io);
+                            use_mpi_io, properties);
 }
 //----------------------------------------------------------------------------
 void xdmf_mesh::add_mesh(MPI_Comm comm, pugi::xml_node& xml_node,
                          const hid_t h5_id, const mesh::Mesh& mesh,
-                         const std::string name)
+                         const std::string name,
+                         const HDF5Interface::DatasetProperties& properties)
 {
   LOG(INFO) << "Adding mesh to node \"" << xml_node.path('/') << "\"";
 
@@ -215,10 +220,11 @@ void xdmf_mesh::add_mesh(MPI_Comm comm, pugi::xml_node& xml_node,
   std::iota(active_cells.begin(), active_cells.end(), 0);
 
   add_topology_data(comm, grid_node, h5_id, path_prefix, mesh.topology(),
-                    mesh.geometry(), tdim, active_cells);
+                    mesh.geometry(), tdim, active_cells, properties);
 
   // Add geometry node and attributes (including writing data)
-  add_geometry_data(comm, grid_node, h5_id, path_prefix, mesh.geometry());
+  add_geometry_data(comm, grid_node, h5_id, path_prefix, mesh.geometry(),
+                    properties);
 }
 //----------------------------------------------------------------------------
 Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
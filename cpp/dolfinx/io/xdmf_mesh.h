@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "HDF5Interface.h"
 #include <Eigen/Dense>
 #include <dolfinx/mesh/cell_types.h>
 #include <hdf5.h>
@@ -36,9 +37,11 @@ namespace io::xdmf_mesh
 /// Add Mesh to xml node
 ///
 /// Creates new Grid with Topology and Geometry xml nodes for mesh. In
-/// HDF file data is stored under path prefix.
+/// HDF file data is stored under path prefix, with the given storage
+/// properties.
 void add_mesh(MPI_Comm comm, pugi::xml_node& xml_node, const hid_t h5_id,
-              const mesh::Mesh& mesh, const std::string path_prefix);
+              const mesh::Mesh& mesh, const std::string path_prefix,
+              const HDF5Interface::DatasetProperties& properties);
 
 /// Add Topology xml node
 /// @param[in] comm
@@ -51,16 +54,19 @@ void add_mesh(MPI_Comm comm, pugi::xml_node& xml_node, const hid_t h5_id,
 /// @param[in] active_entities Local-to-process indices of mesh entities
 ///   whose topology will be saved. This is used to save subsets of
 ///   Mesh.
+/// @param[in] properties Storage properties of the HDF5 dataset
 void add_topology_data(MPI_Comm comm, pugi::xml_node& xml_node,
                        const hid_t h5_id, const std::string path_prefix,
                        const mesh::Topology& topology,
                        const mesh::Geometry& geometry, const int cell_dim,
-                       const std::vector<std::int32_t>& active_entities);
+                       const std::vector<std::int32_t>& active_entities,
+                       const HDF5Interface::DatasetProperties& properties);
 
 /// Add Geometry xml node
 void add_geometry_data(MPI_Comm comm, pugi::xml_node& xml_node,
                        const hid_t h5_id, const std::string path_prefix,
-                       const mesh::Geometry& geometry);
+                       const mesh::Geometry& geometry,
+                       const HDF5Interface::DatasetProperties& properties);
 
 /// Read Geometry data
 /// @returns geometry
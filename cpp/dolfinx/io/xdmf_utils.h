@@ -12,8 +12,10 @@
 #include <boost/filesystem.hpp>
 #include <dolfinx/common/utils.h>
 #include <dolfinx/mesh/cell_types.h>
+#include <functional>
 #include <petscsys.h>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -87,13 +89,30 @@ extract_local_entities(
                        Eigen::RowMajor>& entities,
     const std::vector<std::int32_t>& values);
 
-/// TODO: Document
+/// Add a DataItem node for an array and write the array, either into
+/// the XML node or to a HDF5 dataset
+/// @param[in,out] xml_node The node to add the DataItem to
+/// @param[in] h5_id HDF5 file handle. If negative, the data is written
+///   into the XML node.
+/// @param[in] h5_path Path of the dataset in the HDF5 file
+/// @param[in] x The data on this process
+/// @param[in] offset Global offset of the first row of x
+/// @param[in] shape Global shape of the dataset
+/// @param[in] number_type XDMF number type, or empty for the default
+/// @param[in] use_mpi_io Use MPI-IO for the HDF5 write
+/// @param[in] properties Storage properties of the HDF5 dataset
+/// @param[out] deferred If not null, x is copied into a staging buffer
+///   and the HDF5 write is appended to @p deferred instead of being
+///   executed. The writes must be executed on all processes in the
+///   same order.
 template <typename T>
 void add_data_item(pugi::xml_node& xml_node, const hid_t h5_id,
                    const std::string h5_path, const T& x,
                    const std::int64_t offset,
                    const std::vector<std::int64_t> shape,
-                   const std::string number_type, const bool use_mpi_io)
+                   const std::string number_type, const bool use_mpi_io,
+                   const HDF5Interface::DatasetProperties& properties,
+                   std::vector<std::function<void()>>* deferred = nullptr)
 {
   // Add DataItem node
   assert(xml_node);
@@ -147,8 +166,23 @@ void add_data_item(pugi::xml_node& xml_node, const hid_t h5_id,
     }
 
     const std::array local_range{offset, offset + local_shape0};
-    HDF5Interface::write_dataset(h5_id, h5_path, x.data(), local_range, shape,
-                                 use_mpi_io, false);
+    if (deferred)
+    {
+      using U = std::remove_const_t<
+          std::remove_reference_t<decltype(*x.data())>>;
+      deferred->push_back(
+          [h5_id, h5_path, data = std::vector<U>(x.data(), x.data() + x.size()),
+           local_range, shape, use_mpi_io, properties]() {
+            HDF5Interface::write_dataset(h5_id, h5_path, data.data(),
+                                         local_range, shape, use_mpi_io,
+                                         properties);
+          });
+    }
+    else
+    {
+      HDF5Interface::write_dataset(h5_id, h5_path, x.data(), local_range,
+                                   shape, use_mpi_io, properties);
+    }
 
     // Add partitioning attribute to dataset
     // std::vector<std::size_t> partitions;
@@ -0,0 +1,536 @@
+// Copyright (C) 2020 agent
+//
+// This file is part of DOLFINX (https://www.fenicsproject.org)
+//
+// SPDX-License-Identifier:    LGPL-3.0-or-later
+
+#pragma once
+
+#include "SparsityPattern.h"
+#include "Vector.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <dolfinx/common/IndexMap.h>
+#include <dolfinx/common/MPI.h>
+#include <dolfinx/graph/AdjacencyList.h>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace dolfinx::la
+{
+
+/// Distributed sparse matrix in compressed sparse row (CSR) format.
+///
+/// The matrix stores the rows owned by this process followed by the
+/// ghost rows, i.e. rows that receive contributions from this process
+/// but are owned by another process. Rows and columns use local
+/// (process-wise) indices, unrolled for the block size of the row and
+/// column IndexMaps. Local column indices are numbered as: owned
+/// columns, the ghost columns of the column IndexMap, followed by any
+/// other columns that appear in the owned rows.
+///
+/// The entries are split into a 'diagonal' block (owned columns) and
+/// an 'off-diagonal' block (non-owned columns), each stored in CSR
+/// format with the columns of a row sorted by global index. In the
+/// off-diagonal block this is in general not the order of the local
+/// column indices. The values of the diagonal block for all
+/// rows are followed by the values of the off-diagonal block. This is
+/// the layout of a PETSc MATMPIAIJ matrix, which allows a PETSc matrix
+/// to share the value array (see la::create_petsc_matrix).
+///
+/// Values are added directly into the CSR arrays, which avoids the
+/// overhead of inserting through a general purpose sparse matrix
+/// library. Contributions to ghost rows are sent to the owning process
+/// by finalize().
+
+template <typename T>
+class MatrixCSR
+{
+public:
+  /// Create a matrix with the structure of a finalised sparsity
+  /// pattern. All entries are zero.
+  /// @note Collective
+  /// @param[in] p The sparsity pattern
+  explicit MatrixCSR(const SparsityPattern& p)
+      : _index_maps({p.index_map(0), p.index_map(1)})
+  {
+    const int bs0 = _index_maps[0]->block_size();
+    const int bs1 = _index_maps[1]->block_size();
+    _num_owned_rows = bs0 * _index_maps[0]->size_local();
+    const std::int32_t num_ghost_rows = bs0 * _index_maps[0]->num_ghosts();
+    const std::int32_t num_rows = _num_owned_rows + num_ghost_rows;
+
+    // Owned column range (global, unrolled)
+    _num_owned_cols = bs1 * _index_maps[1]->size_local();
+    const std::int64_t col_offset = bs1 * _index_maps[1]->local_range()[0];
+
+    // Ghost columns from the column IndexMap come first, followed by
+    // other off-process columns as they are encountered
+    std::vector<std::int64_t> col_ghosts;
+    const Eigen::Array<std::int64_t, Eigen::Dynamic, 1>& ghosts1
+        = _index_maps[1]->ghosts();
+    std::unordered_map<std::int64_t, std::int32_t> global_to_local;
+    for (Eigen::Index i = 0; i < ghosts1.rows(); ++i)
+    {
+      for (int k = 0; k < bs1; ++k)
+      {
+        global_to_local.insert(
+            {bs1 * ghosts1[i] + k, _num_owned_cols + col_ghosts.size()});
+        col_ghosts.push_back(bs1 * ghosts1[i] + k);
+      }
+    }
+
+    // Insert the columns of a row, with global indices for non-owned
+    // columns, into the diagonal and off-diagonal blocks
+    std::array<std::vector<std::int32_t>, 2> cols;
+    auto insert_cols = [&](auto& row, bool owned_local) {
+      for (Eigen::Index j = 0; j < row.rows(); ++j)
+      {
+        const std::int64_t col = row[j];
+        if (owned_local)
+          cols[0].push_back(col);
+        else if (col >= col_offset and col < col_offset + _num_owned_cols)
+          cols[0].push_back(col - col_offset);
+        else
+        {
+          auto [it, inserted] = global_to_local.insert(
+              {col, _num_owned_cols + col_ghosts.size()});
+          if (inserted)
+            col_ghosts.push_back(col);
+          cols[1].push_back(it->second);
+        }
+      }
+    };
+    auto end_row = [&]() {
+      std::sort(cols[0].begin() + _row_ptr[0].back(), cols[0].end());
+      std::sort(cols[1].begin() + _row_ptr[1].back(), cols[1].end(),
+                [&](std::int32_t c0, std::int32_t c1) {
+                  return col_ghosts[c0 - _num_owned_cols]
+                         < col_ghosts[c1 - _num_owned_cols];
+                });
+      for (int b = 0; b < 2; ++b)
+        _row_ptr[b].push_back(cols[b].size());
+    };
+
+    const graph::AdjacencyList<std::int32_t>& diag = p.diagonal_pattern();
+    const graph::AdjacencyList<std::int64_t>& off_diag
+        = p.off_diagonal_pattern();
+    const graph::AdjacencyList<std::int64_t>& ghost_rows
+        = p.ghost_row_pattern();
+    assert(diag.num_nodes() == _num_owned_rows);
+    assert(ghost_rows.num_nodes() == num_ghost_rows);
+    for (int b = 0; b < 2; ++b)
+    {
+      _row_ptr[b].reserve(num_rows + 1);
+      _row_ptr[b].push_back(0);
+    }
+    for (std::int32_t i = 0; i < _num_owned_rows; ++i)
+    {
+      auto cols_diag = diag.links(i);
+      insert_cols(cols_diag, true);
+      auto cols_off = off_diag.links(i);
+      insert_cols(cols_off, false);
+      end_row();
+    }
+    for (std::int32_t i = 0; i < num_ghost_rows; ++i)
+    {
+      auto cols_ghost = ghost_rows.links(i);
+      insert_cols(cols_ghost, false);
+      end_row();
+    }
+
+    _cols.resize(cols[0].size() + cols[1].size());
+    std::copy(cols[1].begin(), cols[1].end(),
+              std::copy(cols[0].begin(), cols[0].end(), _cols.begin()));
+    _values.resize(_cols.size(), 0);
+
+    // Create an IndexMap for the columns, including columns that are
+    // not ghosts of the column IndexMap, for updating ghost values in
+    // matrix-vector products
+    MPI_Comm comm = p.mpi_comm();
+    int mpi_size = -1;
+    MPI_Comm_size(comm, &mpi_size);
+    std::vector<std::int64_t> col_ranges(mpi_size + 1, 0);
+    const std::int64_t num_owned_cols = _num_owned_cols;
+    MPI_Allgather(&num_owned_cols, 1, MPI_INT64_T, col_ranges.data() + 1, 1,
+                  MPI_INT64_T, comm);
+    std::partial_sum(col_ranges.begin(), col_ranges.end(), col_ranges.begin());
+    std::vector<int> ghost_owners(col_ghosts.size());
+    for (std::size_t i = 0; i < col_ghosts.size(); ++i)
+    {
+      auto it = std::upper_bound(col_ranges.begin(), col_ranges.end(),
+                                 col_ghosts[i]);
+      ghost_owners[i] = std::distance(col_ranges.begin(), it) - 1;
+    }
+    _column_map = std::make_shared<common::IndexMap>(
+        comm, _num_owned_cols,
+        dolfinx::MPI::compute_graph_edges(
+            comm, std::set<int>(ghost_owners.begin(), ghost_owners.end())),
+        col_ghosts, ghost_owners, 1);
+
+    // Send the (row, column) index of each ghost row entry to the
+    // owner of the row, and compute where the owner accumulates the
+    // values
+    compute_ghost_row_scatter(global_to_local);
+  }
+
+  /// Copy constructor
+  MatrixCSR(const MatrixCSR& A) = default;
+
+  /// Move constructor
+  MatrixCSR(MatrixCSR&& A) = default;
+
+  /// Destructor
+  ~MatrixCSR() = default;
+
+  /// Set all entries to a value
+  /// @param[in] x The value
+  void set(T x) { std::fill(_values.begin(), _values.end(), x); }
+
+  /// Return a function for adding a block of values to the matrix
+  /// using local indices. The function has the signature used by
+  /// fem::assemble_matrix. The function is safe to call concurrently
+  /// for blocks with disjoint rows. The position of each entry is found
+  /// by a binary search in its row; see fem::AssemblyPlan for
+  /// precomputed positions.
+  std::function<int(std::int32_t, const std::int32_t*, std::int32_t,
+                    const std::int32_t*, const T*)>
+  mat_add_values()
+  {
+    return [this](std::int32_t nrows, const std::int32_t* rows,
+                  std::int32_t ncols, const std::int32_t* cols,
+                  const T* vals) {
+      for (std::int32_t i = 0; i < nrows; ++i)
+      {
+        for (std::int32_t j = 0; j < ncols; ++j)
+        {
+          const std::int32_t pos = position(rows[i], cols[j]);
+          assert(pos >= 0);
+          _values[pos] += vals[i * ncols + j];
+        }
+      }
+      return 0;
+    };
+  }
+
+  /// Send the values in ghost rows to the owning process and add them
+  /// to the owned rows. The ghost rows are set to zero. Must be called
+  /// after assembly and before the matrix is used.
+  /// @note Collective
+  void finalize()
+  {
+    std::vector<T> send_values(_send_pos.size());
+    for (std::size_t i = 0; i < _send_pos.size(); ++i)
+      send_values[i] = _values[_send_pos[i]];
+
+    std::vector<T> recv_values(_recv_pos.size());
+    MPI_Neighbor_alltoallv(
+        send_values.data(), _send_sizes.data(), _send_disp.data(),
+        dolfinx::MPI::mpi_type<T>(), recv_values.data(), _recv_sizes.data(),
+        _recv_disp.data(), dolfinx::MPI::mpi_type<T>(),
+        _index_maps[0]->comm(common::IndexMap::Direction::reverse));
+    for (std::size_t i = 0; i < _recv_pos.size(); ++i)
+      _values[_recv_pos[i]] += recv_values[i];
+
+    for (int b = 0; b < 2; ++b)
+    {
+      const std::int32_t offset = b == 0 ? 0 : _row_ptr[0].back();
+      std::fill(_values.begin() + offset + _row_ptr[b][_num_owned_rows],
+                _values.begin() + offset + _row_ptr[b].back(), 0);
+    }
+  }
+
+  /// Compute y = Ax for the owned rows. Ghost values of @p x are not
+  /// used; the values of non-owned columns are received while the
+  /// product with the diagonal block is computed. Ghost entries of
+  /// @p y are not modified.
+  /// @note Collective
+  /// @param[in] x Vector with the layout of the matrix columns
+  /// @param[in,out] y Vector with the layout of the matrix rows
+  /// @param[in] num_threads Number of threads for the product of the
+  ///   local rows
+  void mult(const Vector<T>& x, Vector<T>& y, int num_threads = 1) const
+  {
+    assert(num_threads > 0);
+    assert(x.array().size() >= _num_owned_cols);
+    assert(y.array().size() >= _num_owned_rows);
+
+    // Start receiving values for the non-owned columns
+    const std::vector<T> x_owned(x.array().data(),
+                                 x.array().data() + _num_owned_cols);
+    std::vector<T> x_ghost, send_buffer, recv_buffer;
+    MPI_Request request;
+    _column_map->scatter_fwd_begin(x_owned, 1, send_buffer, recv_buffer,
+                                   request);
+
+    // Apply a function to contiguous blocks of the owned rows, one
+    // block per thread
+    auto parallel_for_rows = [&](const auto& fn) {
+      std::vector<std::thread> threads;
+      const std::int32_t block_size = _num_owned_rows / num_threads;
+      const std::int32_t remainder = _num_owned_rows % num_threads;
+      std::int32_t r0 = 0;
+      for (int t = 0; t < num_threads; ++t)
+      {
+        const std::int32_t r1 = r0 + block_size + (t < remainder ? 1 : 0);
+        if (t == num_threads - 1)
+          fn(r0, r1);
+        else
+          threads.emplace_back(fn, r0, r1);
+        r0 = r1;
+      }
+      for (std::thread& t : threads)
+        t.join();
+    };
+
+    // Diagonal block
+    Eigen::Matrix<T, Eigen::Dynamic, 1>& _y = y.array();
+    parallel_for_rows([&](std::int32_t r0, std::int32_t r1) {
+      for (std::int32_t r = r0; r < r1; ++r)
+      {
+        T sum = 0;
+        for (std::int32_t k = _row_ptr[0][r]; k < _row_ptr[0][r + 1]; ++k)
+          sum += _values[k] * x_owned[_cols[k]];
+        _y[r] = sum;
+      }
+    });
+
+    // Off-diagonal block
+    _column_map->scatter_fwd_end(x_ghost, 1, recv_buffer, request);
+    const T* values_off = _values.data() + _row_ptr[0].back();
+    const std::int32_t* cols_off = _cols.data() + _row_ptr[0].back();
+    parallel_for_rows([&](std::int32_t r0, std::int32_t r1) {
+      for (std::int32_t r = r0; r < r1; ++r)
+      {
+        T sum = 0;
+        for (std::int32_t k = _row_ptr[1][r]; k < _row_ptr[1][r + 1]; ++k)
+          sum += values_off[k] * x_ghost[cols_off[k] - _num_owned_cols];
+        _y[r] += sum;
+      }
+    });
+    y.mark_modified();
+  }
+
+  /// Position of entry (row, col) in the array of values
+  /// @param[in] row Local row index
+  /// @param[in] col Local column index
+  /// @return The position in values(), or -1 if the entry is not in
+  ///   the sparsity pattern
+  std::int32_t position(std::int32_t row, std::int32_t col) const
+  {
+    assert(row < num_rows());
+    std::vector<std::int32_t>::const_iterator it, end;
+    if (col < _num_owned_cols)
+    {
+      end = _cols.begin() + _row_ptr[0][row + 1];
+      it = std::lower_bound(_cols.begin() + _row_ptr[0][row], end, col);
+    }
+    else
+    {
+      // Off-diagonal columns are sorted by global index
+      const Eigen::Array<std::int64_t, Eigen::Dynamic, 1>& ghosts
+          = _column_map->ghosts();
+      const std::int32_t offset = _row_ptr[0].back();
+      end = _cols.begin() + offset + _row_ptr[1][row + 1];
+      it = std::lower_bound(_cols.begin() + offset + _row_ptr[1][row], end,
+                            col, [&](std::int32_t c0, std::int32_t c1) {
+                              return ghosts[c0 - _num_owned_cols]
+                                     < ghosts[c1 - _num_owned_cols];
+                            });
+    }
+    if (it == end or *it != col)
+      return -1;
+    return std::distance(_cols.begin(), it);
+  }
+
+  /// Index maps for the row and column spaces
+  const std::array<std::shared_ptr<const common::IndexMap>, 2>&
+  index_maps() const
+  {
+    return _index_maps;
+  }
+
+  /// IndexMap (block size 1) for the local columns, with the
+  /// non-owned columns as ghosts
+  std::shared_ptr<const common::IndexMap> column_map() const
+  {
+    return _column_map;
+  }
+
+  /// Number of owned rows (unrolled for the block size)
+  std::int32_t num_owned_rows() const { return _num_owned_rows; }
+
+  /// Number of rows (owned and ghost, unrolled for the block size)
+  std::int32_t num_rows() const { return _row_ptr[0].size() - 1; }
+
+  /// Number of owned columns (unrolled for the block size)
+  std::int32_t num_owned_cols() const { return _num_owned_cols; }
+
+  /// Matrix values. The values of the diagonal block are followed by
+  /// the values of the off-diagonal block.
+  std::vector<T>& values() { return _values; }
+
+  /// Matrix values (const version)
+  const std::vector<T>& values() const { return _values; }
+
+  /// Row offsets of the diagonal (i = 0) or off-diagonal (i = 1)
+  /// block. The offsets of the off-diagonal block are relative to the
+  /// start of the block in cols() and values().
+  const std::vector<std::int32_t>& row_ptr(int i) const
+  {
+    return _row_ptr.at(i);
+  }
+
+  /// Local column index of each entry
+  const std::vector<std::int32_t>& cols() const { return _cols; }
+
+private:
+  // Compute the positions of the values sent to and received from
+  // other processes in finalize()
+  void compute_ghost_row_scatter(
+      const std::unordered_map<std::int64_t, std::int32_t>& global_to_local)
+  {
+    const int bs0 = _index_maps[0]->block_size();
+    const std::int64_t row_offset = bs0 * _index_maps[0]->local_range()[0];
+    const std::int64_t col_offset = _column_map->local_range()[0];
+    const Eigen::Array<std::int64_t, Eigen::Dynamic, 1>& col_ghosts
+        = _column_map->ghosts();
+    const Eigen::Array<std::int64_t, Eigen::Dynamic, 1>& row_ghosts
+        = _index_maps[0]->ghosts();
+
+    // Neighbors on the ghost-to-owner communicator of the row map
+    MPI_Comm comm = _index_maps[0]->comm(common::IndexMap::Direction::reverse);
+    int indegree(-1), outdegree(-2), weighted(-1);
+    MPI_Dist_graph_neighbors_count(comm, &indegree, &outdegree, &weighted);
+    std::vector<int> neighbors_in(indegree), neighbors_out(outdegree);
+    MPI_Dist_graph_neighbors(comm, indegree, neighbors_in.data(),
+                             MPI_UNWEIGHTED, outdegree, neighbors_out.data(),
+                             MPI_UNWEIGHTED);
+
+    // Neighbor index of the owner of each ghost row block
+    const Eigen::Array<int, Eigen::Dynamic, 1> owners
+        = _index_maps[0]->ghost_owner_rank();
+    std::vector<int> ghost_owner(owners.rows());
+    for (Eigen::Index i = 0; i < owners.rows(); ++i)
+    {
+      auto it
+          = std::find(neighbors_out.begin(), neighbors_out.end(), owners[i]);
+      assert(it != neighbors_out.end());
+      ghost_owner[i] = std::distance(neighbors_out.begin(), it);
+    }
+
+    // Count ghost row entries to send to each neighbor
+    auto row_size = [&](std::int32_t r) {
+      return _row_ptr[0][r + 1] - _row_ptr[0][r] + _row_ptr[1][r + 1]
+             - _row_ptr[1][r];
+    };
+    _send_sizes.assign(outdegree, 0);
+    for (std::int32_t r = _num_owned_rows; r < num_rows(); ++r)
+      _send_sizes[ghost_owner[(r - _num_owned_rows) / bs0]] += row_size(r);
+    _send_disp.assign(outdegree + 1, 0);
+    std::partial_sum(_send_sizes.begin(), _send_sizes.end(),
+                     _send_disp.begin() + 1);
+
+    // Pack global (row, column) of each entry and keep the position of
+    // its value
+    std::vector<std::int64_t> send_indices(2 * _send_disp.back());
+    _send_pos.resize(_send_disp.back());
+    std::vector<int> pos(_send_disp.begin(), _send_disp.end() - 1);
+    for (std::int32_t r = _num_owned_rows; r < num_rows(); ++r)
+    {
+      const std::div_t div = std::div(r - _num_owned_rows, bs0);
+      const std::int64_t row_global = bs0 * row_ghosts[div.quot] + div.rem;
+      int& p = pos[ghost_owner[div.quot]];
+      for (int b = 0; b < 2; ++b)
+      {
+        const std::int32_t offset = b == 0 ? 0 : _row_ptr[0].back();
+        for (std::int32_t k = offset + _row_ptr[b][r];
+             k < offset + _row_ptr[b][r + 1]; ++k)
+        {
+          const std::int32_t col = _cols[k];
+          send_indices[2 * p] = row_global;
+          send_indices[2 * p + 1]
+              = col < _num_owned_cols ? col + col_offset
+                                      : col_ghosts[col - _num_owned_cols];
+          _send_pos[p++] = k;
+        }
+      }
+    }
+
+    // Send number of entries and the entry indices to row owners
+    _recv_sizes.resize(indegree);
+    MPI_Neighbor_alltoall(_send_sizes.data(), 1, MPI_INT, _recv_sizes.data(),
+                          1, MPI_INT, comm);
+    _recv_disp.assign(indegree + 1, 0);
+    std::partial_sum(_recv_sizes.begin(), _recv_sizes.end(),
+                     _recv_disp.begin() + 1);
+
+    std::vector<int> send_sizes2(outdegree), send_disp2(outdegree);
+    std::vector<int> recv_sizes2(indegree), recv_disp2(indegree);
+    for (int i = 0; i < outdegree; ++i)
+    {
+      send_sizes2[i] = 2 * _send_sizes[i];
+      send_disp2[i] = 2 * _send_disp[i];
+    }
+    for (int i = 0; i < indegree; ++i)
+    {
+      recv_sizes2[i] = 2 * _recv_sizes[i];
+      recv_disp2[i] = 2 * _recv_disp[i];
+    }
+    std::vector<std::int64_t> recv_indices(2 * _recv_disp.back());
+    MPI_Neighbor_alltoallv(send_indices.data(), send_sizes2.data(),
+                           send_disp2.data(), MPI_INT64_T, recv_indices.data(),
+                           recv_sizes2.data(), recv_disp2.data(), MPI_INT64_T,
+                           comm);
+
+    // Compute position of received entries in owned rows
+    _recv_pos.resize(_recv_disp.back());
+    for (std::size_t i = 0; i < _recv_pos.size(); ++i)
+    {
+      const std::int64_t row = recv_indices[2 * i] - row_offset;
+      const std::int64_t col_global = recv_indices[2 * i + 1];
+      assert(row >= 0 and row < _num_owned_rows);
+      std::int32_t col = col_global - col_offset;
+      if (col_global < col_offset or col_global >= col_offset + _num_owned_cols)
+      {
+        auto it = global_to_local.find(col_global);
+        if (it == global_to_local.end())
+          throw std::runtime_error("Ghost row entry not in sparsity pattern.");
+        col = it->second;
+      }
+      _recv_pos[i] = position(row, col);
+      if (_recv_pos[i] < 0)
+        throw std::runtime_error("Ghost row entry not in sparsity pattern.");
+    }
+  }
+
+  // Maps for the distribution of the rows and columns
+  std::array<std::shared_ptr<const common::IndexMap>, 2> _index_maps;
+
+  // Map for the local columns (block size 1), with all non-owned
+  // columns as ghosts
+  std::shared_ptr<const common::IndexMap> _column_map;
+
+  // Number of owned rows and columns
+  std::int32_t _num_owned_rows, _num_owned_cols;
+
+  // CSR data. Row offsets for the diagonal and off-diagonal blocks.
+  std::array<std::vector<std::int32_t>, 2> _row_ptr;
+  std::vector<std::int32_t> _cols;
+  std::vector<T> _values;
+
+  // Ghost row communication: position of values to send and receive,
+  // and number and displacement of entries for each neighbor
+  std::vector<std::int32_t> _send_pos, _recv_pos;
+  std::vector<int> _send_sizes, _send_disp, _recv_sizes, _recv_disp;
+};
+
+} // namespace dolfinx::la
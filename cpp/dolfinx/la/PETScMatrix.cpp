@@ -6,6 +6,7 @@
 // SPDX-License-Identifier:    LGPL-3.0-or-later
 
 #include "PETScMatrix.h"
+#include "MatrixCSR.h"
 #include "PETScVector.h"
 #include "VectorSpaceBasis.h"
 #include "utils.h"
@@ -130,6 +131,70 @@ Mat la::create_petsc_matrix(
   return A;
 }
 //-----------------------------------------------------------------------------
+Mat la::create_petsc_matrix(MPI_Comm comm, MatrixCSR<PetscScalar>& A)
+{
+  const std::array index_maps = A.index_maps();
+  const int bs0 = index_maps[0]->block_size();
+  const int bs1 = index_maps[1]->block_size();
+  const std::int64_t M = bs0 * index_maps[0]->size_global();
+  const std::int64_t N = bs1 * index_maps[1]->size_global();
+  const std::int32_t m = A.num_owned_rows();
+  const std::int32_t n = A.num_owned_cols();
+
+  // Copy index arrays for the owned rows to PETSc format, with global
+  // column indices for the off-diagonal block. PETSc requires the
+  // columns of each row to be sorted, which MatrixCSR guarantees by
+  // storing the off-diagonal columns in order of global index. PETSc
+  // does not copy the arrays, so they are attached to the Mat and
+  // destroyed with it.
+  const std::vector<std::int32_t>& row_ptr0 = A.row_ptr(0);
+  const std::vector<std::int32_t>& row_ptr1 = A.row_ptr(1);
+  const std::vector<std::int32_t>& cols = A.cols();
+  auto indices = new std::array<std::vector<PetscInt>, 4>;
+  auto& [i0, j0, i1, j1] = *indices;
+  i0.assign(row_ptr0.begin(), row_ptr0.begin() + m + 1);
+  j0.assign(cols.begin(), cols.begin() + row_ptr0[m]);
+  i1.assign(row_ptr1.begin(), row_ptr1.begin() + m + 1);
+  j1.resize(row_ptr1[m]);
+  const std::int32_t offset = row_ptr0.back();
+  const Eigen::Array<std::int64_t, Eigen::Dynamic, 1>& col_ghosts
+      = A.column_map()->ghosts();
+  for (std::size_t k = 0; k < j1.size(); ++k)
+    j1[k] = col_ghosts[cols[offset + k] - n];
+
+  PetscScalar* values = A.values().data();
+  Mat mat;
+  PetscErrorCode ierr = MatCreateMPIAIJWithSplitArrays(
+      comm, m, n, M, N, i0.data(), j0.data(), values, i1.data(), j1.data(),
+      values + offset, &mat);
+  if (ierr != 0)
+  {
+    delete indices;
+    petsc_error(ierr, __FILE__, "MatCreateMPIAIJWithSplitArrays");
+  }
+
+  PetscContainer container;
+  ierr = PetscContainerCreate(comm, &container);
+  if (ierr != 0)
+    petsc_error(ierr, __FILE__, "PetscContainerCreate");
+  PetscContainerSetPointer(container, indices);
+  PetscContainerSetUserDestroy(container, [](void* ctx) -> PetscErrorCode {
+    delete static_cast<std::array<std::vector<PetscInt>, 4>*>(ctx);
+    return 0;
+  });
+  ierr = PetscObjectCompose((PetscObject)mat, "dolfinx_csr_indices",
+                            (PetscObject)container);
+  if (ierr != 0)
+    petsc_error(ierr, __FILE__, "PetscObjectCompose");
+  PetscContainerDestroy(&container);
+
+  ierr = MatSetBlockSizes(mat, bs0, bs1);
+  if (ierr != 0)
+    petsc_error(ierr, __FILE__, "MatSetBlockSizes");
+
+  return mat;
+}
+//-----------------------------------------------------------------------------
 MatNullSpace la::create_petsc_nullspace(MPI_Comm comm,
                                         const la::VectorSpaceBasis& nullspace)
 {
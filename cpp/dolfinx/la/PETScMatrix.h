@@ -18,11 +18,22 @@ namespace dolfinx::la
 {
 class SparsityPattern;
 class VectorSpaceBasis;
+template <typename T>
+class MatrixCSR;
 
 /// Create a PETSc Mat. Caller is responsible for destroying the
 /// returned object.
 Mat create_petsc_matrix(MPI_Comm comm, const SparsityPattern& sparsity_pattern);
 
+/// Create a PETSc MATMPIAIJ Mat that uses the values array of a
+/// MatrixCSR, i.e. without copying the values. The MatrixCSR must
+/// outlive the returned Mat and must be finalised before the Mat is
+/// used. If the values of @p A change, the state of the Mat should be
+/// increased (PetscObjectStateIncrease) to signal the change to PETSc
+/// objects that use the Mat. Caller is responsible for destroying the
+/// returned object.
+Mat create_petsc_matrix(MPI_Comm comm, MatrixCSR<PetscScalar>& A);
+
 /// Create PETSc MatNullSpace. Caller is responsible for destruction
 /// returned object.
 MatNullSpace create_petsc_nullspace(MPI_Comm comm,
@@ -274,8 +274,10 @@ void SparsityPattern::assemble()
       = _index_maps[1]->ghosts();
 
   // For each ghost row, pack and send (global row, global col) pairs to
-  // send to neighborhood
+  // send to neighborhood. The columns of each ghost row are also kept
+  // (global column indices) for matrices that assemble into ghost rows.
   std::vector<std::int64_t> ghost_data;
+  std::vector<std::vector<std::int64_t>> ghost_rows(bs0 * num_ghosts0);
   for (int i = 0; i < num_ghosts0; ++i)
   {
     const std::int64_t row_node_global = ghosts0[i];
@@ -284,6 +286,7 @@ void SparsityPattern::assemble()
     {
       const std::int64_t row_global = bs0 * row_node_global + j;
       const std::int32_t row_local = bs0 * row_node_local + j;
+      std::vector<std::int64_t>& ghost_row = ghost_rows[bs0 * i + j];
       assert((std::size_t)row_local < _diagonal_cache.size());
       const std::vector<std::int32_t>& cols = _diagonal_cache[row_local];
       for (std::size_t c = 0; c < cols.size(); ++c)
@@ -292,13 +295,14 @@ void SparsityPattern::assemble()
 
         // Convert to global column index
         if (cols[c] < bs1 * local_size1)
-          ghost_data.push_back(cols[c] + bs1 * local_range1[0]);
+          ghost_row.push_back(cols[c] + bs1 * local_range1[0]);
         else
         {
           const std::div_t div = std::div(cols[c], bs1);
           const std::int64_t block_global = ghosts1[div.quot - local_size1];
-          ghost_data.push_back(bs1 * block_global + div.rem);
+          ghost_row.push_back(bs1 * block_global + div.rem);
         }
+        ghost_data.push_back(ghost_row.back());
       }
 
       const std::vector<std::int64_t>& cols_off
@@ -307,9 +311,16 @@ void SparsityPattern::assemble()
       {
         ghost_data.push_back(row_global);
         ghost_data.push_back(cols_off[c]);
+        ghost_row.push_back(cols_off[c]);
       }
+
+      std::sort(ghost_row.begin(), ghost_row.end());
+      ghost_row.erase(std::unique(ghost_row.begin(), ghost_row.end()),
+                      ghost_row.end());
     }
   }
+  _ghost_rows = std::make_shared<graph::AdjacencyList<std::int64_t>>(
+      ghost_rows);
 
   MPI_Comm comm = _index_maps[0]->comm(common::IndexMap::Direction::symmetric);
   int num_neighbors(-1), outdegree(-2), weighted(-1);
@@ -406,5 +417,13 @@ SparsityPattern::off_diagonal_pattern() const
   return *_off_diagonal;
 }
 //-----------------------------------------------------------------------------
+const graph::AdjacencyList<std::int64_t>&
+SparsityPattern::ghost_row_pattern() const
+{
+  if (!_ghost_rows)
+    throw std::runtime_error("Sparsity pattern has not been finalised.");
+  return *_ghost_rows;
+}
+//-----------------------------------------------------------------------------
 MPI_Comm SparsityPattern::mpi_comm() const { return _mpi_comm.comm(); }
 //-----------------------------------------------------------------------------
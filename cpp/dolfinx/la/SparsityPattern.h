@@ -103,6 +103,12 @@ public:
   /// indices for the columns.
   const graph::AdjacencyList<std::int64_t>& off_diagonal_pattern() const;
 
+  /// Sparsity pattern for the ghost rows, i.e. rows that have entries
+  /// computed on this process but are owned by another process. Row i
+  /// is the ith ghost row (unrolled for the block size). Uses global
+  /// indices for the columns.
+  const graph::AdjacencyList<std::int64_t>& ghost_row_pattern() const;
+
   /// Return MPI communicator
   MPI_Comm mpi_comm() const;
 
@@ -120,6 +126,7 @@ private:
   // Sparsity pattern data (computed once pattern is finalised)
   std::shared_ptr<graph::AdjacencyList<std::int32_t>> _diagonal;
   std::shared_ptr<graph::AdjacencyList<std::int64_t>> _off_diagonal;
+  std::shared_ptr<graph::AdjacencyList<std::int64_t>> _ghost_rows;
 };
 } // namespace la
 } // namespace dolfinx
@@ -7,8 +7,13 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <dolfinx/common/IndexMap.h>
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace dolfinx::la
 {
@@ -28,11 +33,23 @@ public:
     _x.resize(local_size);
   }
 
-  /// Copy constructor
-  Vector(const Vector& x) = default;
+  /// Copy constructor. The ghost update buffers are not copied.
+  Vector(const Vector& x)
+      : _map(x._map), _x(x._x), _version(x._version.load())
+  {
+  }
 
   /// Move constructor
-  Vector(Vector&& x) noexcept = default;
+  Vector(Vector&& x) noexcept
+      : _map(std::move(x._map)), _x(std::move(x._x)),
+        _version(x._version.load()),
+        _buffer_local(std::move(x._buffer_local)),
+        _buffer_remote(std::move(x._buffer_remote)),
+        _buffer_send(std::move(x._buffer_send)),
+        _buffer_recv(std::move(x._buffer_recv)),
+        _request(std::exchange(x._request, MPI_REQUEST_NULL))
+  {
+  }
 
   /// Destructor
   ~Vector() = default;
@@ -41,7 +58,18 @@ public:
   Vector& operator=(const Vector& x) = delete;
 
   /// Move Assignment operator
-  Vector& operator=(Vector&& x) = default;
+  Vector& operator=(Vector&& x) noexcept
+  {
+    _map = std::move(x._map);
+    _x = std::move(x._x);
+    _version = x._version.load();
+    _buffer_local = std::move(x._buffer_local);
+    _buffer_remote = std::move(x._buffer_remote);
+    _buffer_send = std::move(x._buffer_send);
+    _buffer_recv = std::move(x._buffer_recv);
+    _request = std::exchange(x._request, MPI_REQUEST_NULL);
+    return *this;
+  }
 
   /// Get local part of the vector (const version)
   std::shared_ptr<const common::IndexMap> map() const { return _map; }
@@ -49,14 +77,101 @@ public:
   /// Get local part of the vector (const version)
   const Eigen::Matrix<T, Eigen::Dynamic, 1>& array() const { return _x; }
 
-  /// Get local part of the vector
+  /// Get local part of the vector. Code that modifies the values
+  /// through the returned reference must call mark_modified().
   Eigen::Matrix<T, Eigen::Dynamic, 1>& array() { return _x; }
 
+  /// Record that the values have been modified through array(). This
+  /// increments version().
+  void mark_modified() { ++_version; }
+
+  /// Version counter of the values. It is incremented by
+  /// mark_modified() and by each ghost update, so the values have not
+  /// changed if the version has not changed.
+  std::uint64_t version() const { return _version; }
+
+  /// Update ghost entries with the values held by the owning process
+  void scatter_fwd()
+  {
+    scatter_fwd_begin();
+    scatter_fwd_end();
+  }
+
+  /// Start updating ghost entries with the values held by the owning
+  /// process. Owned entries may be read, but not modified, and ghost
+  /// entries must not be accessed before scatter_fwd_end() is called.
+  void scatter_fwd_begin()
+  {
+    const int bs = _map->block_size();
+    const std::int32_t size_owned = bs * _map->size_local();
+    _buffer_local.assign(_x.data(), _x.data() + size_owned);
+    _map->scatter_fwd_begin(_buffer_local, bs, _buffer_send, _buffer_recv,
+                            _request);
+  }
+
+  /// Complete the update of ghost entries started by
+  /// scatter_fwd_begin()
+  void scatter_fwd_end()
+  {
+    const int bs = _map->block_size();
+    const std::int32_t size_owned = bs * _map->size_local();
+    _map->scatter_fwd_end(_buffer_remote, bs, _buffer_recv, _request);
+    std::copy(_buffer_remote.begin(), _buffer_remote.end(),
+              _x.data() + size_owned);
+    mark_modified();
+  }
+
+  /// Send ghost entries to the owning process, where they are inserted
+  /// or accumulated into the owned entries. Ghost entries are not
+  /// modified.
+  /// @param[in] op Insert or add received values into owned entries
+  void scatter_rev(common::IndexMap::Mode op)
+  {
+    scatter_rev_begin();
+    scatter_rev_end(op);
+  }
+
+  /// Start sending ghost entries to the owning process. Ghost entries
+  /// may be modified after this call. Owned entries must not be
+  /// modified before scatter_rev_end() is called.
+  void scatter_rev_begin()
+  {
+    const int bs = _map->block_size();
+    const std::int32_t size_owned = bs * _map->size_local();
+    _buffer_remote.assign(_x.data() + size_owned, _x.data() + _x.size());
+    _map->scatter_rev_begin(_buffer_remote, bs, _buffer_send, _buffer_recv,
+                            _request);
+  }
+
+  /// Complete sending ghost entries to the owning process, and insert
+  /// or add the received values into the owned entries
+  /// @param[in] op Insert or add received values into owned entries
+  void scatter_rev_end(common::IndexMap::Mode op)
+  {
+    const int bs = _map->block_size();
+    const std::int32_t size_owned = bs * _map->size_local();
+    _buffer_local.assign(_x.data(), _x.data() + size_owned);
+    _map->scatter_rev_end(_buffer_local, bs, _buffer_recv, op, _request);
+    std::copy(_buffer_local.begin(), _buffer_local.end(), _x.data());
+    mark_modified();
+  }
+
 private:
   // Map describing the data layout
   std::shared_ptr<const common::IndexMap> _map;
 
   // Data
   Eigen::Matrix<T, Eigen::Dynamic, 1> _x;
+
+  // Version counter of the data. It is atomic since the values of a
+  // vector may be accessed from several threads.
+  std::atomic<std::uint64_t> _version{0};
+
+  // Buffers for ghost updates, kept between updates to avoid
+  // reallocation
+  std::vector<T> _buffer_local, _buffer_remote, _buffer_send, _buffer_recv;
+
+  // Request for non-blocking ghost updates
+  MPI_Request _request = MPI_REQUEST_NULL;
 };
 } // namespace dolfinx::la
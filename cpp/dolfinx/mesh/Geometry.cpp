@@ -54,11 +54,10 @@ const std::vector<std::int64_t>& Geometry::input_global_indices() const
 //-----------------------------------------------------------------------------
 std::size_t Geometry::hash() const
 {
-  // Compute local hash
-  boost::hash<std::vector<double>> dhash;
-
-  std::vector<double> data(_x.data(), _x.data() + _x.size());
-  const std::size_t local_hash = dhash(data);
+  // Compute local hash, including the dofmap so that the hash changes
+  // if the connectivity of higher-order geometry nodes changes
+  std::size_t local_hash = boost::hash_range(_x.data(), _x.data() + _x.size());
+  boost::hash_combine(local_hash, _dofmap.hash());
   return local_hash;
 }
 //-----------------------------------------------------------------------------
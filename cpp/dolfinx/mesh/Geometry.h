@@ -103,9 +103,9 @@ public:
   /// Global user indices
   const std::vector<std::int64_t>& input_global_indices() const;
 
-  /// Hash of coordinate values
-  /// @return A tree-hashed value of the coordinates over all MPI
-  ///   processes
+  /// Hash of coordinate values and the dofmap
+  /// @return A hash of the coordinates (including ghosts) and the
+  ///   dofmap on this process
   std::size_t hash() const;
 
 private:
@@ -23,6 +23,8 @@
 #include <dolfinx/io/cells.h>
 #include <dolfinx/mesh/cell_types.h>
 #include <memory>
+#include <numeric>
+#include <tuple>
 
 using namespace dolfinx;
 using namespace dolfinx::mesh;
@@ -58,6 +60,48 @@ Eigen::ArrayXd cell_r(const mesh::Mesh& mesh)
   return mesh::inradius(mesh, cells);
 }
 //-----------------------------------------------------------------------------
+// Move the first map.size() nodes of an adjacency list to the
+// positions given by map (map[old] -> new). Other nodes are not moved.
+// Returns the reordered list and the old position of each node.
+std::pair<graph::AdjacencyList<std::int64_t>, std::vector<std::int32_t>>
+reorder_list(const graph::AdjacencyList<std::int64_t>& list,
+             const std::vector<std::int32_t>& map)
+{
+  std::vector<std::int32_t> old_node(list.num_nodes());
+  std::iota(old_node.begin(), old_node.end(), 0);
+  for (std::size_t i = 0; i < map.size(); ++i)
+    old_node[map[i]] = i;
+
+  Eigen::Array<std::int32_t, Eigen::Dynamic, 1> offsets(list.num_nodes() + 1);
+  offsets[0] = 0;
+  for (std::int32_t i = 0; i < list.num_nodes(); ++i)
+    offsets[i + 1] = offsets[i] + list.num_links(old_node[i]);
+
+  Eigen::Array<std::int64_t, Eigen::Dynamic, 1> array(
+      offsets[offsets.rows() - 1]);
+  for (std::int32_t i = 0; i < list.num_nodes(); ++i)
+  {
+    auto links = list.links(old_node[i]);
+    array.segment(offsets[i], links.rows()) = links;
+  }
+
+  return {graph::AdjacencyList<std::int64_t>(std::move(array),
+                                             std::move(offsets)),
+          std::move(old_node)};
+}
+//-----------------------------------------------------------------------------
+// Reorder the data of each node of an adjacency list, given the old
+// position of each node (see reorder_list)
+template <typename T>
+std::vector<T> reorder_data(const std::vector<T>& data,
+                            const std::vector<std::int32_t>& old_node)
+{
+  std::vector<T> new_data(data.size());
+  for (std::size_t i = 0; i < data.size(); ++i)
+    new_data[i] = data[old_node[i]];
+  return new_data;
+}
+//-----------------------------------------------------------------------------
 } // namespace
 
 //-----------------------------------------------------------------------------
@@ -66,7 +110,7 @@ Mesh mesh::create_mesh(MPI_Comm comm,
                        const fem::CoordinateElement& element,
                        const Eigen::Array<double, Eigen::Dynamic,
                                           Eigen::Dynamic, Eigen::RowMajor>& x,
-                       mesh::GhostMode ghost_mode)
+                       mesh::GhostMode ghost_mode, bool reorder)
 {
   if (ghost_mode == mesh::GhostMode::shared_vertex)
     throw std::runtime_error("Ghost mode via vertex currently disabled.");
@@ -90,9 +134,25 @@ Mesh mesh::create_mesh(MPI_Comm comm,
                                       cells_topology, GhostMode::shared_facet);
 
   // Distribute cells to destination rank
-  const auto [cell_nodes, src, original_cell_index, ghost_owners]
+  auto [cell_nodes, src, original_cell_index, ghost_owners]
       = graph::Partitioning::distribute(comm, cells, dest);
 
+  // Reorder owned cells for data locality. Ghost cells are at the end
+  // and keep their order.
+  if (reorder)
+  {
+    const std::int32_t num_owned = cell_nodes.num_nodes() - ghost_owners.size();
+    const std::vector<std::int32_t> map = Partitioning::reorder_cells(
+        element.cell_shape(),
+        mesh::extract_topology(element.cell_shape(), element.dof_layout(),
+                               cell_nodes),
+        num_owned);
+    std::vector<std::int32_t> old_cell;
+    std::tie(cell_nodes, old_cell) = reorder_list(cell_nodes, map);
+    src = reorder_data(src, old_cell);
+    original_cell_index = reorder_data(original_cell_index, old_cell);
+  }
+
   // Create cells and vertices with the ghosting requested. Input topology
   // includes cells shared via facet, but output will remove these, if not
   // required by ghost_mode.
@@ -155,11 +155,17 @@ private:
 };
 
 /// Create a mesh
+///
+/// If @p reorder is true, the owned cells on each process are reordered
+/// after distribution using Partitioning::reorder_cells to improve data
+/// locality. The reordering is applied before the topology and geometry
+/// are created, so both use the new order, and the original index of
+/// each cell is preserved.
 Mesh create_mesh(MPI_Comm comm, const graph::AdjacencyList<std::int64_t>& cells,
                  const fem::CoordinateElement& element,
                  const Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic,
                                     Eigen::RowMajor>& x,
-                 GhostMode ghost_mode);
+                 GhostMode ghost_mode, bool reorder = false);
 
 } // namespace mesh
 } // namespace dolfinx
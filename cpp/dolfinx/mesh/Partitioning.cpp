@@ -12,6 +12,7 @@
 #include <dolfinx/common/Timer.h>
 #include <dolfinx/common/log.h>
 #include <dolfinx/graph/AdjacencyList.h>
+#include <dolfinx/graph/BoostGraphOrdering.h>
 #include <dolfinx/graph/SCOTCH.h>
 #include <dolfinx/mesh/GraphBuilder.h>
 
@@ -65,3 +66,27 @@ graph::AdjacencyList<std::int32_t> Partitioning::partition_cells(
   return partition;
 }
 //-----------------------------------------------------------------------------
+std::vector<std::int32_t>
+Partitioning::reorder_cells(const mesh::CellType cell_type,
+                            const graph::AdjacencyList<std::int64_t>& cells,
+                            std::int32_t num_cells)
+{
+  common::Timer timer("Reorder cells for locality");
+  assert(num_cells <= cells.num_nodes());
+
+  const int num_vertices = mesh::num_cell_vertices(cell_type);
+  if (num_cells > 0 and cells.num_links(0) != num_vertices)
+    throw std::runtime_error("Inconsistent number of cell vertices.");
+  const Eigen::Map<const Eigen::Array<std::int64_t, Eigen::Dynamic,
+                                      Eigen::Dynamic, Eigen::RowMajor>>
+      _cells(cells.array().data(), num_cells, num_vertices);
+
+  // Compute local dual graph and its reverse Cuthill-McKee ordering
+  const auto [dual_graph, facet_cell_map, num_edges]
+      = mesh::GraphBuilder::compute_local_dual_graph(_cells, cell_type);
+  const std::vector<int> map = graph::BoostGraphOrdering::compute_cuthill_mckee(
+      graph::AdjacencyList<std::int32_t>(dual_graph), true);
+
+  return std::vector<std::int32_t>(map.begin(), map.end());
+}
+//-----------------------------------------------------------------------------
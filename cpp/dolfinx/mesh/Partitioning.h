@@ -46,6 +46,24 @@ public:
   partition_cells(MPI_Comm comm, int n, const mesh::CellType cell_type,
                   const graph::AdjacencyList<std::int64_t>& cells,
                   mesh::GhostMode ghost_mode);
+
+  /// Compute a reordering of the cells on this process that improves
+  /// data locality, using the reverse Cuthill-McKee ordering of the
+  /// local dual graph (cells connected by a facet). Cells that are
+  /// neighbors in the mesh are then close in memory, which reduces
+  /// cache misses when accessing cell data during assembly.
+  ///
+  /// @param[in] cell_type Cell type
+  /// @param[in] cells Cells on this process. The ith entry in list
+  ///   contains the global indices for the cell vertices. High-order
+  ///   'nodes' should not be included.
+  /// @param[in] num_cells Number of cells to reorder, which are the
+  ///   first @p num_cells cells in @p cells
+  /// @return The new position of each cell (map[old] -> new)
+  static std::vector<std::int32_t>
+  reorder_cells(const mesh::CellType cell_type,
+                const graph::AdjacencyList<std::int64_t>& cells,
+                std::int32_t num_cells);
 };
 } // namespace mesh
 } // namespace dolfinx
@@ -165,7 +165,7 @@ std::shared_ptr<const common::IndexMap> Topology::index_map(int dim) const
   return _index_map[dim];
 }
 //-----------------------------------------------------------------------------
-std::int32_t Topology::create_entities(int dim)
+std::int32_t Topology::create_entities(int dim, int num_threads)
 {
   // TODO: is this check sufficient/correct? Does not catch the cell_entity
   // entity case. Should there also be a check for
@@ -176,7 +176,8 @@ std::int32_t Topology::create_entities(int dim)
 
   // Create local entities
   const auto [cell_entity, entity_vertex, index_map]
-      = TopologyComputation::compute_entities(_mpi_comm.comm(), *this, dim);
+      = TopologyComputation::compute_entities(_mpi_comm.comm(), *this, dim,
+                                              num_threads);
 
   if (cell_entity)
     set_connectivity(cell_entity, this->dim(), dim);
@@ -191,15 +192,15 @@ std::int32_t Topology::create_entities(int dim)
   return index_map->size_local();
 }
 //-----------------------------------------------------------------------------
-void Topology::create_connectivity(int d0, int d1)
+void Topology::create_connectivity(int d0, int d1, int num_threads)
 {
   // Make sure entities exist
-  create_entities(d0);
-  create_entities(d1);
+  create_entities(d0, num_threads);
+  create_entities(d1, num_threads);
 
   // Compute connectivity
   const auto [c_d0_d1, c_d1_d0]
-      = TopologyComputation::compute_connectivity(*this, d0, d1);
+      = TopologyComputation::compute_connectivity(*this, d0, d1, num_threads);
 
   // NOTE: that to compute the (d0, d1) connections is it sometimes
   // necessary to compute the (d1, d0) connections. We store the (d1,
@@ -140,14 +140,18 @@ public:
   // creation of entities
   /// Create entities of given topological dimension.
   /// @param[in] dim Topological dimension
+  /// @param[in] num_threads Number of threads for the local part of the
+  ///   computation
   /// @return Number of newly created entities, returns -1 if entities
   ///   already existed
-  std::int32_t create_entities(int dim);
+  std::int32_t create_entities(int dim, int num_threads = 1);
 
   /// Create connectivity between given pair of dimensions, d0 -> d1
   /// @param[in] d0 Topological dimension
   /// @param[in] d1 Topological dimension
-  void create_connectivity(int d0, int d1);
+  /// @param[in] num_threads Number of threads for the local part of the
+  ///   computation
+  void create_connectivity(int d0, int d1, int num_threads = 1);
 
   /// Compute entity permutations and reflections
   void create_entity_permutations();
@@ -9,7 +9,7 @@
 #include "cell_types.h"
 #include <Eigen/Dense>
 #include <algorithm>
-#include <boost/unordered_map.hpp>
+#include <atomic>
 #include <cstdint>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/MPI.h>
@@ -49,33 +49,6 @@ int get_ownership(std::set<int>& processes, std::vector<std::int64_t>& vertices)
   return owner;
 }
 
-/// Takes an array and computes the sort permutation that would reorder
-/// the rows in ascending order
-/// @param[in] array The input array
-/// @return The permutation vector that would order the rows in
-///   ascending order
-/// @pre Each row of @p array must be sorted
-template <typename T>
-std::vector<int>
-sort_by_perm(const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic,
-                                Eigen::RowMajor>& array)
-{
-  // Sort an Eigen::Array by creating a permutation vector
-  std::vector<int> index(array.rows());
-  std::iota(index.begin(), index.end(), 0);
-  const int cols = array.cols();
-
-  // Lambda with capture for sort comparison
-  const auto cmp = [&array, &cols](int a, int b) {
-    const T* row_a = array.row(a).data();
-    const T* row_b = array.row(b).data();
-    return std::lexicographical_compare(row_a, row_a + cols, row_b,
-                                        row_b + cols);
-  };
-
-  std::sort(index.begin(), index.end(), cmp);
-  return index;
-}
 //-----------------------------------------------------------------------------
 
 /// Communicate with sharing processes to find out which entities are
@@ -411,6 +384,7 @@ get_local_indexing(
 /// @param[in] shared_vertices TODO
 /// @param[in] cell_type Cell type
 /// @param[in] dim Topological dimension of the entities to be computed
+/// @param[in] num_threads Number of threads for the local computations
 /// @return Returns the (cell-entity connectivity, entity-cell
 ///   connectivity, index map for the entity distribution across
 ///   processes, shared entities)
@@ -421,7 +395,7 @@ compute_entities_by_key_matching(
     MPI_Comm comm, const graph::AdjacencyList<std::int32_t>& cells,
     const std::shared_ptr<const common::IndexMap>& vertex_index_map,
     const std::shared_ptr<const common::IndexMap>& cell_index_map,
-    mesh::CellType cell_type, int dim)
+    mesh::CellType cell_type, int dim, int num_threads)
 {
   if (dim == 0)
   {
@@ -444,52 +418,60 @@ compute_entities_by_key_matching(
 
   const int num_cells = cells.num_nodes();
 
-  // List of vertices for each entity in each cell
+  // List of vertices for each entity in each cell, and a copy with the
+  // vertices of each entity sorted
   Eigen::Array<std::int32_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
-      entity_list(num_cells * num_entities_per_cell, num_vertices_per_entity);
-  int k = 0;
-  for (int c = 0; c < num_cells; ++c)
-  {
-    // Get vertices from cell
-    auto vertices = cells.links(c);
-
-    // Iterate over entities of cell
-    for (int i = 0; i < num_entities_per_cell; ++i)
-    {
-      // Get entity vertices
-      for (int j = 0; j < num_vertices_per_entity; ++j)
-        entity_list(k, j) = vertices[e_vertices(i, j)];
-
-      ++k;
-    }
-  }
-  assert(k == entity_list.rows());
-
+      entity_list(num_cells * num_entities_per_cell, num_vertices_per_entity),
+      entity_list_sorted(num_cells * num_entities_per_cell,
+                         num_vertices_per_entity);
+  common::parallel_for(
+      num_cells, num_threads, [&](int, std::int32_t c0, std::int32_t c1) {
+        for (std::int32_t c = c0; c < c1; ++c)
+        {
+          // Get vertices from cell
+          auto vertices = cells.links(c);
+
+          // Iterate over entities of cell
+          for (int i = 0; i < num_entities_per_cell; ++i)
+          {
+            const std::int32_t k = c * num_entities_per_cell + i;
+            std::int32_t* e = entity_list.row(k).data();
+            for (int j = 0; j < num_vertices_per_entity; ++j)
+              e[j] = vertices[e_vertices(i, j)];
+
+            std::int32_t* e_sorted = entity_list_sorted.row(k).data();
+            std::copy_n(e, num_vertices_per_entity, e_sorted);
+            std::sort(e_sorted, e_sorted + num_vertices_per_entity);
+          }
+        }
+      });
+
+  // Sort the list and label uniquely. Keep a representative row in
+  // entity_list for each entity. The sort is stable, so the
+  // representative is the last occurrence of the entity in entity_list.
+  const std::vector<std::int32_t> sort_order = common::sort_rows_by_perm(
+      entity_list_sorted.data(), entity_list_sorted.rows(),
+      num_vertices_per_entity, num_threads);
   std::vector<std::int32_t> entity_index(entity_list.rows());
-  std::int32_t entity_count = 0;
-
-  // Copy list and sort vertices of each entity into order
-  Eigen::Array<std::int32_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
-      entity_list_sorted = entity_list;
-  for (int i = 0; i < entity_list_sorted.rows(); ++i)
+  std::vector<std::int32_t> entity_rows;
+  entity_rows.reserve(entity_list.rows() / 2);
+  if (!sort_order.empty())
   {
-    std::sort(entity_list_sorted.row(i).data(),
-              entity_list_sorted.row(i).data() + num_vertices_per_entity);
+    entity_rows.push_back(sort_order[0]);
+    entity_index[sort_order[0]] = 0;
   }
-
-  // Sort the list and label uniquely
-  const std::vector sort_order = sort_by_perm<std::int32_t>(entity_list_sorted);
-  std::int32_t last = sort_order[0];
-  entity_index[last] = 0;
   for (std::size_t i = 1; i < sort_order.size(); ++i)
   {
-    std::int32_t j = sort_order[i];
-    if ((entity_list_sorted.row(j) != entity_list_sorted.row(last)).any())
-      ++entity_count;
-    entity_index[j] = entity_count;
-    last = j;
+    const std::int32_t* row = entity_list_sorted.row(sort_order[i]).data();
+    const std::int32_t* last
+        = entity_list_sorted.row(entity_rows.back()).data();
+    if (std::equal(row, row + num_vertices_per_entity, last))
+      entity_rows.back() = sort_order[i];
+    else
+      entity_rows.push_back(sort_order[i]);
+    entity_index[sort_order[i]] = entity_rows.size() - 1;
   }
-  ++entity_count;
+  const std::int32_t entity_count = entity_rows.size();
 
   // Communicate with other processes to find out which entities are
   // ghosted and shared. Remap the numbering so that ghosts are at the
@@ -508,8 +490,14 @@ compute_entities_by_key_matching(
   // Entity-vertex connectivity
   Eigen::Array<std::int32_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
       connectivity_ev(entity_count, num_vertices_per_entity);
-  for (int i = 0; i < entity_list.rows(); ++i)
-    connectivity_ev.row(local_index[i]) = entity_list.row(i);
+  common::parallel_for(
+      entity_count, num_threads, [&](int, std::int32_t e0, std::int32_t e1) {
+        for (std::int32_t e = e0; e < e1; ++e)
+        {
+          const std::int32_t row = entity_rows[e];
+          connectivity_ev.row(local_index[row]) = entity_list.row(row);
+        }
+      });
 
   auto ev
       = std::make_shared<graph::AdjacencyList<std::int32_t>>(connectivity_ev);
@@ -519,110 +507,189 @@ compute_entities_by_key_matching(
 //-----------------------------------------------------------------------------
 
 /// Compute connectivity from entities of dimension d0 to entities of
-/// dimension d1 using the transpose connectivity (d1 -> d0)
+/// dimension d1 using the transpose connectivity (d1 -> d0). A
+/// counting sort is used: the number of connections of each e0 is
+/// counted, and the connections are then written directly to their
+/// final position. With more than one thread, the counts and insert
+/// positions are atomic, and the connections of each e0 are sorted
+/// after insertion.
 /// @param[in] c_d1_d0 The connectivity from entities of dimension d1 to
 ///   entities of dimension d0
 /// @param[in] num_entities_d0 The number of entities of dimension d0
+/// @param[in] num_threads Number of threads
 /// @return The connectivity from entities of dimension d0 to entities
 ///   of dimension d1
 graph::AdjacencyList<std::int32_t>
 compute_from_transpose(const graph::AdjacencyList<std::int32_t>& c_d1_d0,
-                       const int num_entities_d0, int d0, int d1)
+                       const int num_entities_d0, int d0, int d1,
+                       int num_threads)
 {
   LOG(INFO) << "Computing mesh connectivity " << d0 << " - " << d1
             << "from transpose.";
 
-  // Compute number of connections for each e0
-  std::vector<std::int32_t> num_connections(num_entities_d0, 0);
-  for (int e1 = 0; e1 < c_d1_d0.num_nodes(); ++e1)
+  const Eigen::Array<std::int32_t, Eigen::Dynamic, 1>& c_offsets
+      = c_d1_d0.offsets();
+  const Eigen::Array<std::int32_t, Eigen::Dynamic, 1>& c_array
+      = c_d1_d0.array();
+  Eigen::Array<std::int32_t, Eigen::Dynamic, 1> offsets(num_entities_d0 + 1);
+  Eigen::Array<std::int32_t, Eigen::Dynamic, 1> connections(c_array.rows());
+
+  if (num_threads <= 1)
   {
-    auto e = c_d1_d0.links(e1);
-    for (int i = 0; i < e.rows(); ++i)
-      num_connections[e[i]]++;
+    // Count the number of connections for each e0
+    std::vector<std::int32_t> pos(num_entities_d0, 0);
+    for (Eigen::Index i = 0; i < c_array.rows(); ++i)
+      ++pos[c_array[i]];
+
+    // Compute offsets, and insert connections in order of e1
+    offsets[0] = 0;
+    std::partial_sum(pos.begin(), pos.end(), offsets.data() + 1);
+    std::copy(offsets.data(), offsets.data() + num_entities_d0, pos.begin());
+    for (std::int32_t e1 = 0; e1 < c_d1_d0.num_nodes(); ++e1)
+    {
+      for (std::int32_t i = c_offsets[e1]; i < c_offsets[e1 + 1]; ++i)
+        connections[pos[c_array[i]]++] = e1;
+    }
+
+    return graph::AdjacencyList<std::int32_t>(std::move(connections),
+                                              std::move(offsets));
   }
 
-  // Compute offsets
-  Eigen::Array<std::int32_t, Eigen::Dynamic, 1> offsets
-      = Eigen::Array<std::int32_t, Eigen::Dynamic, 1>::Zero(
-          num_connections.size() + 1);
-  std::partial_sum(num_connections.begin(), num_connections.end(),
-                   offsets.data() + 1);
-
-  std::vector<std::int32_t> counter(num_connections.size(), 0);
-  Eigen::Array<std::int32_t, Eigen::Dynamic, 1> connections(
-      offsets[offsets.rows() - 1]);
-  for (int e1 = 0; e1 < c_d1_d0.num_nodes(); ++e1)
+  // Count the number of connections for each e0. The counters are
+  // value-initialised to zero.
+  std::vector<std::atomic<std::int32_t>> pos(num_entities_d0);
+  common::parallel_for(
+      c_d1_d0.num_nodes(), num_threads,
+      [&](int, std::int32_t e1_0, std::int32_t e1_1) {
+        for (std::int32_t i = c_offsets[e1_0]; i < c_offsets[e1_1]; ++i)
+          pos[c_array[i]].fetch_add(1, std::memory_order_relaxed);
+      });
+
+  // Compute offsets, and reset the counters to the insert positions
+  offsets[0] = 0;
+  for (std::int32_t e0 = 0; e0 < num_entities_d0; ++e0)
   {
-    auto e = c_d1_d0.links(e1);
-    for (int e0 = 0; e0 < e.rows(); ++e0)
-      connections[offsets[e[e0]] + counter[e[e0]]++] = e1;
+    offsets[e0 + 1] = offsets[e0] + pos[e0].load(std::memory_order_relaxed);
+    pos[e0].store(offsets[e0], std::memory_order_relaxed);
   }
 
+  // Insert connections, and sort the connections of each e0
+  common::parallel_for(
+      c_d1_d0.num_nodes(), num_threads,
+      [&](int, std::int32_t e1_0, std::int32_t e1_1) {
+        for (std::int32_t e1 = e1_0; e1 < e1_1; ++e1)
+        {
+          for (std::int32_t i = c_offsets[e1]; i < c_offsets[e1 + 1]; ++i)
+          {
+            connections[pos[c_array[i]].fetch_add(
+                1, std::memory_order_relaxed)]
+                = e1;
+          }
+        }
+      });
+  common::parallel_for(
+      num_entities_d0, num_threads,
+      [&](int, std::int32_t e0_0, std::int32_t e0_1) {
+        for (std::int32_t e0 = e0_0; e0 < e0_1; ++e0)
+        {
+          std::sort(connections.data() + offsets[e0],
+                    connections.data() + offsets[e0 + 1]);
+        }
+      });
+
   return graph::AdjacencyList<std::int32_t>(std::move(connections),
                                             std::move(offsets));
 }
 //-----------------------------------------------------------------------------
 
-/// Compute the d0 -> d1 connectivity, where d0 > d1
+/// Compute the d0 -> d1 connectivity, where d0 > d1. The d1 entities
+/// are sorted by their (sorted) vertex lists, and the d1 entities of
+/// each d0 entity are then found by a binary search. The search is
+/// carried out in parallel over the d0 entities, without allocation.
 /// @param[in] c_d0_0 The d0 -> 0 (entity (d0) to vertex) connectivity
 /// @param[in] c_d0_0 The d1 -> 0 (entity (d1) to vertex) connectivity
 /// @param[in] cell_type_d0 The cell type for entities of dimension d0
 /// @param[in] d0 Topological dimension
 /// @param[in] d1 Topological dimension
+/// @param[in] num_threads Number of threads
 /// @return The d0 -> d1 connectivity
 graph::AdjacencyList<std::int32_t>
 compute_from_map(const graph::AdjacencyList<std::int32_t>& c_d0_0,
                  const graph::AdjacencyList<std::int32_t>& c_d1_0,
-                 CellType cell_type_d0, int d0, int d1)
+                 CellType cell_type_d0, int d0, int d1, int num_threads)
 {
   assert(d1 > 0);
   assert(d0 > d1);
 
-  // Make a map from the sorted d1 entity vertices to the d1 entity
-  // index
-  boost::unordered_map<std::vector<std::int32_t>, std::int32_t> entity_to_index;
-  entity_to_index.reserve(c_d1_0.num_nodes());
-
-  const std::size_t num_verts_d1
+  const int num_verts_d1
       = mesh::num_cell_vertices(mesh::cell_entity_type(cell_type_d0, d1));
+  const std::int32_t num_entities_d1 = c_d1_0.num_nodes();
 
-  std::vector<std::int32_t> key(num_verts_d1);
-  for (int e = 0; e < c_d1_0.num_nodes(); ++e)
-  {
-    const std::int32_t* v = c_d1_0.links_ptr(e);
-    std::partial_sort_copy(v, v + num_verts_d1, key.begin(), key.end());
-    entity_to_index.insert({key, e});
-  }
+  // Sorted vertices of each d1 entity (the keys)
+  Eigen::Array<std::int32_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+      keys(num_entities_d1, num_verts_d1);
+  common::parallel_for(
+      num_entities_d1, num_threads,
+      [&](int, std::int32_t e0, std::int32_t e1) {
+        for (std::int32_t e = e0; e < e1; ++e)
+        {
+          const std::int32_t* v = c_d1_0.links_ptr(e);
+          std::int32_t* key = keys.row(e).data();
+          std::copy_n(v, num_verts_d1, key);
+          std::sort(key, key + num_verts_d1);
+        }
+      });
 
+  // Sort the keys, and store the keys in sorted order with the d1 index
+  const std::vector<std::int32_t> perm = common::sort_rows_by_perm(
+      keys.data(), num_entities_d1, num_verts_d1, num_threads);
   Eigen::Array<std::int32_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
-      connections(c_d0_0.num_nodes(),
-                  mesh::cell_num_entities(cell_type_d0, d1));
+      sorted_keys(num_entities_d1, num_verts_d1);
+  for (std::int32_t i = 0; i < num_entities_d1; ++i)
+    sorted_keys.row(i) = keys.row(perm[i]);
 
-  // Search for d1 entities of d0 in map, and recover index
-  std::vector<std::int32_t> entities;
+  // Search for the d1 entities of each d0 entity
   const Eigen::Array<int, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
       e_vertices_ref = mesh::get_entity_vertices(cell_type_d0, d1);
-  Eigen::Array<int, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> keys
-      = e_vertices_ref;
-  for (int e = 0; e < c_d0_0.num_nodes(); ++e)
-  {
-    entities.clear();
-    auto e0 = c_d0_0.links(e);
-    for (Eigen::Index i = 0; i < e_vertices_ref.rows(); ++i)
-      for (Eigen::Index j = 0; j < e_vertices_ref.cols(); ++j)
-        keys(i, j) = e0[e_vertices_ref(i, j)];
-    for (Eigen::Index i = 0; i < keys.rows(); ++i)
-    {
-      std::partial_sort_copy(keys.row(i).data(),
-                             keys.row(i).data() + keys.row(i).cols(),
-                             key.begin(), key.end());
-      const auto it = entity_to_index.find(key);
-      assert(it != entity_to_index.end());
-      entities.push_back(it->second);
-    }
-    for (std::size_t k = 0; k < entities.size(); ++k)
-      connections(e, k) = entities[k];
-  }
+  const int num_entities_per_d0 = e_vertices_ref.rows();
+  Eigen::Array<std::int32_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+      connections(c_d0_0.num_nodes(), num_entities_per_d0);
+  common::parallel_for(
+      c_d0_0.num_nodes(), num_threads,
+      [&](int, std::int32_t e0_0, std::int32_t e0_1) {
+        std::array<std::int32_t, 4> key;
+        assert(num_verts_d1 <= (int)key.size());
+        for (std::int32_t e = e0_0; e < e0_1; ++e)
+        {
+          const std::int32_t* v = c_d0_0.links_ptr(e);
+          for (int i = 0; i < num_entities_per_d0; ++i)
+          {
+            for (int j = 0; j < num_verts_d1; ++j)
+              key[j] = v[e_vertices_ref(i, j)];
+            std::sort(key.begin(), key.begin() + num_verts_d1);
+
+            // Find the sorted position of the key
+            std::int32_t lo = 0, hi = num_entities_d1;
+            while (lo < hi)
+            {
+              const std::int32_t mid = lo + (hi - lo) / 2;
+              const std::int32_t* row = sorted_keys.row(mid).data();
+              if (std::lexicographical_compare(row, row + num_verts_d1,
+                                               key.begin(),
+                                               key.begin() + num_verts_d1))
+              {
+                lo = mid + 1;
+              }
+              else
+                hi = mid;
+            }
+            assert(lo < num_entities_d1);
+            assert(std::equal(key.begin(), key.begin() + num_verts_d1,
+                              sorted_keys.row(lo).data()));
+            connections(e, i) = perm[lo];
+          }
+        }
+      });
 
   return graph::AdjacencyList<std::int32_t>(connections);
 }
@@ -634,7 +701,7 @@ std::tuple<std::shared_ptr<graph::AdjacencyList<std::int32_t>>,
            std::shared_ptr<graph::AdjacencyList<std::int32_t>>,
            std::shared_ptr<common::IndexMap>>
 TopologyComputation::compute_entities(MPI_Comm comm, const Topology& topology,
-                                      int dim)
+                                      int dim, int num_threads)
 {
   LOG(INFO) << "Computing mesh entities of dimension " << dim;
   const int tdim = topology.dim();
@@ -669,14 +736,15 @@ TopologyComputation::compute_entities(MPI_Comm comm, const Topology& topology,
              std::shared_ptr<graph::AdjacencyList<std::int32_t>>,
              std::shared_ptr<common::IndexMap>>
       data = compute_entities_by_key_matching(
-          comm, *cells, vertex_map, cell_map, topology.cell_type(), dim);
+          comm, *cells, vertex_map, cell_map, topology.cell_type(), dim,
+          num_threads);
 
   return data;
 }
 //-----------------------------------------------------------------------------
 std::array<std::shared_ptr<graph::AdjacencyList<std::int32_t>>, 2>
 TopologyComputation::compute_connectivity(const Topology& topology, int d0,
-                                          int d1)
+                                          int d1, int num_threads)
 {
   LOG(INFO) << "Requesting connectivity " << d0 << " - " << d1;
 
@@ -720,9 +788,10 @@ TopologyComputation::compute_connectivity(const Topology& topology, int d0,
       auto c_d1_d0 = std::make_shared<graph::AdjacencyList<std::int32_t>>(
           compute_from_map(*c_d1_0, *c_d0_0,
                            mesh::cell_entity_type(topology.cell_type(), d1), d1,
-                           d0));
+                           d0, num_threads));
       auto c_d0_d1 = std::make_shared<graph::AdjacencyList<std::int32_t>>(
-          compute_from_transpose(*c_d1_d0, c_d0_0->num_nodes(), d0, d1));
+          compute_from_transpose(*c_d1_d0, c_d0_0->num_nodes(), d0, d1,
+                                 num_threads));
       return {c_d0_d1, c_d1_d0};
     }
     else
@@ -731,7 +800,7 @@ TopologyComputation::compute_connectivity(const Topology& topology, int d0,
       assert(topology.connectivity(d1, d0));
       auto c_d0_d1 = std::make_shared<graph::AdjacencyList<std::int32_t>>(
           compute_from_transpose(*topology.connectivity(d1, d0),
-                                 c_d0_0->num_nodes(), d0, d1));
+                                 c_d0_0->num_nodes(), d0, d1, num_threads));
       return {c_d0_d1, nullptr};
     }
   }
@@ -742,7 +811,7 @@ TopologyComputation::compute_connectivity(const Topology& topology, int d0,
     auto c_d0_d1
         = std::make_shared<graph::AdjacencyList<std::int32_t>>(compute_from_map(
             *c_d0_0, *c_d1_0, mesh::cell_entity_type(topology.cell_type(), d0),
-            d0, d1));
+            d0, d1, num_threads));
     return {c_d0_d1, nullptr};
   }
   else
@@ -98,6 +98,65 @@ void test_scatter_rev()
   sum = std::accumulate(data_local.begin(), data_local.end(), 0);
   CHECK(sum == 2 * n * value * num_ghosts);
 }
+
+void test_scatter_begin_end()
+{
+  // Block size
+  auto n = GENERATE(1, 5);
+
+  const int mpi_size = dolfinx::MPI::size(MPI_COMM_WORLD);
+  const int mpi_rank = dolfinx::MPI::rank(MPI_COMM_WORLD);
+  const int size_local = 100;
+
+  // Create some ghost entries on next process
+  const int num_ghosts = (mpi_size - 1) * 3;
+  Eigen::Array<std::int64_t, Eigen::Dynamic, 1> ghosts(num_ghosts);
+  for (int i = 0; i < num_ghosts; ++i)
+    ghosts[i] = (mpi_rank + 1) % mpi_size * size_local + i;
+
+  std::vector<int> global_ghost_owner(ghosts.size(), (mpi_rank + 1) % mpi_size);
+
+  // Create an IndexMap
+  common::IndexMap idx_map(
+      MPI_COMM_WORLD, size_local,
+      dolfinx::MPI::compute_graph_edges(
+          MPI_COMM_WORLD,
+          std::set<int>(global_ghost_owner.begin(), global_ghost_owner.end())),
+      ghosts, global_ghost_owner, 1);
+
+  // Scatter owned values to ghosts, re-using buffers
+  std::vector<double> send_buffer, recv_buffer;
+  MPI_Request request;
+  std::vector<double> data_local(n * size_local);
+  std::iota(data_local.begin(), data_local.end(), n * size_local * mpi_rank);
+  std::vector<double> data_ghost;
+  for (int k = 0; k < 2; ++k)
+  {
+    idx_map.scatter_fwd_begin(data_local, n, send_buffer, recv_buffer,
+                              request);
+    idx_map.scatter_fwd_end(data_ghost, n, recv_buffer, request);
+    CHECK(data_ghost.size() == n * num_ghosts);
+    for (int i = 0; i < num_ghosts; ++i)
+      for (int j = 0; j < n; ++j)
+        CHECK(data_ghost[i * n + j] == n * ghosts[i] + j);
+  }
+
+  // Send ghost values back to the owner. Each owned index is a ghost
+  // on at most one other process.
+  std::fill(data_local.begin(), data_local.end(), 0);
+  idx_map.scatter_rev_begin(data_ghost, n, send_buffer, recv_buffer, request);
+  idx_map.scatter_rev_end(data_local, n, recv_buffer,
+                          common::IndexMap::Mode::add, request);
+  for (int i = 0; i < size_local; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      const double value
+          = i < num_ghosts ? n * (size_local * mpi_rank + i) + j : 0;
+      CHECK(data_local[i * n + j] == value);
+    }
+  }
+}
 } // namespace
 
 TEST_CASE("Scatter forward using IndexMap", "[index_map_scatter_fwd]")
@@ -109,3 +168,8 @@ TEST_CASE("Scatter reverse using IndexMap", "[index_map_scatter_rev]")
 {
   CHECK_NOTHROW(test_scatter_rev());
 }
+
+TEST_CASE("Non-blocking scatter using IndexMap", "[index_map_scatter_begin]")
+{
+  CHECK_NOTHROW(test_scatter_begin_end());
+}
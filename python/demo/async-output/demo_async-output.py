@@ -0,0 +1,66 @@
+#
+# .. _demo_async_output:
+#
+# Asynchronous output of time series
+# ==================================
+#
+# This demo is implemented in a single Python file,
+# :download:`demo_async-output.py`.
+#
+# This demo illustrates how to:
+#
+# * Write a time series of a function to an XDMF file
+# * Write the function data on a background thread
+# * Time the output loop using :py:class:`Timer <dolfinx.common.Timer>`
+#
+# With ``asynchronous=True``, :py:meth:`write_function
+# <dolfinx.io.XDMFFile.write_function>` copies the function data and
+# returns, and the data is written while the next step is computed.
+# Asynchronous output requires a thread-safe HDF5 library and, in
+# parallel, MPI with ``MPI_THREAD_MULTIPLE`` support. Otherwise the data
+# is written synchronously, which is reported by the ``asynchronous``
+# property of the file.
+#
+# Implementation
+# --------------
+#
+# First, the modules are imported: ::
+
+import numpy as np
+from mpi4py import MPI
+
+from dolfinx import Function, FunctionSpace, UnitCubeMesh
+from dolfinx.common import Timer
+from dolfinx.io import XDMFFile
+
+# A function on a quadratic Lagrange space is created. Each step of the
+# time loop interpolates a time-dependent expression, which models the
+# computation of a step: ::
+
+mesh = UnitCubeMesh(MPI.COMM_WORLD, 24, 24, 24)
+V = FunctionSpace(mesh, ("Lagrange", 2))
+u = Function(V)
+
+
+def f(t):
+    return lambda x: np.sin(t + x[0]) * np.cos(x[1] * x[2])
+
+
+# The time series is written with synchronous and with asynchronous
+# output, and the wall time of each loop is printed. Closing the file,
+# at the end of the ``with`` block, waits for pending writes, so it is
+# included in the time: ::
+
+num_steps = 10
+for asynchronous in (False, True):
+    with Timer() as t:
+        with XDMFFile(mesh.mpi_comm(), "u_async_{}.xdmf".format(asynchronous), "w",
+                      asynchronous=asynchronous) as file:
+            used = file.asynchronous
+            file.write_mesh(mesh)
+            for step in range(num_steps):
+                u.interpolate(f(0.1 * step))
+                file.write_function(u, 0.1 * step)
+    elapsed = mesh.mpi_comm().allreduce(t.elapsed()[0], op=MPI.MAX)
+    if mesh.mpi_comm().rank == 0:
+        print("Asynchronous requested: {}, used: {}, time: {:.3f} s".format(asynchronous, used, elapsed))
@@ -0,0 +1,60 @@
+#
+# .. _demo_threaded_assembly:
+#
+# Thread-parallel matrix assembly
+# ===============================
+#
+# This demo is implemented in a single Python file,
+# :download:`demo_threaded-assembly.py`.
+#
+# This demo illustrates how to:
+#
+# * Assemble a matrix using several threads per process
+# * Time assembly using :py:class:`Timer <dolfinx.common.Timer>`
+#
+# The bilinear form has cell, exterior facet and interior facet
+# integrals, and is assembled into a PETSc matrix with an increasing
+# number of threads. With more than one thread, the element kernels
+# are executed concurrently and insertion into the PETSc matrix is
+# serialised.
+#
+# Implementation
+# --------------
+#
+# First, the modules are imported: ::
+
+from mpi4py import MPI
+
+import dolfinx
+import ufl
+from dolfinx import Function, FunctionSpace, UnitCubeMesh
+from dolfinx.common import Timer
+from ufl import avg, dS, ds, dx, grad, inner
+
+# A mesh of the unit cube and a quadratic Lagrange space are created.
+# The form has a variable coefficient so that the element kernels have
+# a non-trivial cost: ::
+
+mesh = UnitCubeMesh(MPI.COMM_WORLD, 12, 12, 12,
+                    ghost_mode=dolfinx.cpp.mesh.GhostMode.shared_facet)
+V = FunctionSpace(mesh, ("Lagrange", 2))
+u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+k = Function(V)
+k.interpolate(lambda x: 1.0 + x[0] * x[1])
+a = k * inner(grad(u), grad(v)) * dx + k * inner(u, v) * ds + inner(avg(u), avg(v)) * dS
+a = dolfinx.fem.Form(a)._cpp_object
+
+# The matrix is assembled once with each number of threads, and the
+# wall time and the matrix norm are printed. The norms agree up to
+# round-off: ::
+
+A = dolfinx.cpp.fem.create_matrix(a)
+for num_threads in [1, 2, 4]:
+    A.zeroEntries()
+    with Timer() as t:
+        dolfinx.cpp.fem.assemble_matrix_petsc(A, a, [], num_threads)
+        A.assemble()
+    elapsed = mesh.mpi_comm().allreduce(t.elapsed()[0], op=MPI.MAX)
+    norm = A.norm()
+    if mesh.mpi_comm().rank == 0:
+        print("Threads: {}, time: {:.3f} s, norm: {:.12e}".format(num_threads, elapsed, norm))
@@ -0,0 +1,48 @@
+#
+# .. _demo_topology_computation:
+#
+# Mesh entity computation
+# =======================
+#
+# This demo is implemented in a single Python file,
+# :download:`demo_topology-computation.py`.
+#
+# This demo illustrates how to:
+#
+# * Compute the edges and facets of a mesh using several threads
+# * Time the computation using :py:class:`Timer <dolfinx.common.Timer>`
+#
+# The edges and facets of a mesh are numbered by sorting the vertex
+# lists of the entities of all cells, and removing duplicates. The
+# entities of a tetrahedral mesh are computed with an increasing number
+# of threads.
+#
+# Implementation
+# --------------
+#
+# First, the modules are imported: ::
+
+import numpy as np
+from mpi4py import MPI
+
+from dolfinx import BoxMesh
+from dolfinx.common import Timer
+from dolfinx.cpp.mesh import CellType
+
+# A new mesh is created for each number of threads, as the entities of
+# a mesh are computed only once. The wall time and the number of
+# entities are printed. The number of entities does not depend on the
+# number of threads: ::
+
+n = 32
+for num_threads in [1, 2, 4]:
+    mesh = BoxMesh(MPI.COMM_WORLD, [np.array([0.0, 0.0, 0.0]), np.array([1.0, 1.0, 1.0])],
+                   [n, n, n], CellType.tetrahedron)
+    for dim in [1, 2]:
+        with Timer() as t:
+            mesh.topology.create_entities(dim, num_threads)
+        elapsed = mesh.mpi_comm().allreduce(t.elapsed()[0], op=MPI.MAX)
+        num_entities = mesh.topology.index_map(dim).size_global
+        if mesh.mpi_comm().rank == 0:
+            print("Threads: {}, dim: {}, entities: {}, time: {:.3f} s".format(
+                num_threads, dim, num_entities, elapsed))
@@ -8,7 +8,7 @@ import functools
 
 from dolfinx import cpp
 from dolfinx.cpp.common import (git_commit_hash, has_debug, has_kahip,  # noqa
-                                has_parmetis, has_petsc_complex)
+                                has_parmetis, has_petsc_complex, has_zlib)
 
 TimingType = cpp.common.TimingType
 
@@ -128,6 +128,20 @@ class Function(ufl.Coefficient):
             u = np.reshape(u, (-1, ))
         return u
 
+    def eval_points(self, plan, u=None) -> np.ndarray:
+        """Evaluate Function at points that may be located on any process,
+        where plan is a dolfinx.geometry.PointOwnership for the points. The
+        values have shape (num_points, value_size) and are zero for points
+        that are not located on any process. This is collective."""
+        if u is None:
+            value_size = ufl.product(self.ufl_element().value_shape())
+            if common.has_petsc_complex:
+                u = np.empty((plan.num_points, value_size), dtype=np.complex128)
+            else:
+                u = np.empty((plan.num_points, value_size))
+        self._cpp_object.eval(plan._cpp_object, u)
+        return u
+
     def interpolate(self, u) -> None:
         """Interpolate an expression"""
         @singledispatch
@@ -375,6 +389,52 @@ class FunctionSpace(ufl.FunctionSpace):
         return self._cpp_object.tabulate_dof_coordinates()
 
 
+class ExpressionInterpolation:
+    def __init__(self, V: FunctionSpace):
+        """Create an operator that interpolates expressions into V. The
+        interpolation points are computed once, so that repeated
+        interpolation, e.g. of time-dependent data, only evaluates the
+        expression."""
+        self._cpp_object = cpp.function.ExpressionInterpolation(V._cpp_object)
+
+    def interpolate(self, u: Function, f) -> None:
+        """Interpolate the expression f into u, where f is a Python callable
+        or a pointer to a compiled expression (see Function.interpolate)"""
+        @singledispatch
+        def _interpolate(f):
+            self._cpp_object.interpolate(u._cpp_object, f)
+
+        @_interpolate.register(int)
+        def _(f_ptr):
+            self._cpp_object.interpolate_ptr(u._cpp_object, f_ptr)
+
+        _interpolate(f)
+
+    @property
+    def points(self):
+        """The interpolation points (shape=(3, num_points))"""
+        return self._cpp_object.points
+
+
+class NonMatchingInterpolation:
+    def __init__(self, V: FunctionSpace, W: FunctionSpace, num_threads=1):
+        """Create an operator that interpolates Functions on W into V, where
+        V and W may be defined on different meshes. The interpolation points
+        of V are located in the mesh of W once, so that repeated interpolation
+        is cheap. This is collective."""
+        self._cpp_object = cpp.function.NonMatchingInterpolation(V._cpp_object, W._cpp_object, num_threads)
+
+    def apply(self, v: Function, u: Function) -> None:
+        """Interpolate v (on W) into u (on V). This is collective."""
+        self._cpp_object.apply(v._cpp_object, u._cpp_object)
+
+    @property
+    def num_lost_points(self):
+        """Number of interpolation points of V on this process that are
+        outside the mesh of W"""
+        return self._cpp_object.num_lost_points
+
+
 def VectorFunctionSpace(mesh: cpp.mesh.Mesh,
                         element: ElementMetaData,
                         dim=None,
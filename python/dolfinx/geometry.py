@@ -8,8 +8,11 @@ from dolfinx import cpp
 
 
 class BoundingBoxTree:
-    def __init__(self, obj, dim=None):
-        self._cpp_object = cpp.geometry.BoundingBoxTree(obj, dim)
+    def __init__(self, obj, dim=None, num_threads=1):
+        if dim is None:
+            self._cpp_object = cpp.geometry.BoundingBoxTree(obj, num_threads)
+        else:
+            self._cpp_object = cpp.geometry.BoundingBoxTree(obj, dim, num_threads)
 
     @classmethod
     def create_midpoint_tree(cls, mesh):
@@ -18,11 +21,44 @@ class BoundingBoxTree:
         tree._cpp_object = cpp.geometry.create_midpoint_tree(mesh)
         return tree
 
+    def refit(self, mesh, num_threads=1):
+        """Update the bounding boxes after the mesh geometry has changed,
+        keeping the tree structure. This is collective."""
+        self._cpp_object.refit(mesh, num_threads)
+
+    def update(self, mesh, max_cost_ratio=1.5, num_threads=1) -> bool:
+        """Refit the tree after the mesh geometry has changed, and rebuild it
+        if its cost has grown by more than max_cost_ratio since it was built.
+        Returns True if the tree was rebuilt. This is collective."""
+        return self._cpp_object.update(mesh, max_cost_ratio, num_threads)
+
+    def cost(self) -> float:
+        """Surface area heuristic cost of the tree"""
+        return self._cpp_object.cost()
+
     def str(self):
         """Print for debugging"""
         return self._cpp_object.str()
 
 
+class PointOwnership:
+    def __init__(self, mesh, tree: BoundingBoxTree, x, num_threads=1):
+        """Compute the process and cell that own each point in the array x
+        (shape=(num_points, 3)), where the points may be located on any
+        process. This is collective."""
+        self._cpp_object = cpp.geometry.PointOwnership(mesh, tree._cpp_object, x, num_threads)
+
+    @property
+    def num_points(self):
+        """Number of points passed to the constructor on this process"""
+        return self._cpp_object.num_points
+
+    @property
+    def num_lost_points(self):
+        """Number of points on this process that are not located on any process"""
+        return self._cpp_object.num_lost_points
+
+
 def compute_closest_entity(tree: BoundingBoxTree, tree_midpoint, mesh, x):
     """Compute closest entity of the mesh to the point"""
     return cpp.geometry.compute_closest_entity(tree._cpp_object, tree_midpoint._cpp_object, mesh, x)
@@ -39,6 +75,26 @@ def compute_colliding_cells(tree: BoundingBoxTree, mesh, x, n=1):
     return cpp.geometry.select_colliding_cells(mesh, candidate_cells, x, n)
 
 
+def compute_collisions_points(tree: BoundingBoxTree, x, num_threads=1):
+    """Compute collisions with each point in the array x (shape=(num_points, 3)).
+    Returns an AdjacencyList with the colliding entities of each point."""
+    return cpp.geometry.compute_collisions_points(tree._cpp_object, x, num_threads)
+
+
+def select_colliding_cells(mesh, candidate_cells, x, num_threads=1):
+    """Select the cells from the candidate cells of each point in the array x
+    (shape=(num_points, 3)) that contain the point. Returns an AdjacencyList
+    with the colliding cells of each point."""
+    return cpp.geometry.select_colliding_cells(mesh, candidate_cells, x, num_threads)
+
+
 def compute_collisions(tree0: BoundingBoxTree, tree1: BoundingBoxTree):
     """Compute collisions with the bounding box"""
     return cpp.geometry.compute_collisions(tree0._cpp_object, tree1._cpp_object)
+
+
+def compute_distances_gjk(mesh0, dim0, mesh1, dim1, pairs, num_threads=1):
+    """Compute the shortest vector between the entities (of dimension dim0 of
+    mesh0 and dimension dim1 of mesh1) in each pair of entity indices, e.g.
+    computed by compute_collisions. Returns an array of shape (num_pairs, 3)."""
+    return cpp.geometry.compute_distances_gjk(mesh0, dim0, mesh1, dim1, pairs, num_threads)
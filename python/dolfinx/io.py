@@ -19,14 +19,19 @@ class VTKFile:
 
     """
 
-    def __init__(self, filename: str):
+    Encoding = cpp.io.VTKFile.Encoding
+
+    def __init__(self, filename: str, encoding=cpp.io.VTKFile.Encoding.ASCII):
         """Open VTK file
         Parameters
         ----------
         filename
             Name of the file
+        encoding
+            ASCII, appended raw binary (RAW) or appended zlib-compressed
+            binary (ZLIB) data
         """
-        self._cpp_object = cpp.io.VTKFile(filename)
+        self._cpp_object = cpp.io.VTKFile(filename, encoding)
 
     def write(self, o, t=None) -> None:
         """Write object to file"""
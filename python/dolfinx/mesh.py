@@ -96,14 +96,15 @@ def refine(mesh, cell_markers=None, redistribute=True):
     return mesh_refined
 
 
-def create_mesh(comm, cells, x, domain, ghost_mode=cpp.mesh.GhostMode.shared_facet):
-    """Create a mesh from topology and geometry data"""
+def create_mesh(comm, cells, x, domain, ghost_mode=cpp.mesh.GhostMode.shared_facet, reorder=False):
+    """Create a mesh from topology and geometry data. If reorder is
+    True, the cells on each process are reordered for data locality."""
     cmap = fem.create_coordinate_map(domain)
     try:
-        mesh = cpp.mesh.create_mesh(comm, cells, cmap, x, ghost_mode)
+        mesh = cpp.mesh.create_mesh(comm, cells, cmap, x, ghost_mode, reorder)
     except TypeError:
         mesh = cpp.mesh.create_mesh(comm, cpp.graph.AdjacencyList_int64(numpy.cast['int64'](cells)),
-                                    cmap, x, ghost_mode)
+                                    cmap, x, ghost_mode, reorder)
 
     # Attach UFL data (used when passing a mesh into UFL functions)
     domain._ufl_cargo = mesh
@@ -35,6 +35,7 @@ void common(py::module& m)
   m.attr("has_kahip") = dolfinx::has_kahip();
   m.attr("has_petsc_complex") = dolfinx::has_petsc_complex();
   m.attr("has_slepc") = dolfinx::has_slepc();
+  m.attr("has_zlib") = dolfinx::has_zlib();
 #ifdef HAS_PYBIND11_SLEPC4PY
   m.attr("has_slepc4py") = true;
 #else
@@ -9,6 +9,7 @@
 #include <Eigen/Dense>
 #include <dolfinx/common/IndexMap.h>
 #include <dolfinx/common/types.h>
+#include <dolfinx/fem/AssemblyPlan.h>
 #include <dolfinx/fem/CoordinateElement.h>
 #include <dolfinx/fem/DirichletBC.h>
 #include <dolfinx/fem/DiscreteOperators.h>
@@ -23,6 +24,7 @@
 #include <dolfinx/function/Constant.h>
 #include <dolfinx/function/Function.h>
 #include <dolfinx/function/FunctionSpace.h>
+#include <dolfinx/la/MatrixCSR.h>
 #include <dolfinx/la/PETScMatrix.h>
 #include <dolfinx/la/PETScVector.h>
 #include <dolfinx/la/SparsityPattern.h>
@@ -100,7 +102,9 @@ void fem(py::module& m)
   m.def("create_sparsity_pattern",
         &dolfinx::fem::create_sparsity_pattern<PetscScalar>,
         "Create a sparsity pattern for bilinear form.");
-  m.def("pack_coefficients", &dolfinx::fem::pack_coefficients<PetscScalar>,
+  m.def("pack_coefficients",
+        py::overload_cast<const dolfinx::fem::Form<PetscScalar>&>(
+            &dolfinx::fem::pack_coefficients<PetscScalar>),
         "Pack coefficients for a UFL form.");
   m.def("pack_constants", &dolfinx::fem::pack_constants<PetscScalar>,
         "Pack constants for a UFL form.");
@@ -114,6 +118,20 @@ void fem(py::module& m)
       },
       py::return_value_policy::take_ownership,
       "Create a PETSc Mat for bilinear form.");
+  m.def(
+      "create_matrix_free",
+      [](std::shared_ptr<const dolfinx::fem::Form<PetscScalar>> a,
+         const std::vector<std::shared_ptr<
+             const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs,
+         PetscScalar diagonal) {
+        auto A = dolfinx::fem::create_matrix_free(a, bcs, diagonal);
+        Mat _A = A.mat();
+        PetscObjectReference((PetscObject)_A);
+        return _A;
+      },
+      py::return_value_policy::take_ownership, py::arg("a"), py::arg("bcs"),
+      py::arg("diagonal") = 1.0,
+      "Create a matrix-free PETSc Mat (MATSHELL) for bilinear form.");
   m.def(
       "create_matrix_block",
       [](const std::vector<std::vector<const dolfinx::fem::Form<PetscScalar>*>>&
@@ -270,25 +288,48 @@ void fem(py::module& m)
   // dolfinx::fem::assemble
   // Functional
   m.def("assemble_scalar", &dolfinx::fem::assemble_scalar<PetscScalar>,
+        py::arg("M"), py::arg("num_threads") = 1,
         "Assemble functional over mesh");
   // Vector
   m.def("assemble_vector", &dolfinx::fem::assemble_vector<PetscScalar>,
-        py::arg("b"), py::arg("L"),
+        py::arg("b"), py::arg("L"), py::arg("num_threads") = 1,
         "Assemble linear form into an existing Eigen vector");
   // Matrices
-  m.def("assemble_matrix_petsc",
-        [](Mat A, const dolfinx::fem::Form<PetscScalar>& a,
-           const std::vector<std::shared_ptr<
-               const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs) {
-          dolfinx::fem::assemble_matrix(dolfinx::la::PETScMatrix::add_fn(A), a,
-                                        bcs);
-        });
+  m.def(
+      "assemble_matrix_petsc",
+      [](Mat A, const dolfinx::fem::Form<PetscScalar>& a,
+         const std::vector<std::shared_ptr<
+             const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs,
+         int num_threads) {
+        dolfinx::fem::assemble_matrix(dolfinx::la::PETScMatrix::add_fn(A), a,
+                                      bcs, num_threads);
+      },
+      py::arg("A"), py::arg("a"), py::arg("bcs"), py::arg("num_threads") = 1);
   m.def("assemble_matrix_petsc",
         [](Mat A, const dolfinx::fem::Form<PetscScalar>& a,
            const std::vector<bool>& rows0, const std::vector<bool>& rows1) {
           dolfinx::fem::assemble_matrix(dolfinx::la::PETScMatrix::add_fn(A), a,
                                         rows0, rows1);
         });
+  m.def(
+      "assemble_matrix_petsc",
+      [](Mat A, const dolfinx::fem::AssemblyPlan<PetscScalar>& plan,
+         const std::vector<std::shared_ptr<
+             const dolfinx::fem::DirichletBC<PetscScalar>>>& bcs,
+         int num_threads) {
+        dolfinx::fem::assemble_matrix(dolfinx::la::PETScMatrix::add_fn(A),
+                                      plan, bcs, num_threads);
+      },
+      py::arg("A"), py::arg("plan"), py::arg("bcs"),
+      py::arg("num_threads") = 1);
+  m.def("assemble_matrix_csr",
+        py::overload_cast<dolfinx::la::MatrixCSR<PetscScalar>&,
+                          const dolfinx::fem::AssemblyPlan<PetscScalar>&,
+                          const std::vector<std::shared_ptr<
+                              const dolfinx::fem::DirichletBC<PetscScalar>>>&,
+                          int>(&dolfinx::fem::assemble_matrix<PetscScalar>),
+        py::arg("A"), py::arg("plan"), py::arg("bcs"),
+        py::arg("num_threads") = 1);
   m.def("add_diagonal",
         [](Mat A, const dolfinx::function::FunctionSpace& V,
            const std::vector<std::shared_ptr<
@@ -303,8 +344,10 @@ void fem(py::module& m)
                               const std::int32_t*, const PetscScalar*)>&,
                           const dolfinx::fem::Form<PetscScalar>&,
                           const std::vector<std::shared_ptr<
-                              const dolfinx::fem::DirichletBC<PetscScalar>>>&>(
-            &dolfinx::fem::assemble_matrix<PetscScalar>));
+                              const dolfinx::fem::DirichletBC<PetscScalar>>>&,
+                          int>(&dolfinx::fem::assemble_matrix<PetscScalar>),
+        py::arg("mat_add"), py::arg("a"), py::arg("bcs"),
+        py::arg("num_threads") = 1);
 
   // BC modifiers
   m.def("apply_lifting", &dolfinx::fem::apply_lifting<PetscScalar>,
@@ -377,6 +420,23 @@ void fem(py::module& m)
       .value("interior_facet", dolfinx::fem::IntegralType::interior_facet);
 
   // dolfinx::fem::Form
+  // dolfinx::fem::AssemblyPlan
+  py::class_<dolfinx::fem::AssemblyPlan<PetscScalar>,
+             std::shared_ptr<dolfinx::fem::AssemblyPlan<PetscScalar>>>(
+      m, "AssemblyPlan", "Precomputed data for repeated assembly of a form")
+      .def(py::init<std::shared_ptr<const dolfinx::fem::Form<PetscScalar>>>())
+      .def(py::init<std::shared_ptr<const dolfinx::fem::Form<PetscScalar>>,
+                    const dolfinx::la::MatrixCSR<PetscScalar>&>())
+      .def("update_coefficients",
+           &dolfinx::fem::AssemblyPlan<PetscScalar>::update_coefficients,
+           py::arg("num_threads") = 1)
+      .def("update_changed_coefficients",
+           &dolfinx::fem::AssemblyPlan<
+               PetscScalar>::update_changed_coefficients,
+           py::arg("num_threads") = 1)
+      .def("create_colorings",
+           &dolfinx::fem::AssemblyPlan<PetscScalar>::create_colorings);
+
   py::class_<dolfinx::fem::Form<PetscScalar>,
              std::shared_ptr<dolfinx::fem::Form<PetscScalar>>>(
       m, "Form", "Variational form object")
@@ -423,6 +483,17 @@ void fem(py::module& m)
                  const std::uint32_t))addr.cast<std::uintptr_t>();
              self.set_tabulate_tensor(type, i, tabulate_tensor_ptr);
            })
+      .def("set_tabulate_tensor_batch",
+           [](dolfinx::fem::Form<PetscScalar>& self,
+              dolfinx::fem::IntegralType type, int i, py::object addr,
+              int batch_size) {
+             auto tabulate_tensor_ptr = (void (*)(
+                 PetscScalar*, const PetscScalar*, const PetscScalar*,
+                 const double*, const int*, const std::uint8_t*,
+                 const std::uint32_t*))addr.cast<std::uintptr_t>();
+             self.set_tabulate_tensor_batch(type, i, tabulate_tensor_ptr,
+                                            batch_size);
+           })
       .def_property_readonly("rank", &dolfinx::fem::Form<PetscScalar>::rank)
       .def_property_readonly("mesh", &dolfinx::fem::Form<PetscScalar>::mesh)
       .def_property_readonly("function_spaces",
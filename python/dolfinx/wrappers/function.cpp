@@ -9,10 +9,13 @@
 #include <dolfinx/fem/DofMap.h>
 #include <dolfinx/fem/FiniteElement.h>
 #include <dolfinx/function/Constant.h>
+#include <dolfinx/function/ExpressionInterpolation.h>
 #include <dolfinx/function/Function.h>
 #include <dolfinx/function/FunctionSpace.h>
+#include <dolfinx/function/NonMatchingInterpolation.h>
 #include <dolfinx/function/interpolate.h>
 #include <dolfinx/geometry/BoundingBoxTree.h>
+#include <dolfinx/geometry/PointOwnership.h>
 #include <dolfinx/la/PETScVector.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <memory>
@@ -84,9 +87,24 @@ void function(py::module& m)
           "x",
           py::overload_cast<>(&dolfinx::function::Function<PetscScalar>::x),
           "Return the vector associated with the finite element Function")
-      .def("eval", &dolfinx::function::Function<PetscScalar>::eval,
+      .def("eval",
+           py::overload_cast<
+               const Eigen::Ref<const Eigen::Array<double, Eigen::Dynamic, 3,
+                                                   Eigen::RowMajor>>&,
+               const Eigen::Ref<const Eigen::Array<int, Eigen::Dynamic, 1>>&,
+               Eigen::Ref<Eigen::Array<PetscScalar, Eigen::Dynamic,
+                                       Eigen::Dynamic, Eigen::RowMajor>>>(
+               &dolfinx::function::Function<PetscScalar>::eval, py::const_),
            py::arg("x"), py::arg("cells"), py::arg("values"),
            "Evaluate Function")
+      .def("eval",
+           py::overload_cast<const dolfinx::geometry::PointOwnership&,
+                             Eigen::Ref<Eigen::Array<
+                                 PetscScalar, Eigen::Dynamic, Eigen::Dynamic,
+                                 Eigen::RowMajor>>>(
+               &dolfinx::function::Function<PetscScalar>::eval, py::const_),
+           py::arg("plan"), py::arg("values"),
+           "Evaluate Function at points located on any process")
       .def("compute_point_values",
            &dolfinx::function::Function<PetscScalar>::compute_point_values,
            "Compute values at all mesh points")
@@ -129,5 +147,61 @@ void function(py::module& m)
             return py::array(self.shape, self.value.data(), py::none());
           },
           py::return_value_policy::reference_internal);
+
+  // dolfinx::function::ExpressionInterpolation
+  py::class_<dolfinx::function::ExpressionInterpolation<PetscScalar>,
+             std::shared_ptr<
+                 dolfinx::function::ExpressionInterpolation<PetscScalar>>>(
+      m, "ExpressionInterpolation",
+      "Interpolation of expressions at precomputed points")
+      .def(py::init<std::shared_ptr<const dolfinx::function::FunctionSpace>>(),
+           py::arg("V"))
+      .def("interpolate",
+           &dolfinx::function::ExpressionInterpolation<
+               PetscScalar>::interpolate,
+           py::arg("u"), py::arg("f"), "Interpolate an expression")
+      .def(
+          "interpolate_ptr",
+          [](const dolfinx::function::ExpressionInterpolation<PetscScalar>&
+                 self,
+             dolfinx::function::Function<PetscScalar>& u,
+             std::uintptr_t addr) {
+            const std::function<void(PetscScalar*, int, int, const double*)> f
+                = reinterpret_cast<void (*)(PetscScalar*, int, int,
+                                            const double*)>(addr);
+            auto _f
+                = [&f](Eigen::Ref<Eigen::Array<PetscScalar, Eigen::Dynamic,
+                                               Eigen::Dynamic, Eigen::RowMajor>>
+                           values,
+                       const Eigen::Ref<const Eigen::Array<
+                           double, Eigen::Dynamic, 3, Eigen::RowMajor>>& x) {
+                    f(values.data(), values.rows(), values.cols(), x.data());
+                  };
+            self.interpolate_c(u, _f);
+          },
+          py::arg("u"), py::arg("addr"),
+          "Interpolate using a pointer to an expression with a C signature")
+      .def_property_readonly(
+          "points",
+          &dolfinx::function::ExpressionInterpolation<PetscScalar>::points,
+          py::return_value_policy::reference_internal);
+
+  // dolfinx::function::NonMatchingInterpolation
+  py::class_<dolfinx::function::NonMatchingInterpolation<PetscScalar>,
+             std::shared_ptr<
+                 dolfinx::function::NonMatchingInterpolation<PetscScalar>>>(
+      m, "NonMatchingInterpolation",
+      "Interpolation between function spaces on non-matching meshes")
+      .def(py::init<std::shared_ptr<const dolfinx::function::FunctionSpace>,
+                    std::shared_ptr<const dolfinx::function::FunctionSpace>,
+                    int>(),
+           py::arg("V"), py::arg("W"), py::arg("num_threads") = 1)
+      .def("apply",
+           &dolfinx::function::NonMatchingInterpolation<PetscScalar>::apply,
+           py::arg("v"), py::arg("u"))
+      .def_property_readonly(
+          "num_lost_points",
+          &dolfinx::function::NonMatchingInterpolation<
+              PetscScalar>::num_lost_points);
 }
 } // namespace dolfinx_wrappers
@@ -7,6 +7,7 @@
 #include <Eigen/Dense>
 #include <dolfinx/geometry/BoundingBoxTree.h>
 #include <dolfinx/geometry/GJK.h>
+#include <dolfinx/geometry/PointOwnership.h>
 #include <dolfinx/geometry/utils.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <memory>
@@ -51,16 +52,69 @@ void geometry(py::module& m)
         py::overload_cast<const dolfinx::geometry::BoundingBoxTree&,
                           const dolfinx::geometry::BoundingBoxTree&>(
             &dolfinx::geometry::compute_collisions));
+  m.def("compute_collisions_points",
+        py::overload_cast<
+            const dolfinx::geometry::BoundingBoxTree&,
+            const Eigen::Ref<const Eigen::Array<double, Eigen::Dynamic, 3,
+                                                Eigen::RowMajor>>&,
+            int>(&dolfinx::geometry::compute_collisions),
+        py::arg("tree"), py::arg("points"), py::arg("num_threads") = 1);
 
   m.def("compute_distance_gjk", &dolfinx::geometry::compute_distance_gjk);
+  m.def("compute_distances_gjk", &dolfinx::geometry::compute_distances_gjk,
+        py::arg("mesh0"), py::arg("dim0"), py::arg("mesh1"), py::arg("dim1"),
+        py::arg("pairs"), py::arg("num_threads") = 1);
   m.def("squared_distance", &dolfinx::geometry::squared_distance);
-  m.def("select_colliding_cells", &dolfinx::geometry::select_colliding_cells);
+  m.def("select_colliding_cells",
+        py::overload_cast<const dolfinx::mesh::Mesh&, const std::vector<int>&,
+                          const Eigen::Vector3d&, int>(
+            &dolfinx::geometry::select_colliding_cells));
+  m.def("select_colliding_cells",
+        py::overload_cast<
+            const dolfinx::mesh::Mesh&,
+            const dolfinx::graph::AdjacencyList<std::int32_t>&,
+            const Eigen::Ref<const Eigen::Array<double, Eigen::Dynamic, 3,
+                                                Eigen::RowMajor>>&,
+            int>(&dolfinx::geometry::select_colliding_cells),
+        py::arg("mesh"), py::arg("candidate_cells"), py::arg("points"),
+        py::arg("num_threads") = 1);
 
   // dolfinx::geometry::BoundingBoxTree
   py::class_<dolfinx::geometry::BoundingBoxTree,
              std::shared_ptr<dolfinx::geometry::BoundingBoxTree>>(
       m, "BoundingBoxTree")
-      .def(py::init<const dolfinx::mesh::Mesh&, int>())
-      .def(py::init<const std::vector<Eigen::Vector3d>&>());
+      .def(py::init<const dolfinx::mesh::Mesh&, int, int>(), py::arg("mesh"),
+           py::arg("tdim"), py::arg("num_threads") = 1)
+      .def(py::init<const std::vector<Eigen::Vector3d>&, int>(),
+           py::arg("points"), py::arg("num_threads") = 1)
+      .def("refit", &dolfinx::geometry::BoundingBoxTree::refit,
+           py::arg("mesh"), py::arg("num_threads") = 1)
+      .def("update", &dolfinx::geometry::BoundingBoxTree::update,
+           py::arg("mesh"), py::arg("max_cost_ratio") = 1.5,
+           py::arg("num_threads") = 1)
+      .def("cost", &dolfinx::geometry::BoundingBoxTree::cost);
+
+  // dolfinx::geometry::PointOwnership
+  py::class_<dolfinx::geometry::PointOwnership,
+             std::shared_ptr<dolfinx::geometry::PointOwnership>>(
+      m, "PointOwnership")
+      .def(py::init<const dolfinx::mesh::Mesh&,
+                    const dolfinx::geometry::BoundingBoxTree&,
+                    const Eigen::Ref<const Eigen::Array<
+                        double, Eigen::Dynamic, 3, Eigen::RowMajor>>&,
+                    int>(),
+           py::arg("mesh"), py::arg("tree"), py::arg("points"),
+           py::arg("num_threads") = 1)
+      .def_property_readonly("num_points",
+                             &dolfinx::geometry::PointOwnership::num_points)
+      .def_property_readonly(
+          "num_lost_points",
+          &dolfinx::geometry::PointOwnership::num_lost_points)
+      .def_property_readonly("owned_points",
+                             &dolfinx::geometry::PointOwnership::owned_points,
+                             py::return_value_policy::reference_internal)
+      .def_property_readonly("cells",
+                             &dolfinx::geometry::PointOwnership::cells,
+                             py::return_value_policy::reference_internal);
 }
 } // namespace dolfinx_wrappers
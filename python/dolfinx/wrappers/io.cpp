@@ -9,12 +9,14 @@
 #include <dolfinx/function/Function.h>
 #include <dolfinx/function/FunctionSpace.h>
 #include <dolfinx/io/VTKFile.h>
+#include <dolfinx/io/HDF5Interface.h>
 #include <dolfinx/io/XDMFFile.h>
 #include <dolfinx/io/cells.h>
 #include <dolfinx/io/xdmf_utils.h>
 #include <dolfinx/la/PETScVector.h>
 #include <dolfinx/mesh/Mesh.h>
 #include <dolfinx/mesh/MeshTags.h>
+#include <map>
 #include <memory>
 #include <pybind11/eigen.h>
 #include <pybind11/numpy.h>
@@ -48,6 +50,45 @@ void io(py::module& m)
               mesh, entity_dim, entities, vals);
         });
 
+  // dolfinx::io::HDF5Interface::DatasetProperties
+  py::class_<dolfinx::io::HDF5Interface::DatasetProperties> dataset_properties(
+      m, "DatasetProperties");
+
+  py::enum_<dolfinx::io::HDF5Interface::Chunking>(dataset_properties,
+                                                  "Chunking")
+      .value("none", dolfinx::io::HDF5Interface::Chunking::none)
+      .value("automatic", dolfinx::io::HDF5Interface::Chunking::automatic)
+      .value("rows", dolfinx::io::HDF5Interface::Chunking::rows);
+
+  py::enum_<dolfinx::io::HDF5Interface::Filter>(dataset_properties, "Filter")
+      .value("none", dolfinx::io::HDF5Interface::Filter::none)
+      .value("deflate", dolfinx::io::HDF5Interface::Filter::deflate)
+      .value("szip", dolfinx::io::HDF5Interface::Filter::szip)
+      .value("plugin", dolfinx::io::HDF5Interface::Filter::plugin);
+
+  dataset_properties.def(py::init<>())
+      .def_readwrite("chunking",
+                     &dolfinx::io::HDF5Interface::DatasetProperties::chunking)
+      .def_readwrite(
+          "chunk_rows",
+          &dolfinx::io::HDF5Interface::DatasetProperties::chunk_rows)
+      .def_readwrite("filter",
+                     &dolfinx::io::HDF5Interface::DatasetProperties::filter)
+      .def_readwrite("shuffle",
+                     &dolfinx::io::HDF5Interface::DatasetProperties::shuffle)
+      .def_readwrite(
+          "deflate_level",
+          &dolfinx::io::HDF5Interface::DatasetProperties::deflate_level)
+      .def_readwrite("szip_pixels_per_block",
+                     &dolfinx::io::HDF5Interface::DatasetProperties::
+                         szip_pixels_per_block)
+      .def_readwrite(
+          "plugin_id",
+          &dolfinx::io::HDF5Interface::DatasetProperties::plugin_id)
+      .def_readwrite(
+          "plugin_parameters",
+          &dolfinx::io::HDF5Interface::DatasetProperties::plugin_parameters);
+
   // dolfinx::io::XDMFFile
   py::class_<dolfinx::io::XDMFFile, std::shared_ptr<dolfinx::io::XDMFFile>>
       xdmf_file(m, "XDMFFile");
@@ -60,18 +101,25 @@ void io(py::module& m)
   xdmf_file
       .def(py::init([](const MPICommWrapper comm, const std::string filename,
                        const std::string file_mode,
-                       dolfinx::io::XDMFFile::Encoding encoding) {
+                       dolfinx::io::XDMFFile::Encoding encoding,
+                       bool asynchronous,
+                       const std::map<std::string, std::string>& mpi_info) {
              return std::make_unique<dolfinx::io::XDMFFile>(
-                 comm.get(), filename, file_mode, encoding);
+                 comm.get(), filename, file_mode, encoding, asynchronous,
+                 mpi_info);
            }),
            py::arg("comm"), py::arg("filename"), py::arg("file_mode"),
-           py::arg("encoding") = dolfinx::io::XDMFFile::Encoding::HDF5)
+           py::arg("encoding") = dolfinx::io::XDMFFile::Encoding::HDF5,
+           py::arg("asynchronous") = false,
+           py::arg("mpi_info") = std::map<std::string, std::string>())
       .def("__enter__",
            [](std::shared_ptr<dolfinx::io::XDMFFile>& self) { return self; })
       .def("__exit__",
            [](dolfinx::io::XDMFFile& self, py::object exc_type,
               py::object exc_value, py::object traceback) { self.close(); })
       .def("close", &dolfinx::io::XDMFFile::close)
+      .def_property_readonly("asynchronous",
+                             &dolfinx::io::XDMFFile::asynchronous)
       .def("write_mesh", &dolfinx::io::XDMFFile::write_mesh, py::arg("mesh"),
            py::arg("xpath") = "/Xdmf/Domain")
       .def("write_geometry", &dolfinx::io::XDMFFile::write_geometry,
@@ -81,6 +129,8 @@ void io(py::module& m)
            py::arg("name") = "mesh", py::arg("xpath") = "/Xdmf/Domain")
       .def("read_geometry_data", &dolfinx::io::XDMFFile::read_geometry_data,
            py::arg("name") = "mesh", py::arg("xpath") = "/Xdmf/Domain")
+      .def("read_attribute_data", &dolfinx::io::XDMFFile::read_attribute_data,
+           py::arg("name"), py::arg("xpath"))
       .def("read_cell_type", &dolfinx::io::XDMFFile::read_cell_type,
            py::arg("name") = "mesh", py::arg("xpath") = "/Xdmf/Domain")
       .def("write_function", &dolfinx::io::XDMFFile::write_function,
@@ -95,6 +145,10 @@ void io(py::module& m)
            py::arg("name"), py::arg("value"), py::arg("xpath") = "/Xdmf/Domain")
       .def("read_information", &dolfinx::io::XDMFFile::read_information,
            py::arg("name"), py::arg("xpath") = "/Xdmf/Domain")
+      .def("set_dataset_properties",
+           &dolfinx::io::XDMFFile::set_dataset_properties,
+           py::arg("properties"))
+      .def("dataset_properties", &dolfinx::io::XDMFFile::dataset_properties)
       .def("comm", [](dolfinx::io::XDMFFile& self) {
         return MPICommWrapper(self.comm());
       });
@@ -103,11 +157,20 @@ void io(py::module& m)
   py::class_<dolfinx::io::VTKFile, std::shared_ptr<dolfinx::io::VTKFile>>
       vtk_file(m, "VTKFile");
 
+  // dolfinx::io::VTKFile::Encoding enums
+  py::enum_<dolfinx::io::VTKFile::Encoding>(vtk_file, "Encoding")
+      .value("ASCII", dolfinx::io::VTKFile::Encoding::ASCII)
+      .value("RAW", dolfinx::io::VTKFile::Encoding::RAW)
+      .value("ZLIB", dolfinx::io::VTKFile::Encoding::ZLIB);
+
   vtk_file
-      .def(py::init([](std::string filename) {
-             return std::make_unique<dolfinx::io::VTKFile>(filename);
+      .def(py::init([](std::string filename,
+                       dolfinx::io::VTKFile::Encoding encoding) {
+             return std::make_unique<dolfinx::io::VTKFile>(filename,
+                                                           encoding);
            }),
-           py::arg("filename"))
+           py::arg("filename"),
+           py::arg("encoding") = dolfinx::io::VTKFile::Encoding::ASCII)
       .def("write",
            py::overload_cast<const dolfinx::function::Function<PetscScalar>&>(
                &dolfinx::io::VTKFile::write),
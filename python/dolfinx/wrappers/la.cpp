@@ -7,6 +7,7 @@
 #include "caster_mpi.h"
 #include "caster_petsc.h"
 #include <dolfinx/common/IndexMap.h>
+#include <dolfinx/la/MatrixCSR.h>
 #include <dolfinx/la/PETScMatrix.h>
 #include <dolfinx/la/PETScVector.h>
 #include <dolfinx/la/SparsityPattern.h>
@@ -61,7 +62,28 @@ void la(py::module& m)
       .def_property_readonly(
           "off_diagonal_pattern",
           &dolfinx::la::SparsityPattern::off_diagonal_pattern,
-          py::return_value_policy::reference_internal);
+          py::return_value_policy::reference_internal)
+      .def_property_readonly("ghost_row_pattern",
+                             &dolfinx::la::SparsityPattern::ghost_row_pattern,
+                             py::return_value_policy::reference_internal);
+
+  // dolfinx::la::MatrixCSR
+  py::class_<dolfinx::la::MatrixCSR<PetscScalar>,
+             std::shared_ptr<dolfinx::la::MatrixCSR<PetscScalar>>>(
+      m, "MatrixCSR")
+      .def(py::init<const dolfinx::la::SparsityPattern&>())
+      .def("set", &dolfinx::la::MatrixCSR<PetscScalar>::set)
+      .def_property_readonly(
+          "num_owned_rows",
+          &dolfinx::la::MatrixCSR<PetscScalar>::num_owned_rows)
+      .def_property_readonly(
+          "data",
+          [](dolfinx::la::MatrixCSR<PetscScalar>& self) {
+            std::vector<PetscScalar>& values = self.values();
+            return py::array_t<PetscScalar>(values.size(), values.data(),
+                                            py::cast(self));
+          })
+      .def("finalize", &dolfinx::la::MatrixCSR<PetscScalar>::finalize);
 
   // dolfinx::la::VectorSpaceBasis
   py::class_<dolfinx::la::VectorSpaceBasis,
@@ -118,6 +140,14 @@ void la(py::module& m)
       },
       py::return_value_policy::take_ownership,
       "Create a PETSc Mat from sparsity pattern.");
+  m.def(
+      "create_matrix",
+      [](const MPICommWrapper comm, dolfinx::la::MatrixCSR<PetscScalar>& A) {
+        return dolfinx::la::create_petsc_matrix(comm.get(), A);
+      },
+      py::return_value_policy::take_ownership,
+      "Create a PETSc Mat that shares the values of a MatrixCSR. The "
+      "MatrixCSR must be kept alive while the Mat is in use.");
   m.def("create_petsc_index_sets", &dolfinx::la::create_petsc_index_sets,
         py::return_value_policy::take_ownership);
   m.def("scatter_local_vectors", &dolfinx::la::scatter_local_vectors,
@@ -118,10 +118,12 @@ void mesh(py::module& m)
          const dolfinx::fem::CoordinateElement& element,
          const Eigen::Ref<const Eigen::Array<
              double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>& x,
-         dolfinx::mesh::GhostMode ghost_mode) {
+         dolfinx::mesh::GhostMode ghost_mode, bool reorder) {
         return dolfinx::mesh::create_mesh(comm.get(), cells, element, x,
-                                          ghost_mode);
+                                          ghost_mode, reorder);
       },
+      py::arg("comm"), py::arg("cells"), py::arg("element"), py::arg("x"),
+      py::arg("ghost_mode"), py::arg("reorder") = false,
       "Helper function for creating meshes.");
 
   // dolfinx::mesh::GhostMode enums
@@ -177,10 +179,12 @@ void mesh(py::module& m)
       }))
       .def("set_connectivity", &dolfinx::mesh::Topology::set_connectivity)
       .def("set_index_map", &dolfinx::mesh::Topology::set_index_map)
-      .def("create_entities", &dolfinx::mesh::Topology::create_entities)
+      .def("create_entities", &dolfinx::mesh::Topology::create_entities,
+           py::arg("dim"), py::arg("num_threads") = 1)
       .def("create_entity_permutations",
            &dolfinx::mesh::Topology::create_entity_permutations)
-      .def("create_connectivity", &dolfinx::mesh::Topology::create_connectivity)
+      .def("create_connectivity", &dolfinx::mesh::Topology::create_connectivity,
+           py::arg("d0"), py::arg("d1"), py::arg("num_threads") = 1)
       .def("create_connectivity_all",
            &dolfinx::mesh::Topology::create_connectivity_all)
       .def("get_facet_permutations",
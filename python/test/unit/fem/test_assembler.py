@@ -692,3 +692,225 @@ def test_basic_assembly_constant(mode):
 
     assert (A1 * 3.0 - A2 * 5.0).norm() == pytest.approx(0.0)
     assert (b1 * 3.0 - b2 * 5.0).norm() == pytest.approx(0.0)
+
+
+@pytest.mark.parametrize("num_threads", [2, 4])
+def test_threaded_assembly(num_threads):
+    """Check that thread-parallel assembly of cell integrals gives the
+    same result as serial assembly"""
+    mesh = UnitCubeMesh(MPI.COMM_WORLD, 6, 5, 4)
+    V = function.FunctionSpace(mesh, ("Lagrange", 2))
+    f = function.Function(V)
+    f.interpolate(lambda x: 1.0 + x[0] * x[1])
+    v = ufl.TestFunction(V)
+
+    M = dolfinx.fem.Form(f * f * dx)._cpp_object
+    value0 = dolfinx.cpp.fem.assemble_scalar(M)
+    value1 = dolfinx.cpp.fem.assemble_scalar(M, num_threads)
+    assert value1 == pytest.approx(value0, rel=1e-12)
+
+    L = dolfinx.fem.Form(inner(f, v) * dx)._cpp_object
+    b0 = numpy.zeros(V.dofmap.index_map.size_local + V.dofmap.index_map.num_ghosts, dtype=PETSc.ScalarType)
+    b1 = numpy.zeros_like(b0)
+    dolfinx.cpp.fem.assemble_vector(b0, L)
+    dolfinx.cpp.fem.assemble_vector(b1, L, num_threads)
+    assert numpy.allclose(b0, b1, rtol=1e-12, atol=1e-14)
+
+
+@pytest.mark.parametrize("num_threads", [2, 4])
+def test_threaded_matrix_assembly(num_threads):
+    """Check that thread-parallel assembly of cell and facet integrals
+    into a PETSc matrix gives the same result as serial assembly"""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 12, 10, ghost_mode=dolfinx.cpp.mesh.GhostMode.shared_facet)
+    V = dolfinx.FunctionSpace(mesh, ("Lagrange", 2))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    k = function.Function(V)
+    k.interpolate(lambda x: 1.0 + x[0] * x[1])
+    a = k * inner(ufl.grad(u), ufl.grad(v)) * dx + k * inner(u, v) * ds + inner(ufl.avg(u), ufl.avg(v)) * ufl.dS
+    a_cpp = dolfinx.fem.Form(a)._cpp_object
+
+    bdofsV = dolfinx.fem.locate_dofs_geometrical(V, lambda x: x[0] < 1.0e-6)
+    bc = dolfinx.fem.dirichletbc.DirichletBC(function.Function(V), bdofsV)
+
+    A0 = dolfinx.cpp.fem.create_matrix(a_cpp)
+    A0.zeroEntries()
+    dolfinx.cpp.fem.assemble_matrix_petsc(A0, a_cpp, [bc])
+    A0.assemble()
+
+    A1 = dolfinx.cpp.fem.create_matrix(a_cpp)
+    A1.zeroEntries()
+    dolfinx.cpp.fem.assemble_matrix_petsc(A1, a_cpp, [bc], num_threads)
+    A1.assemble()
+    assert A1.norm() == pytest.approx(A0.norm(), rel=1.0e-12)
+    assert (A1 - A0).norm() == pytest.approx(0.0, abs=1.0e-12 * A0.norm())
+
+    plan = dolfinx.cpp.fem.AssemblyPlan(a_cpp)
+    plan.create_colorings()
+    A1.zeroEntries()
+    dolfinx.cpp.fem.assemble_matrix_petsc(A1, plan, [bc], num_threads)
+    A1.assemble()
+    assert (A1 - A0).norm() == pytest.approx(0.0, abs=1.0e-12 * A0.norm())
+
+
+@pytest.mark.parametrize("mode", [dolfinx.cpp.mesh.GhostMode.none, dolfinx.cpp.mesh.GhostMode.shared_facet])
+def test_matrix_free_action(mode):
+    """Check that the matrix-free operator action and diagonal match
+    those of the assembled matrix, including after a coefficient in the
+    form has changed"""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 12, 12, ghost_mode=mode)
+    V = dolfinx.FunctionSpace(mesh, ("Lagrange", 2))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    k = function.Function(V)
+    k.interpolate(lambda x: 1.0 + x[0])
+    a = k * inner(ufl.grad(u), ufl.grad(v)) * dx + inner(u, v) * ds
+
+    bdofsV = dolfinx.fem.locate_dofs_geometrical(V, lambda x: x[0] < 1.0e-6)
+    u_bc = dolfinx.function.Function(V)
+    bc = dolfinx.fem.dirichletbc.DirichletBC(u_bc, bdofsV)
+    A_free = dolfinx.cpp.fem.create_matrix_free(dolfinx.fem.Form(a)._cpp_object, [bc])
+
+    for scale in (1.0, 3.0):
+        with k.vector.localForm() as k_local:
+            k_local.scale(scale)
+        A = dolfinx.fem.assemble_matrix(a, [bc])
+        A.assemble()
+
+        x, y0 = A.createVecs()
+        x.setRandom()
+        y1 = y0.duplicate()
+        A.mult(x, y0)
+        A_free.mult(x, y1)
+        assert (y1 - y0).norm() == pytest.approx(0.0, abs=1.0e-10 * y0.norm())
+
+        d0, d1 = A.getDiagonal(), A_free.getDiagonal()
+        assert (d1 - d0).norm() == pytest.approx(0.0, abs=1.0e-10 * d0.norm())
+
+
+def test_assembly_plan():
+    """Check that assembly with a reusable plan matches standard assembly
+    for cell and facet integrals, including after a coefficient update"""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 8, 8, ghost_mode=dolfinx.cpp.mesh.GhostMode.shared_facet)
+    V = dolfinx.FunctionSpace(mesh, ("Lagrange", 1))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    k = function.Function(V)
+    k.interpolate(lambda x: 1.0 + x[0])
+    a = k * inner(u, v) * dx + k * inner(u, v) * ds + inner(ufl.avg(u), ufl.avg(v)) * ufl.dS
+    a_cpp = dolfinx.fem.Form(a)._cpp_object
+    plan = dolfinx.cpp.fem.AssemblyPlan(a_cpp)
+
+    for scale in (1.0, 2.0):
+        with k.vector.localForm() as k_local:
+            k_local.scale(scale)
+        plan.update_coefficients()
+
+        A0 = dolfinx.fem.assemble_matrix(a)
+        A0.assemble()
+        A1 = dolfinx.cpp.fem.create_matrix(a_cpp)
+        A1.zeroEntries()
+        dolfinx.cpp.fem.assemble_matrix_petsc(A1, plan, [])
+        A1.assemble()
+        assert (A1 - A0).norm() == pytest.approx(0.0, abs=1.0e-12 * A0.norm())
+
+
+@pytest.mark.parametrize("num_threads", [1, 3])
+def test_assembly_plan_changed_coefficients(num_threads):
+    """Check that an assembly plan repacks only the coefficients that
+    have changed"""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 8, 8)
+    V = dolfinx.FunctionSpace(mesh, ("Lagrange", 1))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    k0, k1 = function.Function(V), function.Function(V)
+    k0.interpolate(lambda x: 1.0 + x[0])
+    k1.interpolate(lambda x: 1.0 + x[1])
+    a = k0 * k1 * inner(u, v) * dx
+    a_cpp = dolfinx.fem.Form(a)._cpp_object
+    plan = dolfinx.cpp.fem.AssemblyPlan(a_cpp)
+    assert plan.update_changed_coefficients(num_threads) == 0
+
+    # Evaluating a coefficient does not change it
+    k0.eval(mesh.geometry.x[mesh.geometry.dofmap.links(0)[0]], 0)
+    assert plan.update_changed_coefficients(num_threads) == 0
+
+    k1.interpolate(lambda x: 2.0 + x[0] * x[1])
+    assert plan.update_changed_coefficients(num_threads) == 1
+    with k0.vector.localForm() as k_local:
+        k_local.scale(2.0)
+    assert plan.update_changed_coefficients(num_threads) == 1
+
+    A0 = dolfinx.fem.assemble_matrix(a)
+    A0.assemble()
+    A1 = dolfinx.cpp.fem.create_matrix(a_cpp)
+    A1.zeroEntries()
+    dolfinx.cpp.fem.assemble_matrix_petsc(A1, plan, [])
+    A1.assemble()
+    assert (A1 - A0).norm() == pytest.approx(0.0, abs=1.0e-12 * A0.norm())
+
+
+@pytest.mark.parametrize("num_threads", [1, 3])
+def test_assemble_matrix_csr(num_threads):
+    """Check that assembly into a native CSR matrix with cached
+    insertion positions, and export to PETSc, matches PETSc assembly"""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 8, 8)
+    V = dolfinx.FunctionSpace(mesh, ("Lagrange", 2))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    a = inner(ufl.grad(u), ufl.grad(v)) * dx + inner(u, v) * ds
+    a_cpp = dolfinx.fem.Form(a)._cpp_object
+
+    bdofsV = dolfinx.fem.locate_dofs_geometrical(V, lambda x: x[0] < 1.0e-6)
+    bc = dolfinx.fem.dirichletbc.DirichletBC(dolfinx.function.Function(V), bdofsV)
+
+    A0 = dolfinx.fem.assemble_matrix(a, [bc], diagonal=0.0)
+    A0.assemble()
+    ai, aj, av = A0.getValuesCSR()
+
+    pattern = dolfinx.cpp.fem.create_sparsity_pattern(a_cpp)
+    pattern.assemble()
+    A1 = dolfinx.cpp.la.MatrixCSR(pattern)
+    plan = dolfinx.cpp.fem.AssemblyPlan(a_cpp, A1)
+    if num_threads > 1:
+        plan.create_colorings()
+    dolfinx.cpp.fem.assemble_matrix_csr(A1, plan, [bc], num_threads)
+    A1.finalize()
+    A2 = dolfinx.cpp.la.create_matrix(mesh.mpi_comm(), A1)
+    ai2, aj2, av2 = A2.getValuesCSR()
+    assert numpy.array_equal(ai2, ai)
+    assert numpy.array_equal(aj2, aj)
+    assert numpy.allclose(av2, av)
+    A2.destroy()
+
+
+@pytest.mark.parametrize("mode", [dolfinx.cpp.mesh.GhostMode.none, dolfinx.cpp.mesh.GhostMode.shared_facet])
+def test_matrix_csr_petsc_columns(mode):
+    """Check that a PETSc matrix sharing the values of a CSR matrix has
+    sorted global column indices in each row, and that it matches the
+    PETSc assembler. In parallel the off-process columns of the CSR
+    matrix are not numbered in order of global index."""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 11, 9, ghost_mode=mode)
+    V = dolfinx.VectorFunctionSpace(mesh, ("Lagrange", 2))
+    u, v = ufl.TrialFunction(V), ufl.TestFunction(V)
+    a = inner(ufl.grad(u), ufl.grad(v)) * dx + inner(u, v) * ds
+    a_cpp = dolfinx.fem.Form(a)._cpp_object
+
+    A0 = dolfinx.fem.assemble_matrix(a, [], diagonal=0.0)
+    A0.assemble()
+
+    pattern = dolfinx.cpp.fem.create_sparsity_pattern(a_cpp)
+    pattern.assemble()
+    A1 = dolfinx.cpp.la.MatrixCSR(pattern)
+    plan = dolfinx.cpp.fem.AssemblyPlan(a_cpp, A1)
+    dolfinx.cpp.fem.assemble_matrix_csr(A1, plan, [])
+    A1.finalize()
+    A2 = dolfinx.cpp.la.create_matrix(mesh.mpi_comm(), A1)
+
+    ai, aj, _ = A2.getValuesCSR()
+    for i in range(len(ai) - 1):
+        assert numpy.all(numpy.diff(aj[ai[i]:ai[i + 1]]) > 0)
+
+    x, y0 = A0.createVecs()
+    x.setRandom()
+    y1 = y0.duplicate()
+    A0.mult(x, y0)
+    A2.mult(x, y1)
+    assert (y1 - y0).norm() == pytest.approx(0.0, abs=1.0e-12 * y0.norm())
+    assert A2.norm() == pytest.approx(A0.norm(), rel=1.0e-12)
+    A2.destroy()
@@ -70,6 +70,31 @@ def tabulate_tensor_b_coeff(b_, w_, c_, coords_, local_index, orientation):
     b[:] = w[0] * Ae / 6.0
 
 
+c_signature_batch = numba.types.void(
+    numba.types.CPointer(numba.typeof(PETSc.ScalarType())),
+    numba.types.CPointer(numba.typeof(PETSc.ScalarType())),
+    numba.types.CPointer(numba.typeof(PETSc.ScalarType())),
+    numba.types.CPointer(numba.types.double),
+    numba.types.CPointer(numba.types.int32),
+    numba.types.CPointer(numba.types.uint8),
+    numba.types.CPointer(numba.types.uint32))
+
+
+@numba.cfunc(c_signature_batch, nopython=True)
+def tabulate_tensor_b_batch(b_, w_, c_, coords_, local_index, perm, cell_info):
+    # Interleaved layout: cell index in the batch runs fastest
+    b = numba.carray(b_, (3, 4), dtype=PETSc.ScalarType)
+    coordinate_dofs = numba.carray(coords_, (3, 2, 4), dtype=np.float64)
+    x0, y0 = coordinate_dofs[0, 0, :], coordinate_dofs[0, 1, :]
+    x1, y1 = coordinate_dofs[1, 0, :], coordinate_dofs[1, 1, :]
+    x2, y2 = coordinate_dofs[2, 0, :], coordinate_dofs[2, 1, :]
+
+    # 2x Element area Ae
+    Ae = np.abs((x0 - x1) * (y2 - y1) - (y0 - y1) * (x2 - x1))
+    for i in range(3):
+        b[i, :] = Ae / 6.0
+
+
 def test_numba_assembly():
     mesh = UnitSquareMesh(MPI.COMM_WORLD, 13, 13)
     V = FunctionSpace(mesh, ("Lagrange", 1))
@@ -95,6 +120,19 @@ def test_numba_assembly():
     list_timings(MPI.COMM_WORLD, [TimingType.wall])
 
 
+def test_numba_batch_assembly():
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 13, 13)
+    V = FunctionSpace(mesh, ("Lagrange", 1))
+
+    L = cpp.fem.Form([V._cpp_object], False)
+    L.set_tabulate_tensor(IntegralType.cell, -1, tabulate_tensor_b.address)
+    L.set_tabulate_tensor_batch(IntegralType.cell, -1, tabulate_tensor_b_batch.address, 4)
+
+    b = dolfinx.fem.assemble_vector(L)
+    b.ghostUpdate(addv=PETSc.InsertMode.ADD, mode=PETSc.ScatterMode.REVERSE)
+    assert (np.isclose(b.norm(PETSc.NormType.N2), 0.0739710713711999))
+
+
 def test_coefficient():
     mesh = UnitSquareMesh(MPI.COMM_WORLD, 13, 13)
     V = FunctionSpace(mesh, ("Lagrange", 1))
@@ -195,6 +195,47 @@ def test_eval_multiple(W):
     u.eval(x[0], cell)
 
 
+def test_eval_cell_groups(V):
+    u = Function(V)
+    u.interpolate(lambda x: x[0] + 2 * x[1] - x[2])
+    mesh = V.mesh
+    tree = geometry.BoundingBoxTree(mesh, mesh.topology.dim)
+
+    # Many points per cell, not ordered by cell. Points that are not on
+    # this process are ignored.
+    x = np.random.RandomState(0).random_sample((200, 3))
+    candidates = geometry.compute_collisions_points(tree, x)
+    cells = geometry.select_colliding_cells(mesh, candidates, x)
+    cell = np.array([c[0] if len(c) > 0 else -1 for c in (cells.links(i) for i in range(len(x)))])
+    values = u.eval(x, cell)
+    found = cell >= 0
+    assert np.allclose(values[found, 0], x[found, 0] + 2 * x[found, 1] - x[found, 2])
+    assert np.allclose(values[~found, 0], 0.0)
+
+
+def test_eval_points(W):
+    mesh = W.mesh
+    tree = geometry.BoundingBoxTree(mesh, mesh.topology.dim)
+
+    # Points are different on each process, and the last point is
+    # outside the mesh
+    x = np.random.RandomState(MPI.COMM_WORLD.rank).random_sample((20, 3))
+    x[-1] = [1.5, 0.5, 0.5]
+    plan = geometry.PointOwnership(mesh, tree, x)
+    assert plan.num_points == 20
+    assert plan.num_lost_points == 1
+
+    # Repeated evaluation with the same plan
+    u = Function(W)
+    for t in [1.0, 2.0]:
+        u.interpolate(lambda x: np.stack((t * x[0], x[1] + x[2], 2 * x[0] - x[2])))
+        values = u.eval_points(plan)
+        assert np.allclose(values[:-1, 0], t * x[:-1, 0])
+        assert np.allclose(values[:-1, 1], x[:-1, 1] + x[:-1, 2])
+        assert np.allclose(values[:-1, 2], 2 * x[:-1, 0] - x[:-1, 2])
+        assert np.allclose(values[-1], 0.0)
+
+
 @skip_in_parallel
 def test_eval_manifold():
     # Simple two-triangle surface in 3d
@@ -10,8 +10,11 @@ import random
 import numpy as np
 import pytest
 import ufl
-from dolfinx import Function, FunctionSpace, VectorFunctionSpace, cpp
+from dolfinx import (Function, FunctionSpace, UnitSquareMesh,
+                     VectorFunctionSpace, cpp, geometry)
 from dolfinx.cpp.mesh import CellType
+from dolfinx.function import (ExpressionInterpolation,
+                              NonMatchingInterpolation)
 from dolfinx.mesh import create_mesh
 from dolfinx_utils.test.skips import skip_in_parallel
 from mpi4py import MPI
@@ -131,3 +134,80 @@ def test_vector_interpolation(cell_type, order):
     values = v.eval(points, cells)
     for p, v in zip(points, values):
         assert np.allclose(v, f(p))
+
+
+def test_nonmatching_interpolation():
+    """Test interpolation between vector functions on non-matching meshes,
+    re-using the transfer operator"""
+    mesh0 = UnitSquareMesh(MPI.COMM_WORLD, 5, 7)
+    mesh1 = UnitSquareMesh(MPI.COMM_WORLD, 8, 3, diagonal="left")
+    V0 = VectorFunctionSpace(mesh0, ("Lagrange", 2))
+    V1 = VectorFunctionSpace(mesh1, ("Lagrange", 2))
+    op = NonMatchingInterpolation(V1, V0)
+    assert op.num_lost_points == 0
+
+    u0, u1, u1_exact = Function(V0), Function(V1), Function(V1)
+    for t in [1.0, 2.0]:
+        def f(x):
+            return np.stack((t * x[0] * x[1], x[0] ** 2 + 2 * x[1]))
+
+        u0.interpolate(f)
+        u1_exact.interpolate(f)
+        op.apply(u0, u1)
+        assert np.allclose(u1.vector.array, u1_exact.vector.array)
+
+    # Interpolation between meshes also works without an operator
+    u1.vector.set(0.0)
+    u1.interpolate(u0)
+    assert np.allclose(u1.vector.array, u1_exact.vector.array)
+
+
+@skip_in_parallel
+@pytest.mark.parametrize("family", ["RT", "N1curl"])
+def test_nonmatching_interpolation_vector_element(family):
+    """Test interpolation from a non-blocked vector space on a non-matching
+    mesh, comparing with point evaluation of the source function"""
+    mesh0 = UnitSquareMesh(MPI.COMM_WORLD, 5, 7)
+    mesh1 = UnitSquareMesh(MPI.COMM_WORLD, 8, 3, diagonal="left")
+    V0 = FunctionSpace(mesh0, (family, 2))
+    V1 = VectorFunctionSpace(mesh1, ("Lagrange", 1))
+    op = NonMatchingInterpolation(V1, V0)
+    assert op.num_lost_points == 0
+
+    u0, u1 = Function(V0), Function(V1)
+    u0.vector.array[:] = np.random.RandomState(0).random_sample(u0.vector.local_size)
+    op.apply(u0, u1)
+    values = u1.vector.array.reshape(-1, 2)
+
+    # The source function is discontinuous between cells, so compare only
+    # at the points that are inside a single source cell. The dof
+    # coordinates are repeated for each component.
+    tree = geometry.BoundingBoxTree(mesh0, mesh0.topology.dim)
+    num_checked = 0
+    for x, value in zip(V1.tabulate_dof_coordinates()[::2], values):
+        cells = geometry.compute_colliding_cells(tree, mesh0, x, 2)
+        if len(cells) == 1:
+            assert np.allclose(value, u0.eval(x, cells[0]))
+            num_checked += 1
+    assert num_checked > 0
+
+
+def test_expression_interpolation():
+    """Test repeated interpolation of an expression with precomputed points"""
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 4, 3)
+    V = VectorFunctionSpace(mesh, ("Lagrange", 2))
+    op = ExpressionInterpolation(V)
+    assert op.points.shape[0] == 3
+
+    # The dof coordinates are repeated for each component, and the dofs
+    # of each point are ordered by component
+    u = Function(V)
+    x = V.tabulate_dof_coordinates()[:u.vector.local_size].T
+    component = np.arange(u.vector.local_size) % 2
+    for t in [1.0, 2.0]:
+        def f(x):
+            return np.stack((t * x[0], x[1] ** 2))
+
+        op.interpolate(u, f)
+        u_exact = np.where(component == 0, t * x[0], x[1] ** 2)
+        assert np.allclose(u.vector.array, u_exact)
@@ -103,6 +103,62 @@ def test_compute_collisions_tree_3d():
         assert entities_B == references[i][1]
 
 
+@pytest.mark.parametrize("num_threads", [2, 4])
+def test_compute_collisions_threads(num_threads):
+    mesh = UnitCubeMesh(MPI.COMM_WORLD, 6, 5, 4)
+    tree0 = BoundingBoxTree(mesh, mesh.topology.dim)
+    tree1 = BoundingBoxTree(mesh, mesh.topology.dim, num_threads=num_threads)
+
+    # Bounding box of each cell, for an exhaustive search
+    x, x_dofmap = mesh.geometry.x, mesh.geometry.dofmap
+    cell_map = mesh.topology.index_map(mesh.topology.dim)
+    num_cells = cell_map.size_local + cell_map.num_ghosts
+    bboxes = numpy.array([[x[x_dofmap.links(c)].min(axis=0), x[x_dofmap.links(c)].max(axis=0)]
+                          for c in range(num_cells)])
+
+    for p in numpy.random.RandomState(0).random_sample((20, 3)):
+        entities0 = geometry.compute_collisions_point(tree0, p)
+        entities1 = geometry.compute_collisions_point(tree1, p)
+        assert entities0 == entities1
+
+        inside = numpy.logical_and(bboxes[:, 0] <= p, p <= bboxes[:, 1]).all(axis=1)
+        assert sorted(entities1) == numpy.flatnonzero(inside).tolist()
+
+
+@pytest.mark.parametrize("num_threads", [1, 3])
+def test_refit(num_threads):
+    mesh = UnitCubeMesh(MPI.COMM_WORLD, 5, 4, 3)
+    tree = BoundingBoxTree(mesh, mesh.topology.dim, num_threads=num_threads)
+
+    # Deform mesh, and compare refitted tree with a new tree
+    x = mesh.geometry.x
+    x[:, 0] += 0.2 * numpy.sin(numpy.pi * x[:, 1]) * x[:, 2]
+    tree.refit(mesh, num_threads)
+    tree_new = BoundingBoxTree(mesh, mesh.topology.dim)
+    for p in numpy.random.RandomState(2).random_sample((20, 3)):
+        entities = geometry.compute_collisions_point(tree, p)
+        entities_new = geometry.compute_collisions_point(tree_new, p)
+        assert sorted(entities) == sorted(entities_new)
+
+    # Rebuild only if the cost has grown by the given factor
+    assert tree.cost() > 0.0
+    assert not tree.update(mesh, max_cost_ratio=1e6, num_threads=num_threads)
+    assert tree.update(mesh, max_cost_ratio=0.0, num_threads=num_threads)
+
+
+@pytest.mark.parametrize("num_threads", [1, 3])
+def test_compute_collisions_points(num_threads):
+    mesh = UnitCubeMesh(MPI.COMM_WORLD, 5, 4, 3)
+    tree = BoundingBoxTree(mesh, mesh.topology.dim)
+    points = numpy.random.RandomState(1).random_sample((50, 3))
+    candidates = geometry.compute_collisions_points(tree, points, num_threads)
+    cells = geometry.select_colliding_cells(mesh, candidates, points, num_threads)
+    assert candidates.num_nodes == cells.num_nodes == len(points)
+    for i, p in enumerate(points):
+        assert list(candidates.links(i)) == geometry.compute_collisions_point(tree, p)
+        assert list(cells.links(i)) == geometry.compute_colliding_cells(tree, mesh, p, 0)
+
+
 @skip_in_parallel
 def test_compute_closest_entity_1d():
     reference = (0, 1.0)
@@ -7,7 +7,7 @@
 import numpy as np
 import pytest
 import ufl
-from dolfinx import cpp, geometry
+from dolfinx import UnitCubeMesh, cpp, geometry
 from dolfinx.cpp.geometry import compute_distance_gjk
 from dolfinx.mesh import create_mesh
 from dolfinx_utils.test.skips import skip_in_parallel
@@ -186,3 +186,25 @@ def test_collision_2nd_order_triangle():
     # point = np.array([0.25, 0.89320760, 0])
     distance = cpp.geometry.squared_distance(mesh, mesh.topology.dim - 1, 2, point)
     assert np.isclose(distance, 0)
+
+
+@skip_in_parallel
+def test_distances_gjk_mesh_pairs():
+    """Compare batched distances between the cells of two meshes with
+    distances computed for each pair"""
+    mesh0 = UnitCubeMesh(MPI.COMM_WORLD, 2, 2, 2)
+    mesh1 = UnitCubeMesh(MPI.COMM_WORLD, 3, 2, 1)
+    mesh1.geometry.x[:, 0] += 0.7
+    tdim = mesh0.topology.dim
+    tree0 = geometry.BoundingBoxTree(mesh0, tdim)
+    tree1 = geometry.BoundingBoxTree(mesh1, tdim)
+    pairs = geometry.compute_collisions(tree0, tree1)
+    assert len(pairs) > 0
+
+    distances = geometry.compute_distances_gjk(mesh0, tdim, mesh1, tdim, pairs, num_threads=3)
+    assert distances.shape == (len(pairs), 3)
+    x0, x1 = mesh0.geometry.x, mesh1.geometry.x
+    for (c0, c1), d in zip(pairs, distances):
+        nodes0 = x0[mesh0.geometry.dofmap.links(c0)]
+        nodes1 = x1[mesh1.geometry.dofmap.links(c1)]
+        assert np.allclose(d, compute_distance_gjk(nodes0, nodes1))
@@ -10,6 +10,7 @@ import pytest
 from dolfinx import (Function, FunctionSpace, TensorFunctionSpace,
                      UnitCubeMesh, UnitIntervalMesh, UnitSquareMesh,
                      VectorFunctionSpace)
+from dolfinx.common import has_zlib
 from dolfinx.cpp.mesh import CellType
 from dolfinx.io import VTKFile
 from dolfinx_utils.test.fixtures import tempdir
@@ -31,7 +32,10 @@ def cell_types_3D():
 
 @pytest.fixture
 def file_options():
-    return ["ascii", "base64", "compressed"]
+    encodings = [VTKFile.Encoding.ASCII, VTKFile.Encoding.RAW]
+    if has_zlib:
+        encodings.append(VTKFile.Encoding.ZLIB)
+    return encodings
 
 
 @pytest.fixture
@@ -44,7 +48,6 @@ def tempfile(tempdir, request):
     return os.path.join(tempdir, request.function.__name__)
 
 
-@pytest.mark.xfail(reason="file_option not added to VTK initializer")
 def test_save_1d_mesh(tempfile, file_options):
     mesh = UnitIntervalMesh(MPI.COMM_WORLD, 32)
     VTKFile(tempfile + "mesh.pvd").write(mesh)
@@ -55,7 +58,6 @@ def test_save_1d_mesh(tempfile, file_options):
         VTKFile(tempfile + "mesh.pvd", file_option).write(mesh)
 
 
-@pytest.mark.xfail(reason="file_option not added to VTK initializer")
 def test_save_2d_mesh(tempfile, file_options):
     mesh = UnitSquareMesh(MPI.COMM_WORLD, 32, 32)
     VTKFile(tempfile + "mesh.pvd").write(mesh)
@@ -66,7 +68,6 @@ def test_save_2d_mesh(tempfile, file_options):
         VTKFile(tempfile + "mesh.pvd", file_option).write(mesh)
 
 
-@pytest.mark.xfail(reason="file_option not added to VTK initializer")
 def test_save_3d_mesh(tempfile, file_options):
     mesh = UnitCubeMesh(MPI.COMM_WORLD, 8, 8, 8)
     VTKFile(tempfile + "mesh.pvd").write(mesh)
@@ -77,7 +78,6 @@ def test_save_3d_mesh(tempfile, file_options):
         VTKFile(tempfile + "mesh.pvd", file_option).write(mesh)
 
 
-@pytest.mark.xfail(reason="file_option not added to VTK initializer")
 def test_save_1d_scalar(tempfile, file_options):
     mesh = UnitIntervalMesh(MPI.COMM_WORLD, 32)
     u = Function(FunctionSpace(mesh, ("Lagrange", 2)))
@@ -90,7 +90,6 @@ def test_save_1d_scalar(tempfile, file_options):
         VTKFile(tempfile + "u.pvd", file_option).write(u)
 
 
-@pytest.mark.xfail(reason="file_option not added to VTK initializer")
 def test_save_2d_scalar(tempfile, file_options):
     mesh = UnitSquareMesh(MPI.COMM_WORLD, 16, 16)
     u = Function(FunctionSpace(mesh, ("Lagrange", 2)))
@@ -103,7 +102,6 @@ def test_save_2d_scalar(tempfile, file_options):
         VTKFile(tempfile + "u.pvd", file_option).write(u)
 
 
-@pytest.mark.xfail(reason="file_option not added to VTK initializer")
 def test_save_3d_scalar(tempfile, file_options):
     mesh = UnitCubeMesh(MPI.COMM_WORLD, 8, 8, 8)
     u = Function(FunctionSpace(mesh, ("Lagrange", 2)))
@@ -127,7 +125,6 @@ def test_save_1d_vector(tempfile, file_options):
         VTKFile(tempfile + "u.pvd", file_option).write(u)
 
 
-@pytest.mark.xfail(reason="file_option not added to VTK initializer")
 def test_save_2d_vector(tempfile, file_options):
     mesh = UnitSquareMesh(MPI.COMM_WORLD, 16, 16)
     u = Function(VectorFunctionSpace(mesh, "Lagrange", 2))
@@ -140,7 +137,6 @@ def test_save_2d_vector(tempfile, file_options):
         VTKFile(tempfile + "u.pvd", file_option).write(u)
 
 
-@pytest.mark.xfail(reason="file_option not added to VTK initializer")
 def test_save_3d_vector(tempfile, file_options):
     mesh = UnitCubeMesh(MPI.COMM_WORLD, 8, 8, 8)
     u = Function(VectorFunctionSpace(mesh, "Lagrange", 2))
@@ -164,7 +160,6 @@ def test_save_1d_tensor(tempfile, file_options):
         VTKFile(tempfile + "u.pvd", file_option).write(u)
 
 
-@pytest.mark.xfail(reason="file_option not added to VTK initializer")
 def test_save_2d_tensor(tempfile, file_options):
     mesh = UnitSquareMesh(MPI.COMM_WORLD, 16, 16)
     u = Function(TensorFunctionSpace(mesh, ("Lagrange", 2)))
@@ -177,7 +172,6 @@ def test_save_2d_tensor(tempfile, file_options):
         VTKFile(tempfile + "u.pvd", file_option).write(u)
 
 
-@pytest.mark.xfail(reason="file_option not added to VTK initializer")
 def test_save_3d_tensor(tempfile, file_options):
     mesh = UnitCubeMesh(MPI.COMM_WORLD, 8, 8, 8)
     u = Function(TensorFunctionSpace(mesh, ("Lagrange", 2)))
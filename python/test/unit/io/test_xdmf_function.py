@@ -5,7 +5,9 @@
 # SPDX-License-Identifier:    LGPL-3.0-or-later
 
 import os
+import xml.etree.ElementTree as ET
 
+import numpy
 import pytest
 from dolfinx import (Function, FunctionSpace, TensorFunctionSpace,
                      UnitCubeMesh, UnitIntervalMesh, UnitSquareMesh,
@@ -152,3 +154,90 @@ def test_save_3d_vector_series(tempdir, encoding, cell_type):
     with XDMFFile(mesh.mpi_comm(), filename, "a", encoding=encoding) as file:
         u.vector.set(3.0 + (3j if has_petsc_complex else 0))
         file.write_function(u, 0.3)
+
+
+@pytest.mark.parametrize("cell_type", celltypes_2D)
+def test_save_2d_scalar_series_async(tempdir, cell_type):
+    filename = os.path.join(tempdir, "u2_async.xdmf")
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 8, 8, cell_type)
+    u = Function(FunctionSpace(mesh, ("Lagrange", 1)))
+    u.name = "u"
+    with XDMFFile(mesh.mpi_comm(), filename, "w", asynchronous=True) as file:
+        if not file.asynchronous:
+            pytest.skip("Asynchronous output is not supported by HDF5 or MPI")
+        file.write_mesh(mesh)
+        for t in range(5):
+            u.interpolate(lambda x: t + x[0] - 2 * x[1])
+            file.write_function(u, t)
+
+    # The point values of each step are stored in the order of the
+    # geometry nodes
+    name = "real_u" if has_petsc_complex else "u"
+    with XDMFFile(mesh.mpi_comm(), filename, "r") as file:
+        mesh2 = file.read_mesh()
+        x = file.read_geometry_data()
+        for t in range(5):
+            values = file.read_attribute_data(name, "/Xdmf/Domain/Grid[@Name='u']/Grid[{}]".format(t + 1))
+            assert values.shape == (x.shape[0], 1)
+            assert numpy.allclose(values[:, 0], t + x[:, 0] - 2 * x[:, 1])
+    assert mesh2.topology.index_map(2).size_global == mesh.topology.index_map(2).size_global
+
+    if MPI.COMM_WORLD.rank == 0:
+        steps = ET.parse(filename).getroot().findall("./Domain/Grid[@GridType='Collection']/Grid")
+        assert len(steps) == 5
+        assert [float(s.find("Time").get("Value")) for s in steps] == list(range(5))
+
+
+@pytest.mark.parametrize("encoding", encodings)
+def test_save_series_xml(tempdir, encoding):
+    filename = os.path.join(tempdir, "u_series.xdmf")
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 4, 4)
+    u = Function(FunctionSpace(mesh, ("Lagrange", 1)))
+    u.name = "u"
+    v = Function(FunctionSpace(mesh, ("Lagrange", 1)))
+    v.name = "v"
+    with XDMFFile(mesh.mpi_comm(), filename, "w", encoding=encoding) as file:
+        file.write_mesh(mesh)
+        for t in range(10):
+            file.write_function(u, t)
+        for t in range(3):
+            file.write_function(v, t)
+            file.write_function(u, 10 + t)
+        file.write_information("steps", "13")
+
+    if MPI.COMM_WORLD.rank == 0:
+        root = ET.parse(filename).getroot()
+        for name, n in (("u", 13), ("v", 3)):
+            steps = root.findall("./Domain/Grid[@GridType='Collection'][@Name='{}']/Grid".format(name))
+            assert len(steps) == n
+            assert [float(s.find("Time").get("Value")) for s in steps] == list(range(n))
+
+
+def test_save_series_static_mesh(tempdir):
+    filename = os.path.join(tempdir, "u_static_mesh.xdmf")
+    mesh = UnitSquareMesh(MPI.COMM_WORLD, 4, 4)
+    u = Function(FunctionSpace(mesh, ("Lagrange", 1)))
+    with XDMFFile(mesh.mpi_comm(), filename, "w") as file:
+        for t in range(3):
+            file.write_function(u, t, mesh_xpath="")
+        mesh.geometry.x[:, 0] += 1.0
+        for t in range(3, 5):
+            file.write_function(u, t, mesh_xpath="")
+
+    # In append mode, the mesh written last is reused until it changes
+    with XDMFFile(mesh.mpi_comm(), filename, "a") as file:
+        for t in range(5, 7):
+            file.write_function(u, t, mesh_xpath="")
+        mesh.geometry.x[:, 1] += 1.0
+        file.write_function(u, 7, mesh_xpath="")
+
+    if MPI.COMM_WORLD.rank == 0:
+        root = ET.parse(filename).getroot()
+        meshes = root.findall("./Domain/Grid[@GridType='Uniform']")
+        assert [m.get("Name") for m in meshes] == ["mesh", "mesh_1", "mesh_2"]
+        steps = root.findall("./Domain/Grid[@GridType='Collection']/Grid")
+        assert len(steps) == 8
+        refs = [s.find("{http://www.w3.org/2001/XInclude}include").get("xpointer") for s in steps]
+        assert all("@Name='mesh']" in r for r in refs[:3])
+        assert all("@Name='mesh_1']" in r for r in refs[3:7])
+        assert "@Name='mesh_2']" in refs[7]
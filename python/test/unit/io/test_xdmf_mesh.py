@@ -9,7 +9,7 @@ import os
 import numpy as np
 import pytest
 from dolfinx import UnitCubeMesh, UnitIntervalMesh, UnitSquareMesh, cpp
-from dolfinx.cpp.io import perm_vtk
+from dolfinx.cpp.io import DatasetProperties, perm_vtk
 from dolfinx.cpp.mesh import CellType
 from dolfinx.io import XDMFFile, ufl_mesh_from_gmsh
 from dolfinx.mesh import create_mesh
@@ -98,6 +98,42 @@ def test_save_and_load_3d_mesh(tempdir, encoding, cell_type):
         dim).size_global == mesh2.topology.index_map(dim).size_global
 
 
+@pytest.mark.parametrize("chunking, chunk_rows", [(DatasetProperties.Chunking.automatic, 0),
+                                                  (DatasetProperties.Chunking.rows, 100)])
+def test_save_and_load_compressed_mesh(tempdir, chunking, chunk_rows):
+    filename = os.path.join(tempdir, "mesh_compressed.xdmf")
+    mesh = UnitCubeMesh(MPI.COMM_WORLD, 6, 6, 6)
+    properties = DatasetProperties()
+    properties.chunking = chunking
+    properties.chunk_rows = chunk_rows
+    properties.filter = DatasetProperties.Filter.deflate
+    with XDMFFile(mesh.mpi_comm(), filename, "w", mpi_info={"romio_cb_write": "enable"}) as file:
+        file.set_dataset_properties(properties)
+        file.write_mesh(mesh)
+
+    with XDMFFile(MPI.COMM_WORLD, filename, "r") as file:
+        mesh2 = file.read_mesh()
+        x_file = file.read_geometry_data()
+
+    assert mesh.topology.index_map(0).size_global == mesh2.topology.index_map(0).size_global
+    dim = mesh.topology.dim
+    assert mesh.topology.index_map(dim).size_global == mesh2.topology.index_map(dim).size_global
+
+    # Compare the node coordinates in the file with the mesh
+    def gather_sorted(x):
+        x = np.concatenate(MPI.COMM_WORLD.allgather(x))
+        return x[np.lexsort(x.T)]
+    num_nodes = mesh.geometry.index_map().size_local
+    assert np.allclose(gather_sorted(x_file), gather_sorted(mesh.geometry.x[:num_nodes]))
+
+    # The compressed data should be smaller than uncompressed data
+    filename_uncompressed = os.path.join(tempdir, "mesh_uncompressed.xdmf")
+    with XDMFFile(mesh.mpi_comm(), filename_uncompressed, "w") as file:
+        file.write_mesh(mesh)
+    size = [os.path.getsize(os.path.splitext(f)[0] + ".h5") for f in (filename, filename_uncompressed)]
+    assert size[0] < size[1]
+
+
 @pytest.mark.parametrize("encoding", encodings)
 def test_read_write_p2_mesh(tempdir, encoding):
     pygmsh = pytest.importorskip("pygmsh")
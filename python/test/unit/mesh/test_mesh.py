@@ -10,10 +10,12 @@ import sys
 import FIAT
 import numpy as np
 import pytest
+import ufl
 from dolfinx import (BoxMesh, RectangleMesh, UnitCubeMesh, UnitIntervalMesh,
                      UnitSquareMesh, cpp)
 from dolfinx.cpp.mesh import CellType, is_simplex
 from dolfinx.fem import assemble_scalar
+from dolfinx.mesh import create_mesh
 from dolfinx_utils.test.fixtures import tempdir
 from dolfinx_utils.test.skips import skip_in_parallel
 from mpi4py import MPI
@@ -355,3 +357,43 @@ def test_UnitHexMesh_assemble():
     vol = assemble_scalar(1 * dx(mesh))
     vol = mesh.mpi_comm().allreduce(vol, MPI.SUM)
     assert(vol == pytest.approx(1, rel=1e-9))
+
+
+@pytest.mark.parametrize("dim", [1, 2])
+def test_create_entities_threads(dim):
+    """Check that threaded entity and connectivity computation gives
+    the same results as the serial computation"""
+    meshes = [UnitCubeMesh(MPI.COMM_WORLD, 4, 3, 5) for i in range(2)]
+    for mesh, num_threads in zip(meshes, [1, 3]):
+        mesh.topology.create_entities(dim, num_threads)
+        mesh.topology.create_connectivity(dim, 3, num_threads)
+        mesh.topology.create_connectivity(2, 1, num_threads)
+    for d0, d1 in [(3, dim), (dim, 0), (dim, 3), (2, 1)]:
+        c0, c1 = [mesh.topology.connectivity(d0, d1) for mesh in meshes]
+        assert np.array_equal(c0.array, c1.array)
+        assert np.array_equal(c0.offsets, c1.offsets)
+
+
+@skip_in_parallel
+def test_create_mesh_reorder():
+    """Check that reordering cells of a shuffled mesh preserves the
+    mesh and reduces the bandwidth of the cell-facet-cell graph"""
+    n = 8
+    x = np.array([[i / n, j / n] for j in range(n + 1) for i in range(n + 1)])
+    cells = []
+    for j in range(n):
+        for i in range(n):
+            v = j * (n + 1) + i
+            cells += [[v, v + 1, v + n + 2], [v, v + n + 1, v + n + 2]]
+    cells = np.random.RandomState(0).permutation(np.array(cells, dtype=np.int64))
+
+    domain = ufl.Mesh(ufl.VectorElement("Lagrange", "triangle", 1))
+    bandwidth = []
+    for reorder in (False, True):
+        mesh = create_mesh(MPI.COMM_SELF, cells, x, domain, reorder=reorder)
+        assert assemble_scalar(1 * dx(mesh)) == pytest.approx(1.0, rel=1.0e-12)
+        mesh.topology.create_connectivity(1, 2)
+        f_to_c = mesh.topology.connectivity(1, 2)
+        bandwidth.append(max(abs(c[0] - c[1]) for c in (f_to_c.links(f) for f in range(f_to_c.num_nodes))
+                             if len(c) == 2))
+    assert bandwidth[1] < bandwidth[0]